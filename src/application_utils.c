@@ -28,6 +28,10 @@
 static volatile bool sw1_pushed_flag = false;
 static volatile bool sw2_pushed_flag = false;
 
+volatile bool hdmi_hpd_edge_flag = false;
+
+static volatile uint32_t system_tick_ms = 0;
+
 static int demo_system_current_volume = 20; /* Volume value in percent */
 static volatile bool demo_system_mute_status = false;
 
@@ -37,6 +41,46 @@ extern uint8_t       user_action_type;
 
 void led_pwm_duty_change(uint8_t duty_percent);
 
+void system_tick_initialize(void)
+{
+    /* Generate 1 millisecond interrupt by SysTick */
+    SysTick_Config(SystemCoreClock / 1000);
+}
+
+uint32_t system_tick_get(void)
+{
+    return system_tick_ms;
+}
+
+uint32_t system_time_us_get(void)
+{
+    uint32_t tick;
+    uint32_t count;
+    bool     is_pending;
+
+    /* Sub-millisecond part comes from SysTick down counter */
+    do
+    {
+        tick       = system_tick_ms;
+        count      = SysTick->VAL;
+        is_pending = ((SCB->ICSR & SCB_ICSR_PENDSTSET_Msk) != 0);
+    } while(tick != system_tick_ms);
+
+    /* Counter reloaded but the handler has not run yet, e.g. called from a higher priority interrupt */
+    if(is_pending)
+    {
+        tick++;
+        count = SysTick->VAL;
+    }
+
+    return (tick * 1000) + ((SysTick->LOAD - count) / (SystemCoreClock / 1000000));
+}
+
+void SysTick_Handler(void)
+{
+    system_tick_ms++;
+}
+
 void user_button_irq_initialize(void)
 {
     /* Open external irq driver for SW1 */
@@ -52,6 +96,24 @@ void user_button_irq_initialize(void)
     R_ICU_ExternalIrqEnable(&g_external_irq_sw2_ctrl);
 }
 
+void hdmi_hpd_irq_initialize(void)
+{
+    /* Open external irq driver for HPD. Both edges are detected. */
+    R_ICU_ExternalIrqOpen(&g_external_irq_hpd_ctrl, &g_external_irq_hpd_cfg);
+
+    /* Enable irq for HPD */
+    R_ICU_ExternalIrqEnable(&g_external_irq_hpd_ctrl);
+}
+
+bool hdmi_hpd_level_get(void)
+{
+    bsp_io_level_t level;
+
+    R_IOPORT_PinRead(&g_ioport_ctrl, HDMI_HPD_PIN, &level);
+
+    return (BSP_IO_LEVEL_HIGH == level);
+}
+
 void demo_system_initialize(void)
 {
     /* Turn on the power status LED */
@@ -105,31 +167,45 @@ void demo_system_volume_change(bool is_mute, bool is_volume_up)
     }
     else
     {
-        /* Clear mute status flag */
-        demo_system_mute_status = false;
-
         if(is_volume_up)
         {
             /* Volume up */
-            demo_system_current_volume += DEMO_SYSTEM_VOLUME_CHANGE_AMOUNT;
-            if(demo_system_current_volume >= 100)
-            {
-                demo_system_current_volume = 100;
-            }
+            demo_system_volume_adjust(DEMO_SYSTEM_VOLUME_CHANGE_AMOUNT);
         }
         else
         {
             /* Volume down */
-            demo_system_current_volume -= DEMO_SYSTEM_VOLUME_CHANGE_AMOUNT;
-            if(demo_system_current_volume <= 0)
-            {
-                demo_system_current_volume = 0;
-            }
+            demo_system_volume_adjust(-DEMO_SYSTEM_VOLUME_CHANGE_AMOUNT);
         }
+    }
+}
+
+void demo_system_volume_adjust(int amount)
+{
+    /* Clear mute status flag */
+    demo_system_mute_status = false;
 
-        /* Update PWM duty cycle */
-        led_pwm_duty_change((uint8_t) demo_system_current_volume);
+    demo_system_current_volume += amount;
+    if(demo_system_current_volume >= 100)
+    {
+        demo_system_current_volume = 100;
+    }
+    else if(demo_system_current_volume <= 0)
+    {
+        demo_system_current_volume = 0;
     }
+
+    /* Update PWM duty cycle */
+    led_pwm_duty_change((uint8_t) demo_system_current_volume);
+}
+
+void demo_system_volume_restore(uint8_t volume, bool is_mute)
+{
+    demo_system_current_volume = (volume > 100) ? 100 : volume;
+    demo_system_mute_status = is_mute;
+
+    /* Update PWM duty cycle */
+    led_pwm_duty_change(is_mute ? 0 : (uint8_t) demo_system_current_volume);
 }
 
 void demo_system_volume_status_get(bool * p_mute_status, uint8_t * p_volume_status)
@@ -222,6 +298,16 @@ void user_action_check(void)
                 user_action_detect_flag = true;
                 user_action_type = USER_ACTION_SYSTEM_AUDIO_MODE_REQUEST;
             }
+            else if(rtt_read_data_c == '5')
+            {
+                user_action_detect_flag = true;
+                user_action_type = USER_ACTION_DISPLAY_CEC_STATISTICS;
+            }
+            else if(rtt_read_data_c == '6')
+            {
+                user_action_detect_flag = true;
+                user_action_type = USER_ACTION_CLEAR_UNSUPPORTED_OPCODE_CACHE;
+            }
             else if(rtt_read_data_c == '0')
             {
                 /* Specify command type */
@@ -326,6 +412,12 @@ void irq_sw2_callback(external_irq_callback_args_t * p_args)
     sw2_pushed_flag = true;
 }
 
+void irq_hpd_callback(external_irq_callback_args_t * p_args)
+{
+    FSP_PARAMETER_NOT_USED(p_args);
+    hdmi_hpd_edge_flag = true;
+}
+
 void led_pwm_gpt_callback(timer_callback_args_t * p_args)
 {
     if(p_args->event == TIMER_EVENT_CAPTURE_A)
@@ -407,6 +499,136 @@ void cec_device_status_display(cec_addr_t cec_addr, cec_device_status_t * p_buff
     {
         APP_PRINT("No\r\n");
     }
+
+    APP_PRINT("|   Unsupported      :");
+    for(uint32_t i=0; i<256; i++)
+    {
+        if(p_buff->unsupported_opcode[i / 32] & (1UL << (i % 32)))
+        {
+            APP_PRINT(" 0x%02x", i);
+        }
+    }
+    APP_PRINT("\r\n");
+}
+
+void cec_tx_statistics_display(cec_tx_statistics_t const * p_stats)
+{
+    APP_PRINT("+ CEC transmission\r\n");
+    APP_PRINT("|   Messages         : %d\r\n", p_stats->message_count);
+    APP_PRINT("|   Delivered        : %d (%d after retry)\r\n", p_stats->success_count, p_stats->success_after_retry_count);
+    APP_PRINT("|   Failed           : %d\r\n", p_stats->error_count);
+    APP_PRINT("|   Timeout          : %d\r\n", p_stats->timeout_count);
+    APP_PRINT("|   Arbitration lost : %d\r\n", p_stats->arbitration_lost_count);
+    APP_PRINT("|   NACK             : %d\r\n", p_stats->nack_count);
+    APP_PRINT("|   TX error         : %d\r\n", p_stats->tx_error_count);
+    APP_PRINT("|   Unsupported skip : %d\r\n", p_stats->unsupported_skip_count);
+
+    APP_PRINT("|   Attempts         :");
+    for(uint32_t i=0; i<(CEC_TX_RETRANSMISSION_MAX + 1); i++)
+    {
+        APP_PRINT(" %d:%d", i + 1, p_stats->attempt_histogram[i]);
+    }
+    APP_PRINT("\r\n");
+}
+
+void hdmi_link_statistics_display(scdc_link_statistics_t const * p_stats)
+{
+    APP_PRINT("+ HDMI link (SCDC)\r\n");
+    if(!p_stats->is_declared)
+    {
+        APP_PRINT("|   Not declared by the sink EDID (HF-VSDB SCDC_Present)\r\n");
+        return;
+    }
+    if(!p_stats->is_present)
+    {
+        APP_PRINT("|   Not available (no response: %d)\r\n", p_stats->no_response_count);
+        return;
+    }
+    APP_PRINT("|   Sink version     : %d\r\n", p_stats->sink_version);
+    APP_PRINT("|   Clock / Lock     : %s / Ch0 %s, Ch1 %s, Ch2 %s%s\r\n",
+              (p_stats->status_flags_0 & SCDC_STATUS_FLAGS_0_CLOCK_DETECTED) ? "Detected" : "None",
+              (p_stats->status_flags_0 & (SCDC_STATUS_FLAGS_0_CH0_LOCKED << 0)) ? "OK" : "NG",
+              (p_stats->status_flags_0 & (SCDC_STATUS_FLAGS_0_CH0_LOCKED << 1)) ? "OK" : "NG",
+              (p_stats->status_flags_0 & (SCDC_STATUS_FLAGS_0_CH0_LOCKED << 2)) ? "OK" : "NG",
+              p_stats->is_scrambled ? " (Scrambled)" : "");
+    APP_PRINT("|   Polls            : %d (no response: %d)\r\n", p_stats->poll_count, p_stats->no_response_count);
+    APP_PRINT("|   Clock lost       : %d\r\n", p_stats->clock_lost_count);
+    APP_PRINT("|   Channel unlock   : %d\r\n", p_stats->channel_unlock_count);
+    APP_PRINT("|   Status update    : %d\r\n", p_stats->status_update_count);
+    APP_PRINT("|   Character errors : Ch0 %d, Ch1 %d, Ch2 %d (%d updates, %d checksum error)\r\n",
+              p_stats->character_error_count[0], p_stats->character_error_count[1], p_stats->character_error_count[2],
+              p_stats->ced_update_count, p_stats->ced_checksum_error_count);
+}
+
+void cec_rx_filter_statistics_display(cec_rx_filter_t const * p_filter)
+{
+    APP_PRINT("+ CEC ingress filter\r\n");
+    APP_PRINT("|   Self             : %s, dropped %d\r\n", p_filter->is_self_drop ? "Drop" : "Pass", p_filter->self_drop_count);
+    APP_PRINT("|   Source           : 0x%04x, dropped %d\r\n", p_filter->source_drop_bitmap, p_filter->source_drop_count);
+    APP_PRINT("|   Opcode           : dropped %d\r\n", p_filter->opcode_drop_count);
+    APP_PRINT("|   Retransmission   : dropped %d\r\n", p_filter->duplicate_drop_count);
+}
+
+void cec_line_timing_display(cec_timing_statistics_t const * p_stats)
+{
+    APP_PRINT("+ CEC line timing\r\n");
+    if(!p_stats->is_running)
+    {
+        APP_PRINT("|   Not running\r\n");
+        return;
+    }
+    APP_PRINT("|   Edges / Frames   : %d / %d (invalid pulse: %d)\r\n", p_stats->edge_count, p_stats->frame_count, p_stats->invalid_pulse_count);
+
+    for(uint32_t addr = 0; addr < 16; addr++)
+    {
+        bool is_sampled = false;
+        for(uint32_t item = 0; item < CEC_TIMING_ITEM_NUMBER; item++)
+        {
+            is_sampled |= (p_stats->histogram[addr][item].count > 0);
+        }
+        if(!is_sampled)
+        {
+            continue;
+        }
+
+        APP_PRINT("|   %s\r\n", &cec_logical_device_list[addr][0]);
+        for(uint32_t item = 0; item < CEC_TIMING_ITEM_NUMBER; item++)
+        {
+            cec_timing_histogram_t const   * p_histogram = &p_stats->histogram[addr][item];
+            cec_timing_item_define_t const * p_define = &cec_timing_item_list[item];
+            if(p_histogram->count == 0)
+            {
+                continue;
+            }
+
+            APP_PRINT("|     %-15s : %d samples, min %d / avg %d / max %d us, out of spec (%d-%d us): %d\r\n",
+                      p_define->name, p_histogram->count, p_histogram->min_us, p_histogram->sum_us / p_histogram->count,
+                      p_histogram->max_us, p_define->spec_min_us, p_define->spec_max_us, p_histogram->out_of_spec_count);
+
+            /* Bins with samples. The first and last bins include everything beyond. */
+            APP_PRINT("|                      ");
+            for(uint32_t bin = 0; bin < CEC_TIMING_HISTOGRAM_BINS; bin++)
+            {
+                if(p_histogram->bin[bin] == 0)
+                {
+                    continue;
+                }
+                if(bin == 0)
+                {
+                    APP_PRINT(" <%d:%d", p_define->bin_start_us, p_histogram->bin[bin]);
+                }
+                else if(bin == (CEC_TIMING_HISTOGRAM_BINS - 1))
+                {
+                    APP_PRINT(" >=%d:%d", p_define->bin_start_us + (bin - 1) * p_define->bin_width_us, p_histogram->bin[bin]);
+                }
+                else
+                {
+                    APP_PRINT(" %d:%d", p_define->bin_start_us + (bin - 1) * p_define->bin_width_us, p_histogram->bin[bin]);
+                }
+            }
+            APP_PRINT("\r\n");
+        }
+    }
 }
 
 void vendor_id_install(uint8_t * p_vendor_id_buff)
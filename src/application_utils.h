@@ -24,11 +24,14 @@
 #define __APPLICATION_UTILS_H__
 #include "hal_data.h"
 #include "hdmi_cec_utils.h"
+#include "hdmi_scdc_utils.h"
+#include "cec_timing_utils.h"
 
 #define DEVICE_KIT_NAME "RA6M5 MCU, EK-RA6M5 "
 #define POWER_STATUS_LED_PIN   BSP_IO_PORT_00_PIN_06 /* LED1 (Blue) */
 #define VOLUME_STATUS_LED_PIN  BSP_IO_PORT_00_PIN_07 /* LED2 (Green) */
 #define ERROR_INDICATE_LED_PIN BSP_IO_PORT_00_PIN_08 /* LED3 (Red) */
+#define HDMI_HPD_PIN           BSP_IO_PORT_01_PIN_05 /* IRQ0. Hot plug detect of HDMI connector */
 
 #define ERROR_INDICATE_LED_ON  R_IOPORT_PinWrite(&g_ioport_ctrl, ERROR_INDICATE_LED_PIN, BSP_IO_LEVEL_HIGH)
 #define ERROR_INDICATE_LED_OFF R_IOPORT_PinWrite(&g_ioport_ctrl, ERROR_INDICATE_LED_PIN, BSP_IO_LEVEL_LOW)
@@ -52,20 +55,15 @@
                                            " 1. Scan CEC bus\r\n"\
                                            " 2. Display internal CEC device status buffer data\r\n"\
                                            " 3. Enable/Disable System Audio Mode function support (Current status: %s)\r\n"\
-                                           " 4. Send System Audio Mode On/Off request (Current status: %s)\r\n"
+                                           " 4. Send System Audio Mode On/Off request (Current status: %s)\r\n"\
+                                           " 5. Display CEC and HDMI link statistics\r\n"\
+                                           " 6. Clear cached unsupported opcodes of CEC devices\r\n"
 
 #define SYS_AUDIO_FUNC_E "Enabled"
 #define SYS_AUDIO_FUNC_D "Disabled"
 #define SYS_AUDIO_ON     "On"
 #define SYS_AUDIO_OFF    "Off"
 
-#define CEC_LOGICAL_DEVICE_SELECT_MENU "\r\nSelect my CEC logical address\r\n"\
-                                           " 1. TV\r\n"\
-                                           " 2. Recording device\r\n"\
-                                           " 3. Tuner\r\n"\
-                                           " 4. Playback device\r\n"\
-                                           " 5. Audio system\r\n"
-
 #define CEC_CONTROL_DEVICE_SELECT_MENU "\r\nSelect CEC device logical address to be controlled:\r\n"\
                                            " 0. TV\r\n"\
                                            " 1. Recording Device 1\r\n"\
@@ -93,12 +91,17 @@
 #define USER_ACTION_DISPLAY_CEC_BUS_STATUS_BUFF        (2U)
 #define USER_ACTION_ENABLING_SYSTEM_AUDIO_MODE_SUPPORT (3U)
 #define USER_ACTION_SYSTEM_AUDIO_MODE_REQUEST          (4U)
+#define USER_ACTION_DISPLAY_CEC_STATISTICS             (5U)
+#define USER_ACTION_CLEAR_UNSUPPORTED_OPCODE_CACHE     (6U)
 #define USER_ACTION_REQUEST_POWER_ON                   ('a')
 #define USER_ACTION_REQUEST_POWER_OFF                  ('b')
 #define USER_ACTION_REQUEST_VOLUME_UP                  ('c')
 #define USER_ACTION_REQUEST_VOLUME_DONW                ('d')
 #define USER_ACTION_REQUEST_VOLUME_MUTE                ('e')
 
+/* True when the system tick has reached the deadline. Safe across tick counter wrap-around. */
+#define SYSTEM_TICK_IS_REACHED(deadline) ((int32_t)(system_tick_get() - (uint32_t)(deadline)) >= 0)
+
 #define CEC_ACTION_NONE        (0U)
 #define CEC_ACTION_POWER_ON    (1U)
 #define CEC_ACTION_POWER_OFF   (2U)
@@ -106,23 +109,46 @@
 #define CEC_ACTION_VOLUME_DOWN (4U)
 #define CEC_ACTION_VOLUME_MUTE (5U)
 
+/* Time to live of device status learned from CEC bus, in milliseconds */
+#define CEC_DEVICE_STATUS_TTL_PHYSICAL_ADDRESS_MS (10U * 60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_VENDOR_ID_MS        (60U * 60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_VERSION_MS          (60U * 60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_POWER_STATUS_MS     (60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_ACTIVE_SOURCE_MS    (60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_ABSENT_MS           (60U * 1000U)
+#define CEC_DEVICE_STATUS_TTL_UNSUPPORTED_MS      (30U * 60U * 1000U)
+
+/* True when the status was learned and it is younger than the time to live */
+#define CEC_DEVICE_STATUS_IS_FRESH(is_store, tick, ttl_ms) ((is_store) && ((system_tick_get() - (tick)) < (ttl_ms)))
+
 typedef struct cec_device_status
 {
     bool          is_device_active;
     bool          is_my_device;
     bool          is_active_source;
+    uint32_t      active_source_tick;
+
+    bool          is_absent; ///< Directed message to the device was not acknowledged
+    uint32_t      absent_tick;
 
     bool          is_power_status_store;
     uint8_t       power_status; // 0: Standby, 1: On
+    uint32_t      power_status_tick;
 
     bool          is_physical_address_store;
     uint8_t       physical_address[4];
+    uint32_t      physical_address_tick;
 
     bool          is_vendor_id_store;
     uint8_t       vendor_id[3];
+    uint32_t      vendor_id_tick;
 
     bool          is_version_store;
     cec_version_t cec_version;
+    uint32_t      version_tick;
+
+    uint32_t      unsupported_opcode[8];  ///< Bitmap of opcodes the device answered with Feature Abort
+    uint32_t      unsupported_opcode_tick; ///< Tick of the first opcode cached. All are aged out together
 }cec_device_status_t;
 
 typedef struct cec_rx_message_buff
@@ -135,21 +161,147 @@ typedef struct cec_rx_message_buff
     uint8_t    opcode;
     uint8_t    data_buff[CEC_DATA_BUFFER_LENGTH];
     uint8_t    byte_counter; ///< Byte counter including header code
+    uint32_t   start_time_us; ///< Start bit time estimated at the header block reception
 } cec_rx_message_buff_t;
 
+typedef enum e_cec_tx_state
+{
+    CEC_TX_STATE_IDLE       = 0, ///< No transmission in progress
+    CEC_TX_STATE_BUSY       = 1, ///< Waiting for completion of an attempt
+    CEC_TX_STATE_RETRY_WAIT = 2, ///< Waiting for the signal free time before a retry
+} cec_tx_state_t;
+
+typedef enum e_cec_system_audio_state
+{
+    CEC_SYSTEM_AUDIO_STATE_IDLE        = 0, ///< System Audio Mode is off
+    CEC_SYSTEM_AUDIO_STATE_RESETTING   = 1, ///< Requesting. Off is sent first and the TV is given time to settle
+    CEC_SYSTEM_AUDIO_STATE_REQUESTING  = 2, ///< Requesting. Waiting for the delivery of On
+    CEC_SYSTEM_AUDIO_STATE_ON          = 3, ///< System Audio Mode is on
+    CEC_SYSTEM_AUDIO_STATE_TERMINATING = 4, ///< Waiting for the delivery of Off
+} cec_system_audio_state_t;
+
+typedef enum e_cec_arc_state
+{
+    CEC_ARC_STATE_IDLE        = 0, ///< ARC is not used
+    CEC_ARC_STATE_INITIATING  = 1, ///< Initiate ARC sent. Waiting for Report ARC Initiated (or Terminated if TV refuses)
+    CEC_ARC_STATE_ON          = 2, ///< Audio is received from TV over ARC
+    CEC_ARC_STATE_TERMINATING = 3, ///< Terminate ARC sent. Waiting for Report ARC Terminated
+} cec_arc_state_t;
+
+typedef struct cec_tx_request
+{
+    cec_addr_t    source;         ///< One of my logical addresses
+    cec_message_t message;
+    uint8_t       message_length; ///< Total message size, including header, opcode, and data
+    uint8_t       attempt_count;
+    uint8_t       retry_count;
+    uint8_t       arbitration_retry_count;
+    fsp_err_t   * p_result;       ///< Written on completion. NULL if the caller does not wait for the result
+} cec_tx_request_t;
+
+typedef struct cec_key_event
+{
+    cec_addr_t destination;
+    uint8_t    ui_command; ///< [UI Command] operand of User Control Pressed
+    uint32_t   hold_ms;    ///< Time the key is held. 0: Held until cec_key_release() is called
+} cec_key_event_t;
+
+typedef struct cec_key_hold_status
+{
+    bool     is_pressed;
+    uint8_t  ui_command;        ///< [UI Command] operand of the key held
+    uint32_t last_pressed_tick; ///< Tick of the last User Control Pressed including repeats
+    uint32_t repeat_count;      ///< Number of repeated User Control Pressed absorbed
+    uint32_t ramp_tick;         ///< Tick of the next volume ramp step
+} cec_key_hold_status_t;
+
+typedef enum e_cec_reply_state
+{
+    CEC_REPLY_STATE_PENDING       = 0, ///< Waiting for transmission or the reply
+    CEC_REPLY_STATE_REPLIED       = 1, ///< Expected reply received
+    CEC_REPLY_STATE_REJECTED      = 2, ///< Feature Abort for the request received
+    CEC_REPLY_STATE_TIMEOUT       = 3, ///< No reply in the response time
+    CEC_REPLY_STATE_NOT_DELIVERED = 4, ///< Transmission of the request failed
+} cec_reply_state_t;
+
+typedef struct cec_reply_request
+{
+    bool                is_used;
+    bool                is_sent;        ///< Request was transmitted and the reply deadline runs
+    cec_addr_t          destination;    ///< Expected reply source. CEC_ADDR_BROADCAST accepts any source
+    uint8_t             request_opcode;
+    uint8_t             reply_opcode;
+    uint32_t            deadline;
+    fsp_err_t           tx_result;
+    cec_reply_state_t * p_state;        ///< Written on resolution. NULL after resolved
+} cec_reply_request_t;
+
+typedef struct cec_tx_statistics
+{
+    uint32_t message_count;
+    uint32_t success_count;
+    uint32_t success_after_retry_count;
+    uint32_t error_count;
+    uint32_t timeout_count;
+
+    uint32_t arbitration_lost_count;
+    uint32_t nack_count;
+    uint32_t tx_error_count;
+    uint32_t unsupported_skip_count; ///< Requests not sent since the device is known to abort them
+
+    uint32_t attempt_histogram[CEC_TX_RETRANSMISSION_MAX + 1]; ///< Delivered messages by number of attempts
+} cec_tx_statistics_t;
+
+/* Ingress filter evaluated in the CEC interrupt. Dropped frames are only counted. */
+typedef struct cec_rx_filter
+{
+    bool     is_self_drop;           ///< Drop frames from my logical address
+    uint16_t source_drop_bitmap;     ///< Bit n: drop frames from logical address n
+    uint32_t opcode_drop_bitmap[8];  ///< Bit n: drop frames of opcode n. Directed ones are not answered, even with Feature Abort.
+
+    uint32_t self_drop_count;
+    uint32_t source_drop_count;
+    uint32_t opcode_drop_count;
+    uint32_t duplicate_drop_count;   ///< Retransmissions of a frame already received
+} cec_rx_filter_t;
+
+/* Recently received frame to detect retransmissions */
+typedef struct cec_rx_duplicate_entry
+{
+    bool     is_valid;
+    uint8_t  header;       ///< Source and destination
+    uint8_t  opcode;
+    uint8_t  byte_counter;
+    uint32_t operand_hash;
+    uint32_t end_time_us;  ///< End of the last reception of this frame
+} cec_rx_duplicate_entry_t;
+
+extern volatile bool hdmi_hpd_edge_flag;
 extern volatile bool system_audio_mode_support_function;
 extern volatile bool system_audio_mode_status;
 
+void system_tick_initialize(void);
+uint32_t system_tick_get(void);
+uint32_t system_time_us_get(void);
+
 void user_button_irq_initialize(void);
+void hdmi_hpd_irq_initialize(void);
+bool hdmi_hpd_level_get(void);
 void demo_system_initialize(void);
 void demo_system_power_on(void);
 void demo_system_power_off(void);
 void demo_system_volume_change(bool is_mute, bool is_volume_up);
+void demo_system_volume_adjust(int amount);
+void demo_system_volume_restore(uint8_t volume, bool is_mute);
 void demo_system_volume_status_get(bool *mute_status, uint8_t *volume_status);
 
 void user_action_check(void);
 
 void cec_device_status_display(cec_addr_t cec_addr, cec_device_status_t * p_buff);
+void cec_tx_statistics_display(cec_tx_statistics_t const * p_stats);
+void hdmi_link_statistics_display(scdc_link_statistics_t const * p_stats);
+void cec_line_timing_display(cec_timing_statistics_t const * p_stats);
+void cec_rx_filter_statistics_display(cec_rx_filter_t const * p_filter);
 
 void vendor_id_install(uint8_t * my_vendor_id_buff);
 
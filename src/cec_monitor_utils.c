@@ -0,0 +1,170 @@
+/***********************************************************************************************************************
+ * File Name    : cec_monitor_utils.c
+ * Description  : Contains data structures and functions used in cec_monitor_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include "cec_monitor_utils.h"
+#include "application_utils.h"
+#include "SEGGER_RTT/SEGGER_RTT.h"
+
+///############# Application Option Setting #############
+#define CEC_MONITOR_RING_SIZE        (128)  // Records kept in RAM until RTT takes them. Must be power of 2
+#define CEC_MONITOR_RTT_BUFFER_SIZE  (1024) // RTT up buffer for the monitor stream
+///########## End of Application Option Setting #########
+
+extern bool cec_logical_address_is_mine(cec_addr_t logical_addr);
+
+/* Written by interrupt, read by main loop */
+static cec_monitor_record_t ring[CEC_MONITOR_RING_SIZE];
+static volatile uint32_t    ring_write_point = 0;
+static volatile uint32_t    ring_read_point = 0;
+static volatile uint32_t    ring_lost_count = 0;
+static uint16_t             record_sequence = 0;
+
+static cec_monitor_record_t rx_record;  /* Frame being received */
+static cec_monitor_record_t tx_record;  /* Frame being sent */
+static volatile bool        is_tx_active = false;
+
+static uint8_t rtt_buffer[CEC_MONITOR_RTT_BUFFER_SIZE];
+
+static void cec_monitor_record_push(cec_monitor_record_t * p_record)
+{
+    uint32_t write_point = ring_write_point;
+
+    p_record->sync     = CEC_MONITOR_RECORD_SYNC;
+    p_record->sequence = record_sequence++;
+
+    if((write_point - ring_read_point) >= CEC_MONITOR_RING_SIZE)
+    {
+        /* Host is not reading. Sequence gap tells the loss. */
+        ring_lost_count++;
+        return;
+    }
+
+    ring[write_point % CEC_MONITOR_RING_SIZE] = *p_record;
+    ring_write_point = write_point + 1;
+}
+
+void cec_monitor_initialize(void)
+{
+    SEGGER_RTT_ConfigUpBuffer(CEC_MONITOR_RTT_INDEX, "CECMonitor", &rtt_buffer[0], sizeof(rtt_buffer), SEGGER_RTT_MODE_NO_BLOCK_SKIP);
+
+    /* Generate reception interrupts for frames directed to other devices too. They are not acknowledged by us. */
+    R_CEC->CECCTL1_b.CINTMK = 1;
+}
+
+void cec_monitor_process(void)
+{
+    /* Whole records only, so that the host never sees a partial one */
+    while(ring_read_point != ring_write_point)
+    {
+        if(SEGGER_RTT_GetAvailWriteSpace(CEC_MONITOR_RTT_INDEX) < sizeof(cec_monitor_record_t))
+        {
+            break;
+        }
+
+        SEGGER_RTT_Write(CEC_MONITOR_RTT_INDEX, &ring[ring_read_point % CEC_MONITOR_RING_SIZE], sizeof(cec_monitor_record_t));
+        ring_read_point++;
+    }
+}
+
+uint32_t cec_monitor_lost_count_get(void)
+{
+    return ring_lost_count;
+}
+
+void cec_monitor_rx_byte(uint8_t data)
+{
+    if(rx_record.length == 0)
+    {
+        rx_record.timestamp_us = system_time_us_get();
+    }
+
+    if(rx_record.length < CEC_DATA_BUFFER_LENGTH)
+    {
+        rx_record.data[rx_record.length++] = data;
+    }
+}
+
+void cec_monitor_rx_end(cec_error_t errors)
+{
+    cec_addr_t destination;
+
+    if(rx_record.length == 0)
+    {
+        return;
+    }
+
+    /* Frames of our addresses and broadcast are acknowledged by the peripheral */
+    destination = (cec_addr_t)(rx_record.data[0] & 0x0F);
+    if(cec_logical_address_is_mine(destination) || (destination == CEC_ADDR_BROADCAST))
+    {
+        rx_record.flags |= CEC_MONITOR_FLAG_FOR_ME;
+        if((errors == 0) && (destination != CEC_ADDR_BROADCAST))
+        {
+            rx_record.flags |= CEC_MONITOR_FLAG_ACK;
+        }
+    }
+    if(errors != 0)
+    {
+        rx_record.flags |= CEC_MONITOR_FLAG_ERROR;
+        rx_record.errors = (uint8_t)errors;
+    }
+
+    cec_monitor_record_push(&rx_record);
+    memset(&rx_record, 0, sizeof(rx_record));
+}
+
+void cec_monitor_tx_start(cec_addr_t source, cec_message_t const * p_message, uint8_t length)
+{
+    memset(&tx_record, 0, sizeof(tx_record));
+    tx_record.flags        = CEC_MONITOR_FLAG_TX;
+    tx_record.length       = (length > CEC_DATA_BUFFER_LENGTH) ? CEC_DATA_BUFFER_LENGTH : length;
+    tx_record.timestamp_us = system_time_us_get();
+    tx_record.data[0]      = (uint8_t)((source << 4) | (p_message->destination & 0x0F));
+    tx_record.data[1]      = p_message->opcode;
+    memcpy(&tx_record.data[2], &p_message->data[0], (tx_record.length > 2) ? (tx_record.length - 2U) : 0U);
+    is_tx_active = true;
+}
+
+void cec_monitor_tx_end(cec_error_t errors)
+{
+    if(!is_tx_active)
+    {
+        return;
+    }
+    is_tx_active = false;
+
+    if(errors & CEC_ERROR_ACKERR)
+    {
+        tx_record.flags |= CEC_MONITOR_FLAG_NACK;
+    }
+    else if(errors == 0)
+    {
+        tx_record.flags |= CEC_MONITOR_FLAG_ACK;
+    }
+    if(errors != 0)
+    {
+        tx_record.flags |= CEC_MONITOR_FLAG_ERROR;
+        tx_record.errors = (uint8_t)errors;
+    }
+
+    cec_monitor_record_push(&tx_record);
+}
@@ -0,0 +1,61 @@
+/***********************************************************************************************************************
+ * File Name    : cec_monitor_utils.h
+ * Description  : Contains data structures and functions used in cec_monitor_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef __CEC_MONITOR_UTILS_H__
+#define __CEC_MONITOR_UTILS_H__
+#include "hal_data.h"
+
+#define CEC_MONITOR_RTT_INDEX       (1)      /* RTT up buffer dedicated to the monitor stream */
+#define CEC_MONITOR_RECORD_SYNC     (0xC3EC) /* First 2 bytes of every record (little endian) */
+
+#define CEC_MONITOR_FLAG_TX         (0x01)   /* Sent by this device */
+#define CEC_MONITOR_FLAG_ACK        (0x02)   /* Acknowledged. Set for frames accepted by this device and sent frames without NACK */
+#define CEC_MONITOR_FLAG_NACK       (0x04)   /* Not acknowledged. Known for sent frames only */
+#define CEC_MONITOR_FLAG_ERROR      (0x08)   /* Frame ended with errors */
+#define CEC_MONITOR_FLAG_FOR_ME     (0x10)   /* Directed to this device or broadcast */
+
+/* Record streamed to the host. Binary, 28 bytes each. */
+typedef struct cec_monitor_record
+{
+    uint16_t sync;                          ///< CEC_MONITOR_RECORD_SYNC
+    uint8_t  flags;                         ///< CEC_MONITOR_FLAG_xxx
+    uint8_t  length;                        ///< Frame bytes including header block
+    uint32_t timestamp_us;                  ///< Start of the header block
+    uint16_t sequence;                      ///< Incremented every record. A gap means records were lost
+    uint8_t  errors;                        ///< cec_error_t of the frame
+    uint8_t  reserved;
+    uint8_t  data[CEC_DATA_BUFFER_LENGTH];  ///< Header block, opcode and operands
+} cec_monitor_record_t;
+
+void cec_monitor_initialize(void);
+void cec_monitor_process(void);
+uint32_t cec_monitor_lost_count_get(void);
+
+/* Called from the CEC interrupt callback */
+void cec_monitor_rx_byte(uint8_t data);
+void cec_monitor_rx_end(cec_error_t errors);
+void cec_monitor_tx_end(cec_error_t errors);
+
+/* Called when a transmission is started */
+void cec_monitor_tx_start(cec_addr_t source, cec_message_t const * p_message, uint8_t length);
+
+#endif /* End of __CEC_MONITOR_UTILS_H__ */
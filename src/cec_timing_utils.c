@@ -0,0 +1,302 @@
+/***********************************************************************************************************************
+ * File Name    : cec_timing_utils.c
+ * Description  : Contains data structures and functions used in cec_timing_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include "cec_timing_utils.h"
+#include "application_utils.h"
+
+///############# Application Option Setting #############
+#define CEC_TIMING_CAPTURE_PIN       BSP_IO_PORT_04_PIN_03  // GTIOC3A of g_cec_timing_gpt_timer. Connect to the CEC line (CECIO, P206) with a jumper wire
+#define CEC_TIMING_CAPTURE_PSEL      IOPORT_PERIPHERAL_GPT1 // Peripheral function of CEC_TIMING_CAPTURE_PIN
+///########## End of Application Option Setting #########
+
+#define CEC_TIMING_FRAME_GAP_US      (5000) /* Falling edges farther than this are in different frames */
+#define CEC_TIMING_START_LOW_MIN_US  (3000) /* Low time of start bit. Anything between data bit and this is invalid. */
+#define CEC_TIMING_START_LOW_MAX_US  (4400)
+#define CEC_TIMING_DATA_LOW_MIN_US   (200)  /* Shorter low is a glitch */
+#define CEC_TIMING_SAMPLE_POINT_US   (1050) /* Nominal sample point. Longer low is logical 0. */
+#define CEC_TIMING_EOM_BIT_INDEX     (8)
+#define CEC_TIMING_ACK_BIT_INDEX     (9)
+#define CEC_TIMING_PENDING_MAX       (10)   /* Samples taken before the initiator is decoded from the header block */
+#define CEC_TIMING_ADDR_UNKNOWN      (0xFF)
+
+cec_timing_item_define_t const cec_timing_item_list[CEC_TIMING_ITEM_NUMBER] =
+{
+    /* name             spec_min  spec_max  bin_start  bin_width */
+    {"Start bit low",   3500,     3900,     3350,      50},
+    {"Start bit total", 4300,     4700,     4150,      50},
+    {"Logical 0 low",   1300,     1700,     1150,      50},
+    {"Logical 1 low",   400,      800,      250,       50},
+    {"Data bit total",  2050,     2750,     1700,      100},
+    {"ACK low",         1300,     1700,     1150,      50},
+};
+
+static cec_timing_statistics_t cec_timing_statistics;
+
+/* Edge decoder. Runs in the capture interrupt. */
+static uint32_t          clock_per_us = 1;
+static uint32_t          period_counts = 0;
+static uint32_t          last_fall_count = 0;
+static bool              is_fall_valid = false;
+static bool              is_in_frame = false;
+static cec_timing_item_t period_item = CEC_TIMING_ITEM_START_PERIOD; /* Item of the falling edge to falling edge time */
+static uint8_t           block_index = 0;
+static uint8_t           bit_index = 0;
+static uint8_t           header_block = 0;
+static bool              is_eom = false;
+static uint8_t           initiator = CEC_TIMING_ADDR_UNKNOWN;
+static uint8_t           follower = CEC_TIMING_ADDR_UNKNOWN;
+
+static cec_timing_item_t pending_item[CEC_TIMING_PENDING_MAX];
+static uint16_t          pending_us[CEC_TIMING_PENDING_MAX];
+static uint8_t           pending_count = 0;
+
+static uint32_t cec_timing_elapsed_us(uint32_t from, uint32_t to)
+{
+    uint32_t counts = (to >= from) ? (to - from) : (to + period_counts - from);
+    return counts / clock_per_us;
+}
+
+static void cec_timing_histogram_add(cec_timing_histogram_t * p_histogram, cec_timing_item_define_t const * p_define, uint32_t time_us)
+{
+    uint32_t bin = 0;
+    uint16_t us = (time_us > 0xFFFF) ? 0xFFFF : (uint16_t)time_us;
+
+    if(us >= p_define->bin_start_us)
+    {
+        bin = 1 + (uint32_t)(us - p_define->bin_start_us) / p_define->bin_width_us;
+        if(bin >= CEC_TIMING_HISTOGRAM_BINS)
+        {
+            bin = CEC_TIMING_HISTOGRAM_BINS - 1;
+        }
+    }
+    if(p_histogram->bin[bin] < 0xFFFF)
+    {
+        p_histogram->bin[bin]++;
+    }
+
+    if((p_histogram->count == 0) || (us < p_histogram->min_us))
+    {
+        p_histogram->min_us = us;
+    }
+    if(us > p_histogram->max_us)
+    {
+        p_histogram->max_us = us;
+    }
+    p_histogram->count++;
+    p_histogram->sum_us += us;
+
+    if((us < p_define->spec_min_us) || (us > p_define->spec_max_us))
+    {
+        p_histogram->out_of_spec_count++;
+    }
+}
+
+static void cec_timing_sample_add(cec_timing_item_t item, uint32_t time_us)
+{
+    /* ACK is driven by the follower, the others by the initiator */
+    uint8_t driver = (CEC_TIMING_ITEM_ACK_LOW == item) ? follower : initiator;
+
+    if(CEC_TIMING_ADDR_UNKNOWN == driver)
+    {
+        /* Keep until the initiator bits are received */
+        if(pending_count < CEC_TIMING_PENDING_MAX)
+        {
+            pending_item[pending_count] = item;
+            pending_us[pending_count] = (time_us > 0xFFFF) ? 0xFFFF : (uint16_t)time_us;
+            pending_count++;
+        }
+        return;
+    }
+
+    cec_timing_histogram_add(&cec_timing_statistics.histogram[driver][item], &cec_timing_item_list[item], time_us);
+}
+
+static void cec_timing_low_decode(uint32_t low_us)
+{
+    bool is_zero = (low_us > CEC_TIMING_SAMPLE_POINT_US);
+
+    if(CEC_TIMING_ACK_BIT_INDEX == bit_index)
+    {
+        /* The initiator sends logical 1 and the follower of a directed message extends it to logical 0 */
+        if(is_zero && (follower != CEC_ADDR_BROADCAST))
+        {
+            cec_timing_sample_add(CEC_TIMING_ITEM_ACK_LOW, low_us);
+        }
+        else if(!is_zero)
+        {
+            cec_timing_sample_add(CEC_TIMING_ITEM_ONE_LOW, low_us);
+        }
+
+        if(is_eom)
+        {
+            /* End of frame. The time to the next start bit is not a bit period. */
+            is_in_frame = false;
+        }
+        block_index++;
+        bit_index = 0;
+        return;
+    }
+
+    cec_timing_sample_add(is_zero ? CEC_TIMING_ITEM_ZERO_LOW : CEC_TIMING_ITEM_ONE_LOW, low_us);
+
+    if(0 == block_index)
+    {
+        header_block = (uint8_t)((header_block << 1) | (is_zero ? 0 : 1));
+        if(3 == bit_index)
+        {
+            initiator = header_block & 0x0F;
+
+            /* Samples of the start bit and initiator bits belong to this address */
+            for(uint8_t i = 0; i < pending_count; i++)
+            {
+                cec_timing_sample_add(pending_item[i], pending_us[i]);
+            }
+            pending_count = 0;
+        }
+        else if(7 == bit_index)
+        {
+            follower = header_block & 0x0F;
+        }
+    }
+    if(CEC_TIMING_EOM_BIT_INDEX == bit_index)
+    {
+        is_eom = !is_zero;
+    }
+    bit_index++;
+}
+
+void cec_timing_capture_callback(timer_callback_args_t * p_args)
+{
+    bsp_io_level_t level = BSP_IO_LEVEL_HIGH;
+    uint32_t elapsed_us;
+
+    if(p_args->event != TIMER_EVENT_CAPTURE_A)
+    {
+        return;
+    }
+    cec_timing_statistics.edge_count++;
+
+    /* Both edges are captured. The shortest CEC level lasts 400 us, so the pin tells which edge it was. */
+    R_IOPORT_PinRead(&g_ioport_ctrl, CEC_TIMING_CAPTURE_PIN, &level);
+
+    if(BSP_IO_LEVEL_LOW == level)
+    {
+        /* Falling edge ends the previous bit */
+        if(is_in_frame)
+        {
+            elapsed_us = cec_timing_elapsed_us(last_fall_count, p_args->capture);
+            if(elapsed_us > CEC_TIMING_FRAME_GAP_US)
+            {
+                /* Edges were missed */
+                is_in_frame = false;
+            }
+            else
+            {
+                cec_timing_sample_add(period_item, elapsed_us);
+            }
+        }
+        last_fall_count = p_args->capture;
+        is_fall_valid = true;
+        return;
+    }
+
+    /* Rising edge ends the low time */
+    if(!is_fall_valid)
+    {
+        return;
+    }
+    elapsed_us = cec_timing_elapsed_us(last_fall_count, p_args->capture);
+
+    if((elapsed_us >= CEC_TIMING_START_LOW_MIN_US) && (elapsed_us <= CEC_TIMING_START_LOW_MAX_US))
+    {
+        /* Start bit of a new frame */
+        is_in_frame = true;
+        block_index = 0;
+        bit_index = 0;
+        header_block = 0;
+        is_eom = false;
+        initiator = CEC_TIMING_ADDR_UNKNOWN;
+        follower = CEC_TIMING_ADDR_UNKNOWN;
+        pending_count = 0;
+        cec_timing_statistics.frame_count++;
+
+        cec_timing_sample_add(CEC_TIMING_ITEM_START_LOW, elapsed_us);
+        period_item = CEC_TIMING_ITEM_START_PERIOD;
+    }
+    else if(is_in_frame && (elapsed_us >= CEC_TIMING_DATA_LOW_MIN_US) && (elapsed_us < CEC_TIMING_START_LOW_MIN_US))
+    {
+        cec_timing_low_decode(elapsed_us);
+        period_item = CEC_TIMING_ITEM_BIT_PERIOD;
+    }
+    else
+    {
+        /* Glitch, or low time out of any bit. Wait for the next start bit. */
+        cec_timing_statistics.invalid_pulse_count++;
+        is_in_frame = false;
+    }
+}
+
+fsp_err_t cec_timing_analyzer_start(void)
+{
+    fsp_err_t    fsp_err;
+    timer_info_t timer_info;
+
+    fsp_err = R_IOPORT_PinCfg(&g_ioport_ctrl, CEC_TIMING_CAPTURE_PIN, ((uint32_t) IOPORT_CFG_PERIPHERAL_PIN | (uint32_t) CEC_TIMING_CAPTURE_PSEL));
+    if(FSP_SUCCESS != fsp_err)
+    {
+        return fsp_err;
+    }
+
+    /* Free running counter. Both edges of GTIOCA are captured. */
+    fsp_err = R_GPT_Open(&g_cec_timing_gpt_timer_ctrl, &g_cec_timing_gpt_timer_cfg);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        return fsp_err;
+    }
+
+    R_GPT_InfoGet(&g_cec_timing_gpt_timer_ctrl, &timer_info);
+    period_counts = timer_info.period_counts;
+    clock_per_us = timer_info.clock_frequency / 1000000;
+    if(clock_per_us == 0)
+    {
+        /* Counter clock must be 1 MHz or faster */
+        R_GPT_Close(&g_cec_timing_gpt_timer_ctrl);
+        return FSP_ERR_INVALID_HW_CONDITION;
+    }
+
+    fsp_err = R_GPT_Start(&g_cec_timing_gpt_timer_ctrl);
+    cec_timing_statistics.is_running = (FSP_SUCCESS == fsp_err);
+    return fsp_err;
+}
+
+void cec_timing_statistics_clear(void)
+{
+    bool is_running = cec_timing_statistics.is_running;
+
+    memset(&cec_timing_statistics, 0, sizeof(cec_timing_statistics));
+    cec_timing_statistics.is_running = is_running;
+}
+
+cec_timing_statistics_t const * cec_timing_statistics_get(void)
+{
+    return &cec_timing_statistics;
+}
@@ -0,0 +1,76 @@
+/***********************************************************************************************************************
+ * File Name    : cec_timing_utils.h
+ * Description  : Contains data structures and functions used in cec_timing_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef __CEC_TIMING_UTILS_H__
+#define __CEC_TIMING_UTILS_H__
+#include "hal_data.h"
+
+#define CEC_TIMING_HISTOGRAM_BINS   (16) /* First and last bins also hold the samples out of range */
+
+/* Measured item. The sender of a frame drives all of them except the ACK, which is driven by the follower. */
+typedef enum cec_timing_item
+{
+    CEC_TIMING_ITEM_START_LOW,    ///< Start bit low time (3.7 ms)
+    CEC_TIMING_ITEM_START_PERIOD, ///< Start bit total time (4.5 ms)
+    CEC_TIMING_ITEM_ZERO_LOW,     ///< Logical 0 low time (1.5 ms)
+    CEC_TIMING_ITEM_ONE_LOW,      ///< Logical 1 low time (0.6 ms)
+    CEC_TIMING_ITEM_BIT_PERIOD,   ///< Data bit total time (2.4 ms)
+    CEC_TIMING_ITEM_ACK_LOW,      ///< Low time of the ACK bit asserted by the follower (1.5 ms)
+    CEC_TIMING_ITEM_NUMBER
+}cec_timing_item_t;
+
+/* Spec range and histogram layout of a measured item */
+typedef struct cec_timing_item_define
+{
+    char const * name;
+    uint16_t     spec_min_us;
+    uint16_t     spec_max_us;
+    uint16_t     bin_start_us; ///< Lower end of the 2nd bin. The 1st bin holds samples below this.
+    uint16_t     bin_width_us;
+}cec_timing_item_define_t;
+
+typedef struct cec_timing_histogram
+{
+    uint16_t bin[CEC_TIMING_HISTOGRAM_BINS];
+    uint32_t count;
+    uint32_t sum_us;
+    uint16_t min_us;
+    uint16_t max_us;
+    uint32_t out_of_spec_count;
+}cec_timing_histogram_t;
+
+typedef struct cec_timing_statistics
+{
+    bool                   is_running;
+    uint32_t               edge_count;
+    uint32_t               frame_count;
+    uint32_t               invalid_pulse_count;  ///< Low time which fits neither start bit nor data bit
+    cec_timing_histogram_t histogram[16][CEC_TIMING_ITEM_NUMBER]; ///< Indexed by logical address of the driver
+}cec_timing_statistics_t;
+
+extern cec_timing_item_define_t const cec_timing_item_list[CEC_TIMING_ITEM_NUMBER];
+
+fsp_err_t cec_timing_analyzer_start(void);
+void      cec_timing_statistics_clear(void);
+cec_timing_statistics_t const * cec_timing_statistics_get(void);
+
+#endif /* End of __CEC_TIMING_UTILS_H__ */
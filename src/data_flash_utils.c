@@ -0,0 +1,233 @@
+/***********************************************************************************************************************
+ * File Name    : data_flash_utils.c
+ * Description  : Contains data structures and functions used in data_flash_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include "data_flash_utils.h"
+#include "application_utils.h"
+#include "rtt_common_utils.h"
+
+///############# Application Option Setting #############
+#define DEVICE_STATE_WRITE_DELAY_MS  (3000) // State is written when it has not changed for this time
+///########## End of Application Option Setting #########
+
+#define DATA_FLASH_START_ADDRESS     (BSP_FEATURE_FLASH_DATA_FLASH_START)
+#define DATA_FLASH_SIZE              (BSP_DATA_FLASH_SIZE_BYTES)
+#define DATA_FLASH_BLOCK_SIZE        (FLASH_HP_DF_BLOCK_SIZE)
+#define DEVICE_STATE_SLOT_NUMBER     (DATA_FLASH_SIZE / DEVICE_STATE_RECORD_SIZE)
+
+static bool           device_state_storage_open = false;
+static device_state_t device_state_stored;        /* State in the latest record */
+static device_state_t device_state_pending;       /* State waiting to be written */
+static bool           device_state_is_pending = false;
+static uint32_t       device_state_write_tick;
+static uint32_t       device_state_sequence = 0;
+static uint32_t       device_state_next_slot = 0;
+
+static uint32_t device_state_crc_calculate(uint8_t const * p_data, uint32_t length);
+static bool device_state_record_check(device_state_record_t const * p_record);
+static bool device_state_is_equal(device_state_t const * p_a, device_state_t const * p_b);
+static fsp_err_t device_state_record_write(device_state_t const * p_state);
+
+static uint32_t device_state_crc_calculate(uint8_t const * p_data, uint32_t length)
+{
+    uint32_t crc = 0xFFFFFFFF;
+
+    /* CRC-32 (IEEE 802.3), reflected */
+    for(uint32_t i=0; i<length; i++)
+    {
+        crc ^= p_data[i];
+        for(int bit=0; bit<8; bit++)
+        {
+            crc = (crc >> 1) ^ (0xEDB88320 & (0U - (crc & 1U)));
+        }
+    }
+
+    return ~crc;
+}
+
+static bool device_state_record_check(device_state_record_t const * p_record)
+{
+    /* Erased data flash reads undefined values, so the CRC also rejects blank slots */
+    if((p_record->magic != DEVICE_STATE_RECORD_MAGIC) || (p_record->version != DEVICE_STATE_RECORD_VERSION))
+    {
+        return false;
+    }
+
+    return p_record->crc == device_state_crc_calculate((uint8_t const *)p_record, offsetof(device_state_record_t, crc));
+}
+
+/* Compared by field, so padding bytes of the struct are not regarded. Add a new field here too. */
+static bool device_state_is_equal(device_state_t const * p_a, device_state_t const * p_b)
+{
+    return (p_a->logical_address == p_b->logical_address) &&
+           (p_a->volume == p_b->volume) &&
+           (p_a->is_mute == p_b->is_mute) &&
+           (p_a->power_status == p_b->power_status) &&
+           (p_a->is_vendor_id_valid == p_b->is_vendor_id_valid) &&
+           (0 == memcmp(&p_a->vendor_id[0], &p_b->vendor_id[0], sizeof(p_a->vendor_id)));
+}
+
+fsp_err_t device_state_storage_initialize(device_state_t * p_state)
+{
+    fsp_err_t                     fsp_err;
+    device_state_record_t const * p_latest = NULL;
+    uint32_t                      latest_slot = 0;
+
+    fsp_err = R_FLASH_HP_Open(&g_flash0_ctrl, &g_flash0_cfg);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        APP_PRINT("R_FLASH_HP_Open failed\r\n");
+        return fsp_err;
+    }
+    device_state_storage_open = true;
+
+    /* Find the valid record with the largest sequence number. Data flash is read through the memory map. */
+    for(uint32_t i=0; i<DEVICE_STATE_SLOT_NUMBER; i++)
+    {
+        device_state_record_t const * p_record =
+            (device_state_record_t const *)(DATA_FLASH_START_ADDRESS + (i * DEVICE_STATE_RECORD_SIZE));
+
+        if(device_state_record_check(p_record))
+        {
+            if((NULL == p_latest) || ((int32_t)(p_record->sequence - p_latest->sequence) > 0))
+            {
+                p_latest = p_record;
+                latest_slot = i;
+            }
+        }
+    }
+
+    if(NULL == p_latest)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    p_state->logical_address    = (cec_addr_t)p_latest->logical_address;
+    p_state->volume             = p_latest->volume;
+    p_state->is_mute            = (p_latest->is_mute != 0U);
+    p_state->power_status       = p_latest->power_status;
+    p_state->is_vendor_id_valid = (p_latest->is_vendor_id_valid != 0U);
+    memcpy(&p_state->vendor_id[0], &p_latest->vendor_id[0], 3);
+
+    device_state_stored    = *p_state;
+    device_state_sequence  = p_latest->sequence;
+    device_state_next_slot = (latest_slot + 1) % DEVICE_STATE_SLOT_NUMBER;
+
+    return FSP_SUCCESS;
+}
+
+void device_state_storage_update(device_state_t const * p_state)
+{
+    device_state_t const * p_reference = device_state_is_pending ? &device_state_pending : &device_state_stored;
+
+    if(device_state_is_equal(p_reference, p_state))
+    {
+        return;
+    }
+
+    /* Restart the delay on every change, so a volume ramp is written once */
+    device_state_pending    = *p_state;
+    device_state_is_pending = true;
+    device_state_write_tick = system_tick_get() + DEVICE_STATE_WRITE_DELAY_MS;
+}
+
+void device_state_storage_process(void)
+{
+    if(!device_state_is_pending || !SYSTEM_TICK_IS_REACHED(device_state_write_tick))
+    {
+        return;
+    }
+
+    device_state_is_pending = false;
+    if(device_state_is_equal(&device_state_stored, &device_state_pending))
+    {
+        /* Changed back to the stored state */
+        return;
+    }
+
+    if(FSP_SUCCESS == device_state_record_write(&device_state_pending))
+    {
+        device_state_stored = device_state_pending;
+    }
+    else
+    {
+        APP_PRINT("Device state save failed.\r\n");
+    }
+}
+
+static fsp_err_t device_state_record_write(device_state_t const * p_state)
+{
+    fsp_err_t             fsp_err = FSP_ERR_NOT_ERASED;
+    device_state_record_t record;
+    flash_result_t        blank_check_result;
+
+    if(!device_state_storage_open)
+    {
+        return FSP_ERR_NOT_OPEN;
+    }
+
+    memset(&record, 0x0, sizeof(record));
+    record.magic              = DEVICE_STATE_RECORD_MAGIC;
+    record.version            = DEVICE_STATE_RECORD_VERSION;
+    record.logical_address    = (uint8_t)p_state->logical_address;
+    record.sequence           = device_state_sequence + 1;
+    record.volume             = p_state->volume;
+    record.is_mute            = p_state->is_mute ? 1U : 0U;
+    record.power_status       = p_state->power_status;
+    record.is_vendor_id_valid = p_state->is_vendor_id_valid ? 1U : 0U;
+    memcpy(&record.vendor_id[0], &p_state->vendor_id[0], 3);
+    record.crc = device_state_crc_calculate((uint8_t const *)&record, offsetof(device_state_record_t, crc));
+
+    /* A slot which is not blank, e.g. by a reset during writing, is skipped */
+    for(uint32_t retry=0; retry<DEVICE_STATE_SLOT_NUMBER; retry++)
+    {
+        uint32_t address = DATA_FLASH_START_ADDRESS + (device_state_next_slot * DEVICE_STATE_RECORD_SIZE);
+
+        device_state_next_slot = (device_state_next_slot + 1) % DEVICE_STATE_SLOT_NUMBER;
+
+        /* Entering a block, erase it. It holds the oldest records only. */
+        if((address % DATA_FLASH_BLOCK_SIZE) == 0U)
+        {
+            fsp_err = R_FLASH_HP_Erase(&g_flash0_ctrl, address, 1);
+            if(FSP_SUCCESS != fsp_err)
+            {
+                return fsp_err;
+            }
+        }
+        else
+        {
+            fsp_err = R_FLASH_HP_BlankCheck(&g_flash0_ctrl, address, DEVICE_STATE_RECORD_SIZE, &blank_check_result);
+            if((FSP_SUCCESS != fsp_err) || (FLASH_RESULT_BLANK != blank_check_result))
+            {
+                continue;
+            }
+        }
+
+        fsp_err = R_FLASH_HP_Write(&g_flash0_ctrl, (uint32_t)&record, address, DEVICE_STATE_RECORD_SIZE);
+        if(FSP_SUCCESS == fsp_err)
+        {
+            device_state_sequence = record.sequence;
+            break;
+        }
+    }
+
+    return fsp_err;
+}
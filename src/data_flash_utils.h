@@ -0,0 +1,62 @@
+/***********************************************************************************************************************
+ * File Name    : data_flash_utils.h
+ * Description  : Contains data structures and functions used in data_flash_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef __DATA_FLASH_UTILS_H__
+#define __DATA_FLASH_UTILS_H__
+#include "hal_data.h"
+
+#define DEVICE_STATE_RECORD_MAGIC   (0x4543) /* "CE" */
+#define DEVICE_STATE_RECORD_VERSION (1)
+#define DEVICE_STATE_RECORD_SIZE    (32)
+
+/* Device state kept across resets */
+typedef struct device_state
+{
+    cec_addr_t logical_address;
+    uint8_t    volume;             ///< Volume value in percent
+    bool       is_mute;
+    uint8_t    power_status;       ///< 0: Standby, 1: On
+    bool       is_vendor_id_valid;
+    uint8_t    vendor_id[3];
+} device_state_t;
+
+/* Layout of a record in the data flash. Written in slots one after another for wear levelling. */
+typedef struct device_state_record
+{
+    uint16_t magic;
+    uint8_t  version;
+    uint8_t  logical_address;
+    uint32_t sequence;           ///< Incremented every write. The largest one is the latest record
+    uint8_t  volume;
+    uint8_t  is_mute;
+    uint8_t  power_status;
+    uint8_t  is_vendor_id_valid;
+    uint8_t  vendor_id[3];
+    uint8_t  reserved[13];
+    uint32_t crc;                ///< CRC-32 of the bytes above
+} device_state_record_t; /* Total 32 bytes */
+
+fsp_err_t device_state_storage_initialize(device_state_t * p_state);
+void device_state_storage_update(device_state_t const * p_state);
+void device_state_storage_process(void);
+
+#endif /* End of __DATA_FLASH_UTILS_H__ */
@@ -25,11 +25,43 @@
 #include "application_utils.h"
 #include "hdmi_cec_utils.h"
 #include "hdmi_ddc_utils.h"
+#include "data_flash_utils.h"
+#include "hdmi_scdc_utils.h"
+#include "hdmi_ddc_ci_utils.h"
+#include "cec_monitor_utils.h"
 
 ///####################### Application Option Setting #######################
 
 #define APP_HDMI_DDC_PHYSICAL_ADDR_GET   (1) // 0: Use fixed value, 1: Get from sink device edid
-#define APP_VENDOR_ID_INSTALL            (1) // 0: Use fixed value, 1: Install using SEGGER RTT Viewer
+#define APP_HDMI_HPD_DETECT              (1) // 0: Wait fixed 500 ms for HDMI connection, 1: Monitor hot plug detect pin
+#define APP_HDMI_HPD_DEBOUNCE_MS         (100) // HPD level must be stable for this time. HPD low shorter than 100 ms is not a disconnection
+#define APP_HDMI_HPD_BOOT_TIMEOUT_MS     (3000) // Boot goes on with the fixed physical address if no sink asserts HPD in this time. A later connection is handled in the main loop
+#define APP_HDMI_CONNECT_RETRY_MS        (100) // First retry of EDID read and address allocation after a failure on connection. Doubled for each failure while HPD stays high
+#define APP_HDMI_CONNECT_RETRY_MAX_MS    (6400) // Upper limit of the retry interval
+#define APP_HDMI_SCDC_POLL               (1) // 0: Disabled, 1: Poll SCDC of the sink for link health
+#define APP_HDMI_DDC_CI                  (1) // 0: Disabled, 1: Follow volume and mute on the display via DDC/CI (for displays without CEC)
+#define APP_CEC_RX_FILTER_DROP_SELF      (1) // 0: Log own frames, 1: Drop frames from my logical address in the interrupt
+#define APP_CEC_RX_FILTER_DROP_SOURCE    (0x0000) // Bit n: drop frames from logical address n in the interrupt. See cec_rx_filter_opcode_set() for opcodes
+#define APP_CEC_BUS_MONITOR              (0) // 0: Disabled, 1: Stream every frame on the bus to RTT buffer 1 (binary records, see cec_monitor_utils.h)
+#define APP_CEC_TIMING_ANALYZER          (0) // 0: Disabled, 1: Measure bit timing of every sender with GPT input capture (jumper CEC line to the capture pin, see cec_timing_utils.c)
+#define APP_VENDOR_ID_INSTALL            (0) // 0: Select from EDID manufacturer (fixed value if unknown), 1: Override using SEGGER RTT Viewer
+#define APP_DEVICE_STATE_SAVE            (1) // 0: Disabled, 1: Save device state to data flash and restore it at boot
+
+#define APP_CEC_DEVICE_TYPE              (CEC_DEVICE_TYPE_AUDIO_SYSTEM) // CEC_DEVICE_TYPE_xxx: Logical address is allocated from candidates of this type
+#define APP_CEC_SECONDARY_DEVICE_TYPE    (CEC_DEVICE_TYPE_UNKNOWN) // CEC_DEVICE_TYPE_xxx: Also claim and answer for a logical address of this type (e.g. PLAYBACK_DEVICE), UNKNOWN: Single address
+#define APP_CEC_ALLOCATION_TIMEOUT_MS    (100) // Wait for the polling message of a candidate address to complete
+#define APP_CEC_TX_RETRY_COUNT           (5) // 0 - 5: Retransmissions after NACK or TX error
+#define APP_CEC_TX_ARBITRATION_RETRY_COUNT (5) // Re-attempts after arbitration loss. Not counted in APP_CEC_TX_RETRY_COUNT
+
+#define APP_CEC_KEY_REPEAT_INTERVAL_MS   (300) // 200 - 500: Repetition time of User Control Pressed while a key is held
+#define APP_CEC_KEY_TAP_HOLD_MS          (100) // Hold time of a key sent from App Menu
+#define APP_CEC_KEY_RELEASE_TIMEOUT_MS   (550) // A received key is regarded as released without User Control Pressed repeat in this time
+#define APP_CEC_VOLUME_RAMP_INTERVAL_MS  (50)  // Volume changes by 1% in this interval while a volume key is held
+#define APP_CEC_ARC                      (1) // 0: Disabled (Feature Abort), 1: Receive TV audio over ARC together with System Audio Mode
+#define APP_CEC_ARC_RETRY_COUNT          (2) // Re-requests of ARC initiation/termination when TV does not answer in APP_CEC_REPLY_TIMEOUT_MS
+#define APP_CEC_SAD_FROM_EDID            (0) // 0: Report my_short_audio_descriptor, 1: Report Audio Data Block of the sink EDID (fixed value if not found)
+#define APP_CEC_RX_DUPLICATE_WINDOW_MS   (50) // Same frame starting within this time after the end of the last one is a retransmission. Must be shorter than a key repeat gap
+#define APP_CEC_REPLY_TIMEOUT_MS         (1000) // Response time allowed to a device for a request
 
 #define DEBUG_CEC_INTERRUPT_EVENT_OUTPUT (0) // 0: Disabled, 1: Enabled
 
@@ -49,11 +81,31 @@ const uint8_t my_osd_name[MY_OSD_NAME_LENGTH] = "RA CEC DEMO";
 
 /* My Vendor ID. */
 /* Specify vendor ID of your connected TV. For example, LG TV: {0x00, 0xE0, 0x91}. Toshiba TV: {0x00, 0x00, 0x39} */
+/* The value is replaced by vendor ID of the sink manufacturer found in EDID. */
 /* If APP_VENDOR_ID_INSTALL is enabled (1), the value will be updated by SEGGER RTT Viewer installation. */
 uint8_t my_vendor_id[3] =                       {0x00, 0x00, 0x00};
 
+/* My Short Audio Descriptors. */
+/* Audio formats reported to TV by Report Short Audio Descriptor. Same format as SAD of EDID Audio Data Block (CTA-861). */
+/* If APP_CEC_SAD_FROM_EDID is enabled (1), the value will be replaced by the Audio Data Block of the sink EDID. */
+#define MY_SAD_NUMBER                           (2)
+const uint8_t my_short_audio_descriptor[MY_SAD_NUMBER][CEC_SAD_LENGTH] =
+{
+    {0x09, 0x07, 0x07}, // LPCM 2ch, 32/44.1/48 kHz, 16/20/24 bit
+    {0x15, 0x07, 0x50}, // AC-3 6ch, 32/44.1/48 kHz, 640 kbps
+};
+
 ///####################### End of User Device Setting #######################
 
+#if (APP_CEC_KEY_REPEAT_INTERVAL_MS < 200) || (APP_CEC_KEY_REPEAT_INTERVAL_MS > 500)
+#error "APP_CEC_KEY_REPEAT_INTERVAL_MS is out of the repetition time of HDMI specification (200 - 500 ms)"
+#endif
+
+/* User Control Pressed (4.5 ms + 3 x 24 ms long) repeated every 200 ms leaves 123 ms between the frames */
+#if (APP_CEC_RX_DUPLICATE_WINDOW_MS < 10) || (APP_CEC_RX_DUPLICATE_WINDOW_MS > 100)
+#error "APP_CEC_RX_DUPLICATE_WINDOW_MS must cover retransmission wait (7.2 ms) and be shorter than key repetition gap"
+#endif
+
 #if (DEBUG_CEC_INTERRUPT_EVENT_OUTPUT == 1)
 #define RTT_DEBUG(fn_, ...)   APP_PRINT((fn_), ##__VA_ARGS__)
 #else
@@ -61,9 +113,34 @@ uint8_t my_vendor_id[3] =                       {0x00, 0x00, 0x00};
 #endif
 
 cec_addr_t my_logical_address = CEC_ADDR_UNREGISTERED;
+cec_addr_t my_secondary_logical_address = CEC_ADDR_UNREGISTERED; /* Allocated for APP_CEC_SECONDARY_DEVICE_TYPE */
+
+/* Device state restored from data flash */
+device_state_t device_state_saved;
+bool           device_state_is_restored = false;
 
 volatile bool system_audio_mode_support_function = false;
-volatile bool system_audio_mode_status = false;
+volatile bool system_audio_mode_status = false; /* true only in CEC_SYSTEM_AUDIO_STATE_ON */
+
+/* System Audio Control. Driven by cec_system_audio_process() */
+#define CEC_SYSTEM_AUDIO_RESET_WAIT_MS (300)
+cec_system_audio_state_t cec_system_audio_state = CEC_SYSTEM_AUDIO_STATE_IDLE;
+uint32_t                 cec_system_audio_deadline;
+/* Each Set System Audio Mode completes into its own slot, so the completion of an older one still queued is not taken for the last one */
+#define CEC_SYSTEM_AUDIO_TX_RESULT_NUMBER (4)
+fsp_err_t                cec_system_audio_tx_result_list[CEC_SYSTEM_AUDIO_TX_RESULT_NUMBER];
+fsp_err_t *              p_cec_system_audio_tx_result = &cec_system_audio_tx_result_list[0]; /* Result of the last Set System Audio Mode */
+/* System Audio Mode Request of TV received during RESETTING or TERMINATING, answered when the state settles */
+#define CEC_SYSTEM_AUDIO_TV_REQUEST_NONE  (0xFF)
+uint8_t                  cec_system_audio_tv_request = CEC_SYSTEM_AUDIO_TV_REQUEST_NONE; /* Otherwise CEC_SYSTEM_AUDIO_STATUS_xxx */
+
+/* Audio Return Channel. Driven by cec_arc_process() */
+cec_arc_state_t   cec_arc_state = CEC_ARC_STATE_IDLE;
+cec_reply_state_t cec_arc_reply_state = CEC_REPLY_STATE_REPLIED; /* Reply of the last ARC request */
+uint8_t           cec_arc_retry_count = 0;
+
+/* Audio formats answered to Request Short Audio Descriptor. Built by cec_sad_table_update() */
+cec_sad_table_t cec_sad_table;
 
 /* List of CEC bus device status */
 cec_device_status_t cec_bus_device_list[16];
@@ -83,23 +160,122 @@ volatile bool        cec_tx_complete_flag = false;
 volatile bool        cec_err_flag = false;
 volatile cec_error_t cec_err_type;
 
+/* CEC transmission statistics */
+cec_tx_statistics_t cec_tx_statistics;
+
+/* Ingress filter of received frames */
+cec_rx_filter_t cec_rx_filter =
+{
+    (APP_CEC_RX_FILTER_DROP_SELF == 1), /* is_self_drop */
+    APP_CEC_RX_FILTER_DROP_SOURCE,      /* source_drop_bitmap */
+    {0},                                /* opcode_drop_bitmap */
+    0, 0, 0, 0
+};
+
+/* TX queue for CEC transmission data. Requests are transmitted in order by cec_tx_process() */
+#define CEC_TX_QUEUE_NUMBER (8)
+cec_tx_request_t cec_tx_queue[CEC_TX_QUEUE_NUMBER];
+uint8_t          cec_tx_queue_read_point = 0;
+uint8_t          cec_tx_queue_count = 0;
+cec_tx_state_t   cec_tx_state = CEC_TX_STATE_IDLE;
+uint32_t         cec_tx_deadline; /* Completion timeout in BUSY state, retry time in RETRY_WAIT state */
+cec_error_t      cec_tx_last_error; /* Error of the last completed request */
+
+/* Requests waiting for the reply from a device */
+#define CEC_REPLY_REQUEST_NUMBER (8)
+cec_reply_request_t cec_reply_request_list[CEC_REPLY_REQUEST_NUMBER];
+
+/* Queue of User Control key events and the key currently held */
+#define CEC_KEY_EVENT_QUEUE_NUMBER (8)
+cec_key_event_t cec_key_event_queue[CEC_KEY_EVENT_QUEUE_NUMBER];
+uint8_t         cec_key_event_queue_read_point = 0;
+uint8_t         cec_key_event_queue_count = 0;
+cec_key_event_t cec_key_current;
+bool            cec_key_is_pressed = false;
+bool            cec_key_release_request = false;
+uint32_t        cec_key_repeat_tick;
+uint32_t        cec_key_release_tick;
+
+/* Key hold status of User Control Pressed received from each logical address */
+cec_key_hold_status_t cec_key_hold_list[16];
+
 /* RX buffer for CEC reception data */
 #define CEC_RX_DATA_BUFF_DATA_NUMBER (16 * 5)
 cec_rx_message_buff_t cec_rx_data_buff[CEC_RX_DATA_BUFF_DATA_NUMBER];
 volatile uint8_t      cec_rx_data_buff_next_store_point = 0;
 
-fsp_err_t cec_message_send(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length);
+/* Frames received recently. Used in the interrupt to drop retransmissions. */
+#define CEC_RX_DUPLICATE_CACHE_NUMBER (4)
+cec_rx_duplicate_entry_t cec_rx_duplicate_cache[CEC_RX_DUPLICATE_CACHE_NUMBER];
 
-fsp_err_t cec_logical_address_allocate(void);
+fsp_err_t cec_message_send(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length);
+fsp_err_t cec_message_send_from(cec_addr_t source, cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length);
+fsp_err_t cec_message_post(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length, fsp_err_t * p_result);
+fsp_err_t cec_message_post_from(cec_addr_t source, cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                                fsp_err_t * p_result);
+void cec_tx_process(void);
+void cec_tx_attempt_start(cec_tx_request_t * p_request);
+void cec_tx_request_complete(cec_tx_request_t * p_request, fsp_err_t result, cec_error_t tx_error);
+
+fsp_err_t cec_request_post(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                           uint8_t reply_opcode, cec_reply_state_t * p_state);
+cec_reply_state_t cec_request_send(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                                   uint8_t reply_opcode);
+void cec_reply_process(void);
+void cec_reply_resolve(cec_rx_message_buff_t const * p_buff);
+void cec_request_cancel(cec_reply_state_t const * p_state);
+
+bool cec_unsupported_opcode_check(cec_addr_t destination, uint8_t opcode);
+bool cec_unsupported_opcode_skip_check(cec_addr_t destination, uint8_t opcode);
+void cec_unsupported_opcode_learn(cec_rx_message_buff_t const * p_buff);
+void cec_unsupported_opcode_forget(cec_addr_t device, uint8_t opcode);
+void cec_unsupported_opcode_clear(cec_addr_t device);
+
+fsp_err_t cec_key_press(cec_addr_t destination, uint8_t ui_command, uint32_t hold_ms);
+void cec_key_release(void);
+void cec_key_process(void);
+
+bool cec_key_hold_repeat_check(cec_addr_t source, uint8_t ui_command);
+void cec_key_hold_press(cec_addr_t source, uint8_t ui_command);
+void cec_key_hold_release(cec_addr_t source, bool is_timeout);
+void cec_key_hold_process(void);
+
+bool hdmi_hpd_debounce(bool * p_level);
+void hdmi_hpd_process(void);
+void hdmi_disconnect_handle(uint8_t power_status, cec_addr_t * p_last_logical_address);
+void cec_physical_address_report(void);
+void cec_my_device_status_update(uint8_t power_status);
+
+fsp_err_t cec_logical_address_allocate(cec_addr_t preferred_addr);
 fsp_err_t cec_logical_address_allocate_attempt(cec_addr_t local_addr);
+void      cec_secondary_logical_address_allocate(void);
+bool      cec_logical_address_is_mine(cec_addr_t logical_addr);
+void      cec_local_address_apply(cec_addr_t source);
 
 void cec_system_audio_mode_support_enabling(void);
 void cec_system_audio_mode_request(void);
+void cec_system_audio_process(void);
+void cec_system_audio_state_set(cec_system_audio_state_t state);
+fsp_err_t cec_system_audio_mode_post(uint8_t system_audio_status);
+void cec_system_audio_tv_request_answer(uint8_t system_audio_status);
+
+void cec_arc_initiate(void);
+void cec_arc_terminate(void);
+void cec_arc_process(void);
+void cec_arc_request_post(cec_arc_state_t state);
+void cec_arc_state_set(cec_arc_state_t state);
+void cec_sad_table_update(void);
+bool cec_arc_available_check(void);
 
 void cec_rx_data_check(void);
+bool cec_rx_filter_drop_check(cec_rx_message_buff_t const * p_buff);
+bool cec_rx_duplicate_check(cec_rx_message_buff_t const * p_buff);
+void cec_rx_filter_opcode_set(uint8_t opcode, bool is_drop);
+bool cec_rx_operand_length_validate(cec_rx_message_buff_t * p_buff);
 void cec_system_auto_response(cec_rx_message_buff_t const * buff);
 
 void cec_bus_scan(void);
+bool cec_bus_scan_query_needed(cec_device_status_t const * p_device, uint8_t opcode);
 void cec_bus_status_buffer_display(void);
 
 void R_BSP_WarmStart(bsp_warm_start_event_t event);
@@ -107,7 +283,10 @@ void R_BSP_WarmStart(bsp_warm_start_event_t event);
 void hal_entry(void)
 {
     fsp_err_t fsp_err = FSP_SUCCESS;
-    uint8_t cec_data[CEC_DATA_BUFFER_LENGTH];
+    bool      hdmi_is_connected = true;
+
+    /* Start 1 millisecond system tick used for CEC timing */
+    system_tick_initialize();
 
     /* Print project banner */
     fsp_pack_version_t fsp_version = {RESET_VALUE};
@@ -116,8 +295,31 @@ void hal_entry(void)
     APP_PRINT(APP_DESCRIPTION);
     APP_PRINT(APP_LED_DESCRIPTION);
 
-    /* Make 500 ms delay for HDMI connection. In deal, the MCU should check the hot plug pin of HDMI connector. */
+#if (APP_HDMI_HPD_DETECT == 0)
+    /* Make 500 ms delay for HDMI connection. */
     R_BSP_SoftwareDelay(500, BSP_DELAY_UNITS_MILLISECONDS);
+#else
+    /* Wait for the sink to assert hot plug detect. EDID is readable after that. */
+    hdmi_hpd_irq_initialize();
+    APP_PRINT("Waiting for HDMI hot plug detect ...\r\n");
+    bool     hpd_level = false;
+    uint32_t hpd_deadline = system_tick_get() + APP_HDMI_HPD_BOOT_TIMEOUT_MS;
+    hdmi_is_connected = false;
+    while(!hdmi_is_connected && !SYSTEM_TICK_IS_REACHED(hpd_deadline))
+    {
+        hdmi_is_connected = hdmi_hpd_debounce(&hpd_level) && hpd_level;
+    }
+
+    if(hdmi_is_connected)
+    {
+        APP_PRINT("HDMI hot plug detected (%d ms after boot).\r\n", system_tick_get());
+    }
+    else
+    {
+        /* Debounced level is still low, so hdmi_hpd_process() handles the connection when it comes */
+        APP_PRINT("HDMI hot plug is not detected. Continue without sink.\r\n");
+    }
+#endif
 
     /* Initialize and enable external irq for user button detect */
     user_button_irq_initialize();
@@ -125,26 +327,79 @@ void hal_entry(void)
     /* Initialize LEDs. A pin for LED2 now starts PWM output. */
     demo_system_initialize();
 
+#if (APP_DEVICE_STATE_SAVE == 1)
+    /* Restore volume and power before the first CEC message */
+    device_state_is_restored = (FSP_SUCCESS == device_state_storage_initialize(&device_state_saved));
+    if(device_state_is_restored)
+    {
+        demo_system_volume_restore(device_state_saved.volume, device_state_saved.is_mute);
+        if(device_state_saved.power_status == 0x0)
+        {
+            demo_system_power_off();
+        }
+        APP_PRINT("Device state restored. Volume: %d%%%s, Power: %s.\r\n", device_state_saved.volume,
+                  device_state_saved.is_mute ? " (Mute)" : "", (device_state_saved.power_status == 0x0) ? "Standby" : "On");
+    }
+#endif
+
     /* Get physical address */
 #if (APP_HDMI_DDC_PHYSICAL_ADDR_GET == 0)
     APP_PRINT("Fixed physical address will be used\r\n");
 #else
-    APP_PRINT("Getting physical address from EDID via HDMI-DDC channel (I2C) ...\r\n");
-    fsp_err = physical_address_get(&my_physical_address[0]);
-    if(FSP_SUCCESS != fsp_err)
+    if(hdmi_is_connected)
     {
-        APP_PRINT("DDC physical address get failed.\r\n");
-        ERROR_INDICATE_LED_ON; __BKPT(0);
+        APP_PRINT("Getting physical address from EDID via HDMI-DDC channel (I2C) ...\r\n");
+        fsp_err = physical_address_get(&my_physical_address[0]);
+        if(FSP_SUCCESS != fsp_err)
+        {
+            APP_PRINT("DDC physical address get failed.\r\n");
+            ERROR_INDICATE_LED_ON; __BKPT(0);
+        }
+    }
+    else
+    {
+        APP_PRINT("Fixed physical address will be used until HDMI is connected\r\n");
     }
 #endif
     APP_PRINT("My physical address is %x.%x.%x.%x.\r\n\r\n", my_physical_address[3], my_physical_address[2], my_physical_address[1], my_physical_address[0]);
 
+    /* Set my audio formats */
+    cec_sad_table_update();
+
+    /* Without sink, they are started by hdmi_hpd_process() on the connection */
+    if(hdmi_is_connected)
+    {
+#if (APP_HDMI_SCDC_POLL == 1)
+        /* Start link monitoring of the connected sink */
+        scdc_start();
+#endif
+#if (APP_HDMI_DDC_CI == 1)
+        /* Probe the display and read its features */
+        ddc_ci_start();
+#endif
+    }
+
     /* Set my vendor ID */
 #if (APP_VENDOR_ID_INSTALL == 0)
-    APP_PRINT("Fixed vendor ID will be used.\r\n");
+    if(FSP_SUCCESS == edid_vendor_id_get(&my_vendor_id[0]))
+    {
+        APP_PRINT("Vendor ID of the sink manufacturer will be used.\r\n");
+    }
+    else
+    {
+        APP_PRINT("Fixed vendor ID will be used.\r\n");
+    }
 #else
-    APP_PRINT("Setting up my vendor ID ...\r\n");
-    vendor_id_install(&my_vendor_id[0]);
+    if(device_state_is_restored && device_state_saved.is_vendor_id_valid)
+    {
+        APP_PRINT("Saved vendor ID will be used.\r\n");
+        memcpy(&my_vendor_id[0], &device_state_saved.vendor_id[0], 3);
+    }
+    else
+    {
+        APP_PRINT("Setting up my vendor ID ...\r\n");
+        vendor_id_install(&my_vendor_id[0]);
+    }
 #endif
     APP_PRINT("My vendor ID is 0x%02x, 0x%02x, 0x%02x.\r\n\r\n", my_vendor_id[0], my_vendor_id[1], my_vendor_id[2]);
 
@@ -152,27 +407,31 @@ void hal_entry(void)
     fsp_err = R_CEC_Open(&g_cec0_ctrl, &g_cec0_cfg);
     if(FSP_SUCCESS != fsp_err){ ERROR_INDICATE_LED_ON; __BKPT(0); }
 
+#if (APP_CEC_BUS_MONITOR == 1)
+    /* Capture frames of other devices too */
+    cec_monitor_initialize();
+#endif
+
+#if (APP_CEC_TIMING_ANALYZER == 1)
+    /* Timestamp every edge on the CEC line */
+    fsp_err = cec_timing_analyzer_start();
+    if(FSP_SUCCESS != fsp_err)
+    {
+        APP_PRINT("CEC timing analyzer is not available.\r\n");
+    }
+#endif
+
     /* Make 50 milliseconds delay. R_CEC_MediaInit may return FSP_ERR_IN_USE for up to 45 milliseconds after calling R_CEC_Open */
     R_BSP_SoftwareDelay(50, BSP_DELAY_UNITS_MILLISECONDS);
 
     /* Initialize CEC logical address */
-    fsp_err = cec_logical_address_allocate();
+    fsp_err = cec_logical_address_allocate(device_state_is_restored ? device_state_saved.logical_address : CEC_ADDR_UNREGISTERED);
     if(FSP_SUCCESS == fsp_err)
     {
         APP_PRINT("CEC logical address allocation completed.\r\n");
 
         /* Now we recognize my logical address, update internal cec bus device status buffer with my device info */
-        cec_bus_device_list[my_logical_address].is_power_status_store = true;
-        cec_bus_device_list[my_logical_address].power_status = 0x1;
-
-        cec_bus_device_list[my_logical_address].is_version_store = true;
-        cec_bus_device_list[my_logical_address].cec_version = CEC_VERSION_1_4;
-
-        cec_bus_device_list[my_logical_address].is_physical_address_store = true;
-        memcpy(&cec_bus_device_list[my_logical_address].physical_address[0], &my_physical_address[0], 4);
-
-        cec_bus_device_list[my_logical_address].is_vendor_id_store = true;
-        memcpy(&cec_bus_device_list[my_logical_address].vendor_id[0], &my_vendor_id[0], 3);
+        cec_my_device_status_update(device_state_is_restored ? device_state_saved.power_status : 0x1);
     }
     else
     {
@@ -211,6 +470,26 @@ void hal_entry(void)
                 case USER_ACTION_DISPLAY_CEC_BUS_STATUS_BUFF: /* Display CEC bus buffer data */
                     cec_bus_status_buffer_display();
                     break;
+                case USER_ACTION_DISPLAY_CEC_STATISTICS: /* Display CEC statistics */
+                    cec_tx_statistics_display(&cec_tx_statistics);
+#if (APP_HDMI_SCDC_POLL == 1)
+                    hdmi_link_statistics_display(scdc_link_statistics_get());
+#endif
+#if (APP_CEC_BUS_MONITOR == 1)
+                    APP_PRINT("Bus monitor records lost: %d\r\n", cec_monitor_lost_count_get());
+#endif
+#if (APP_CEC_TIMING_ANALYZER == 1)
+                    cec_line_timing_display(cec_timing_statistics_get());
+#endif
+                    cec_rx_filter_statistics_display(&cec_rx_filter);
+                    break;
+                case USER_ACTION_CLEAR_UNSUPPORTED_OPCODE_CACHE: /* Forget Feature Abort of all devices */
+                    for(int i=0; i<16; i++)
+                    {
+                        cec_unsupported_opcode_clear(i);
+                    }
+                    APP_PRINT("Cached unsupported opcodes are cleared.\r\n");
+                    break;
                 case USER_ACTION_REQUEST_POWER_ON: /* Power On (Image View On 0x04) */
                     cec_message_send(user_action_cec_target, CEC_OPCODE_IMAGE_VIEW_ON, NULL, 0);
                     break;
@@ -224,22 +503,13 @@ void hal_entry(void)
                     cec_system_audio_mode_request();
                     break;
                 case USER_ACTION_REQUEST_VOLUME_UP: /* Volume Up. User Control Pressed 0x44 => User Control Released 0x45 */
-                    cec_data[0] = USER_CONTROL_VOLUME_UP;
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_PRESSED, &cec_data[0], 1); /* User Control Pressed */
-                    R_BSP_SoftwareDelay(100, BSP_DELAY_UNITS_MILLISECONDS);
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_RELEASED, NULL, 0); /* User Control Released */
+                    cec_key_press(user_action_cec_target, USER_CONTROL_VOLUME_UP, APP_CEC_KEY_TAP_HOLD_MS);
                     break;
                 case USER_ACTION_REQUEST_VOLUME_DONW: /* Volume Down. User Control Pressed 0x44 => User Control Released 0x45 */
-                    cec_data[0] = USER_CONTROL_VOLUME_DOWN;
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_PRESSED, &cec_data[0], 1); /* User Control Pressed */
-                    R_BSP_SoftwareDelay(100, BSP_DELAY_UNITS_MILLISECONDS);
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_RELEASED, NULL, 0); /* User Control Released */
+                    cec_key_press(user_action_cec_target, USER_CONTROL_VOLUME_DOWN, APP_CEC_KEY_TAP_HOLD_MS);
                     break;
                 case USER_ACTION_REQUEST_VOLUME_MUTE: /* Mute. User Control Pressed 0x44 => User Control Released 0x45 */
-                    cec_data[0] = USER_CONTROL_MUTE;
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_PRESSED, &cec_data[0], 1); /* User Control Pressed */
-                    R_BSP_SoftwareDelay(100, BSP_DELAY_UNITS_MILLISECONDS);
-                    cec_message_send(user_action_cec_target, CEC_OPCODE_USER_CONTROL_RELEASED, NULL, 0); /* User Control Released */
+                    cec_key_press(user_action_cec_target, USER_CONTROL_MUTE, APP_CEC_KEY_TAP_HOLD_MS);
                     break;
 //                case <type defined> ToDo
 //                {
@@ -307,6 +577,59 @@ void hal_entry(void)
             }
         }
 
+#if (APP_HDMI_HPD_DETECT == 1)
+        /* Follow connection and disconnection of the sink */
+        hdmi_hpd_process();
+#endif
+
+        /* Advance key repetition and queued transmissions */
+        cec_key_hold_process();
+        cec_key_process();
+        cec_tx_process();
+        cec_reply_process();
+        cec_system_audio_process();
+        cec_arc_process();
+
+#if (APP_CEC_BUS_MONITOR == 1)
+        /* Stream captured frames to the host */
+        cec_monitor_process();
+#endif
+
+#if (APP_HDMI_SCDC_POLL == 1)
+        /* Read link status from the sink in background */
+        scdc_process();
+#endif
+
+#if (APP_HDMI_DDC_CI == 1)
+        /* Apply volume changes of any path (CEC action, key ramp) to the display */
+        {
+            bool mute; uint8_t volume;
+            demo_system_volume_status_get(&mute, &volume);
+            ddc_ci_audio_update(mute, volume);
+        }
+        ddc_ci_process();
+#endif
+
+#if (APP_CEC_SECONDARY_DEVICE_TYPE != CEC_DEVICE_TYPE_UNKNOWN)
+        /* Both addresses are the same product */
+        if(my_secondary_logical_address != CEC_ADDR_UNREGISTERED)
+        {
+            cec_bus_device_list[my_secondary_logical_address].power_status = cec_bus_device_list[my_logical_address].power_status;
+        }
+#endif
+
+#if (APP_DEVICE_STATE_SAVE == 1)
+        /* Save the device state when it has settled */
+        device_state_t device_state = {0};
+        device_state.logical_address    = my_logical_address;
+        demo_system_volume_status_get(&device_state.is_mute, &device_state.volume);
+        device_state.power_status       = cec_bus_device_list[my_logical_address].power_status;
+        device_state.is_vendor_id_valid = (APP_VENDOR_ID_INSTALL == 1);
+        memcpy(&device_state.vendor_id[0], &my_vendor_id[0], 3);
+        device_state_storage_update(&device_state);
+        device_state_storage_process();
+#endif
+
         R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
     }
 }
@@ -326,15 +649,29 @@ void cec_interrupt_callback(cec_callback_args_t *p_args)
             /* Application processing after transmission has completed. */
             RTT_DEBUG("@@@ TX COMP\r\n");
             cec_tx_complete_flag = true;
+#if (APP_CEC_BUS_MONITOR == 1)
+            cec_monitor_tx_end(0);
+#endif
             break;
         }
         case CEC_EVENT_RX_DATA:
         {
             RTT_DEBUG("@@@ RX 0x%x\r\n", p_args->data_byte);
+#if (APP_CEC_BUS_MONITOR == 1)
+            cec_monitor_rx_byte(p_args->data_byte);
+#endif
             /* Application to store and process received data bytes. */
             cec_rx_message_buff_t* p_buff = &cec_rx_data_buff[cec_rx_data_buff_next_store_point];
-            if(p_buff->byte_counter == 0)
+            if(p_buff->byte_counter >= CEC_DATA_BUFFER_LENGTH)
+            {
+                /* Longer than the 16-byte CEC frame. Keep the count so that the frame is not taken as a new one. */
+                p_buff->is_error = true;
+                break;
+            }
+            else if(p_buff->byte_counter == 0)
             {
+                /* Header block is received 4.5 ms start bit + 10 bits of 2.4 ms after the frame start */
+                p_buff->start_time_us = system_time_us_get() - 28500;
                 p_buff->source = (uint8_t)(p_args->data_byte >> 4);
                 p_buff->destination = (uint8_t)(p_args->data_byte & 0xF);
             }
@@ -348,18 +685,33 @@ void cec_interrupt_callback(cec_callback_args_t *p_args)
             }
 
             p_buff->byte_counter++;
-            if(p_buff->byte_counter == CEC_DATA_BUFFER_LENGTH)
-            {
-                p_buff->byte_counter = 0;
-            }
             break;
         }
         case CEC_EVENT_RX_COMPLETE:
         {
             /* Application processing for message reception complete. */
             RTT_DEBUG("@@@ RX COMP\r\n");
+            cec_rx_message_buff_t* p_buff = &cec_rx_data_buff[cec_rx_data_buff_next_store_point];
+
+#if (APP_CEC_BUS_MONITOR == 1)
+            cec_monitor_rx_end(0);
+
+            /* Frames directed to other devices are for the monitor only */
+            if(!cec_logical_address_is_mine(p_buff->destination) && (p_buff->destination != CEC_ADDR_BROADCAST))
+            {
+                memset(p_buff, 0, sizeof(cec_rx_message_buff_t));
+                break;
+            }
+#endif
+
+            /* Frames nobody cares about are dropped here, not to occupy the buffer and the log */
+            if(cec_rx_filter_drop_check(p_buff) || cec_rx_duplicate_check(p_buff))
+            {
+                memset(p_buff, 0, sizeof(cec_rx_message_buff_t));
+                break;
+            }
 
-            cec_rx_data_buff[cec_rx_data_buff_next_store_point].is_new_data = true;
+            p_buff->is_new_data = true;
 
             cec_rx_data_buff_next_store_point++;
             if(cec_rx_data_buff_next_store_point >= CEC_RX_DATA_BUFF_DATA_NUMBER)
@@ -373,6 +725,17 @@ void cec_interrupt_callback(cec_callback_args_t *p_args)
             cec_err_flag = true;
             cec_err_type = p_args->errors;
 
+#if (APP_CEC_BUS_MONITOR == 1)
+            if(cec_err_type & (CEC_ERROR_OERR | CEC_ERROR_TERR))
+            {
+                cec_monitor_rx_end(cec_err_type);
+            }
+            else
+            {
+                cec_monitor_tx_end(cec_err_type);
+            }
+#endif
+
             if(cec_err_type & (CEC_ERROR_OERR | CEC_ERROR_TERR))
             {
                 cec_rx_message_buff_t* p_buff = &cec_rx_data_buff[cec_rx_data_buff_next_store_point];
@@ -403,387 +766,1494 @@ void cec_interrupt_callback(cec_callback_args_t *p_args)
 
 fsp_err_t cec_message_send(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length)
 {
-    fsp_err_t fsp_err = FSP_SUCCESS;
-    cec_message_t cec_tx_message;
-    uint8_t       cec_tx_message_length; /* Total message size, including header, opcode, and data */
-    uint8_t       err_detect = false;
-    uint32_t      timeout_ms = (uint32_t)(5 + 40 * (2 + data_buff_length));
-
-    APP_PRINT("[> CEC Out] Dest: %d (%s),\r\n", destination, &cec_logical_device_list[destination][0]);
-    uint32_t opcode_list_point = opcode_description_find(opcode);
-    APP_PRINT("            Opcode: 0x%x (%s)", opcode, &cec_opcode_list[opcode_list_point].opcode_desc_str[0]);
-    if(data_buff_length > 0)
-    {
-        APP_PRINT(", Data: ");
-        for(int j=0; j<data_buff_length; j++)
-        {
-            APP_PRINT("0x%x,", data_buff[j]);
-        }
-    }
-    APP_PRINT(" sending ... ");
+    return cec_message_send_from(my_logical_address, destination, opcode, data_buff, data_buff_length);
+}
 
-    /* Clear CEC TX message buffer */
-    memset(&cec_tx_message, 0U, sizeof(cec_tx_message));
+fsp_err_t cec_message_send_from(cec_addr_t source, cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length)
+{
+    /* FSP_ERR_IN_USE stays until the request is completed */
+    fsp_err_t result = FSP_ERR_IN_USE;
+    fsp_err_t fsp_err;
 
-    /* Create message */
-    cec_tx_message.destination = destination;
-    cec_tx_message.opcode      = opcode;
-    memcpy(&cec_tx_message.data[0], data_buff, data_buff_length);
-    cec_tx_message_length      = 2U + data_buff_length;
+    /* The device answered this opcode with Feature Abort before. Caller can fall back immediately. */
+    if(cec_unsupported_opcode_skip_check(destination, opcode))
+    {
+        return FSP_ERR_UNSUPPORTED;
+    }
 
-    /* Clear error flag */
-    cec_err_flag = false;
-    cec_err_type = 0x0;
+    /* Wait for a free slot of TX queue */
+    fsp_err = cec_message_post_from(source, destination, opcode, data_buff, data_buff_length, &result);
+    while(FSP_ERR_IN_USE == fsp_err)
+    {
+        cec_tx_process();
+        fsp_err = cec_message_post_from(source, destination, opcode, data_buff, data_buff_length, &result);
+    }
 
-    do{
-        fsp_err = R_CEC_Write(&g_cec0_ctrl, &cec_tx_message, cec_tx_message_length);
-    }while(FSP_ERR_IN_USE == fsp_err);
     if(FSP_SUCCESS != fsp_err)
     {
-        APP_PRINT("R_CEC_Write failed.\r\n");
-        ERROR_INDICATE_LED_ON; __BKPT(0);
+        return fsp_err;
     }
 
-    /* Wait for tx completion */
-    while(!cec_tx_complete_flag)
+    /* Wait for completion including the messages queued before */
+    while(FSP_ERR_IN_USE == result)
     {
-        if(cec_err_flag)
-        {
-            cec_err_flag = false;
+        cec_tx_process();
+    }
 
-            if(cec_err_type & (CEC_ERROR_UERR | CEC_ERROR_ACKERR | CEC_ERROR_TXERR | CEC_ERROR_AERR | CEC_ERROR_BLERR))
-            {
-                err_detect = true;
-                break;
-            }
-        }
+    return result;
+}
 
-        timeout_ms--;
-        if(timeout_ms == 0)
-        {
-            break;
-        }
-        R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
-    }
-    cec_tx_complete_flag = false;
+fsp_err_t cec_message_post(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length, fsp_err_t * p_result)
+{
+    return cec_message_post_from(my_logical_address, destination, opcode, data_buff, data_buff_length, p_result);
+}
+
+fsp_err_t cec_message_post_from(cec_addr_t source, cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                                fsp_err_t * p_result)
+{
+    cec_tx_request_t * p_request;
 
-    if(0 < timeout_ms)
+    if(cec_tx_queue_count >= CEC_TX_QUEUE_NUMBER)
     {
-        if(!err_detect)
-        {
-            APP_PRINT("Success\r\n");
+        return FSP_ERR_IN_USE;
+    }
 
-            return FSP_SUCCESS;
-        }
-        else
-        {
-            APP_PRINT("Error (0x%x)\r\n", cec_err_type);
+    p_request = &cec_tx_queue[(cec_tx_queue_read_point + cec_tx_queue_count) % CEC_TX_QUEUE_NUMBER];
+    memset(p_request, 0U, sizeof(cec_tx_request_t));
 
-            return FSP_ERR_ASSERTION;
-        }
-    }
-    else
+    /* Create message */
+    p_request->source              = source;
+    p_request->message.destination = destination;
+    p_request->message.opcode      = opcode;
+    if(data_buff_length > 0)
     {
-        APP_PRINT("Timeout\r\n", cec_err_type);
-
-        return FSP_ERR_TIMEOUT;
+        memcpy(&p_request->message.data[0], data_buff, data_buff_length);
     }
+    p_request->message_length      = (uint8_t)(2U + data_buff_length);
+    p_request->p_result            = p_result;
+
+    cec_tx_queue_count++;
+    cec_tx_statistics.message_count++;
+
+    return FSP_SUCCESS;
 }
 
-fsp_err_t cec_logical_address_allocate(void)
+void cec_tx_process(void)
 {
-    fsp_err_t fsp_err = FSP_SUCCESS;
-    bool logical_address_allocate = false;
+    cec_tx_request_t *   p_request = &cec_tx_queue[cec_tx_queue_read_point];
+    cec_error_t          tx_error;
+    cec_tx_retry_class_t retry_class;
+    bool                 retry = false;
 
-    APP_PRINT(CEC_LOGICAL_DEVICE_SELECT_MENU);
-
-    while(1)
+    switch(cec_tx_state)
     {
-        if(APP_CHECK_DATA)
+        case CEC_TX_STATE_IDLE:
         {
-            /* Read data from RTT buffer */
-            uint8_t rtt_read_data_c;
-            SEGGER_RTT_Read(0, &rtt_read_data_c, 1);
-
-            if(('1' <= rtt_read_data_c) && (rtt_read_data_c <= '5'))
+            if(cec_tx_queue_count > 0)
+            {
+                cec_tx_attempt_start(p_request);
+            }
+            break;
+        }
+        case CEC_TX_STATE_RETRY_WAIT:
+        {
+            if(SYSTEM_TICK_IS_REACHED(cec_tx_deadline))
+            {
+                cec_tx_attempt_start(p_request);
+            }
+            break;
+        }
+        case CEC_TX_STATE_BUSY:
+        {
+            if(cec_tx_complete_flag)
+            {
+                cec_tx_complete_flag = false;
+                cec_tx_request_complete(p_request, FSP_SUCCESS, 0x0);
+            }
+            else if(cec_err_flag)
             {
-                switch(rtt_read_data_c)
+                cec_err_flag = false;
+                tx_error = cec_err_type;
+
+                if(tx_error & (CEC_ERROR_UERR | CEC_ERROR_ACKERR | CEC_ERROR_TXERR | CEC_ERROR_AERR | CEC_ERROR_BLERR))
                 {
-                    case '1':
-                    {
-                        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_TV);
-                        if(fsp_err == FSP_SUCCESS)
-                        {
-                            logical_address_allocate = true;
-                            my_logical_address = CEC_ADDR_TV;
-                        }
-                        break;
-                    }
-                    case '2':
+                    /* Decide whether the failed attempt is retried */
+                    retry_class = cec_tx_retry_class_get(tx_error);
+                    if(CEC_TX_RETRY_CLASS_ARBITRATION_LOST == retry_class)
                     {
-                        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_RECORDING_DEVICE_1);
-                        if(fsp_err == FSP_SUCCESS)
-                        {
-                            logical_address_allocate = true;
-                            my_logical_address = CEC_ADDR_RECORDING_DEVICE_1;
-                        }
-
-                        if(logical_address_allocate == false)
-                        {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_RECORDING_DEVICE_2);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_RECORDING_DEVICE_2;
-                            }
-                        }
-
-                        if(logical_address_allocate == false)
+                        cec_tx_statistics.arbitration_lost_count++;
+                        if(p_request->arbitration_retry_count < APP_CEC_TX_ARBITRATION_RETRY_COUNT)
                         {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_RECORDING_DEVICE_3);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_RECORDING_DEVICE_3;
-                            }
+                            p_request->arbitration_retry_count++;
+                            retry = true;
                         }
-                        break;
                     }
-                    case '3':
+                    else if(CEC_TX_RETRY_CLASS_NONE != retry_class)
                     {
-                        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_TUNER_1);
-                        if(fsp_err == FSP_SUCCESS)
+                        if(CEC_TX_RETRY_CLASS_NACK == retry_class)
                         {
-                            logical_address_allocate = true;
-                            my_logical_address = CEC_ADDR_TUNER_1;
+                            cec_tx_statistics.nack_count++;
                         }
-
-                        if(logical_address_allocate == false)
-                        {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_TUNER_2);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_TUNER_2;
-                            }
-                        }
-
-                        if(logical_address_allocate == false)
+                        else
                         {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_TUNER_3);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_TUNER_3;
-                            }
+                            cec_tx_statistics.tx_error_count++;
                         }
 
-                        if(logical_address_allocate == false)
+                        if(p_request->retry_count < APP_CEC_TX_RETRY_COUNT)
                         {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_TUNER_4);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_TUNER_4;
-                            }
+                            p_request->retry_count++;
+                            retry = true;
                         }
-                        break;
                     }
-                    case '4':
-                    {
-                        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_PLAYBACK_DEVICE_1);
-                        if(fsp_err == FSP_SUCCESS)
-                        {
-                            logical_address_allocate = true;
-                            my_logical_address = CEC_ADDR_PLAYBACK_DEVICE_1;
-                        }
-
-                        if(logical_address_allocate == false)
-                        {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_PLAYBACK_DEVICE_2);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_PLAYBACK_DEVICE_2;
-                            }
-                        }
 
-                        if(logical_address_allocate == false)
-                        {
-                            fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_PLAYBACK_DEVICE_3);
-                            if(fsp_err == FSP_SUCCESS)
-                            {
-                                logical_address_allocate = true;
-                                my_logical_address = CEC_ADDR_PLAYBACK_DEVICE_3;
-                            }
-                        }
-                        break;
-                    }
-                    case '5':
+                    if(retry)
                     {
-                        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_AUDIO_SYSTEM);
-                        if(fsp_err == FSP_SUCCESS)
-                        {
-                            logical_address_allocate = true;
-                            my_logical_address = CEC_ADDR_AUDIO_SYSTEM;
-                        }
-                        break;
+                        /* Wait for the signal free time of the retry class. The peripheral measures its own signal free
+                         * time from the end of the last bit on the line, so this wait overlaps with it rather than
+                         * adding to it. 1 ms is added for the partial tick. */
+                        cec_tx_deadline = system_tick_get() + (cec_tx_retry_signal_free_time_us_get(retry_class) + 999) / 1000 + 1;
+                        cec_tx_state = CEC_TX_STATE_RETRY_WAIT;
                     }
-                    default:
+                    else
                     {
-                        /* Do nothing */
-                        break;
+                        cec_tx_request_complete(p_request, FSP_ERR_ASSERTION, tx_error);
                     }
                 }
-
-                if(logical_address_allocate == false)
-                {
-                    APP_PRINT("The Selected logical address type is in use by another device. Enter another one.\r\n");
-                }
-            }
-            else if((rtt_read_data_c == '\r') || (rtt_read_data_c == '\n'))
-            {
-                /* Do nothing */
             }
-            else
+            else if(SYSTEM_TICK_IS_REACHED(cec_tx_deadline))
             {
-                APP_PRINT("Invalid input.\r\n");
+                cec_tx_request_complete(p_request, FSP_ERR_TIMEOUT, 0x0);
             }
+            break;
+        }
+        default:
+        {
+            /* Do nothing */
+            break;
         }
+    }
+}
+
+void cec_tx_attempt_start(cec_tx_request_t * p_request)
+{
+    fsp_err_t fsp_err = FSP_SUCCESS;
+
+    /* Clear internal flags */
+    cec_tx_complete_flag = false;
+    cec_err_flag = false;
+    cec_err_type = 0x0;
+
+    /* R_CEC_Write makes the header block from the local address. Any of the acknowledged addresses can be the source. */
+    cec_local_address_apply(p_request->source);
+
+    fsp_err = R_CEC_Write(&g_cec0_ctrl, &p_request->message, p_request->message_length);
+    if(FSP_ERR_IN_USE == fsp_err)
+    {
+        /* Bus is busy by reception. Try again in next call. */
+        return;
+    }
+    if(FSP_SUCCESS != fsp_err)
+    {
+        APP_PRINT("R_CEC_Write failed.\r\n");
+        ERROR_INDICATE_LED_ON; __BKPT(0);
+    }
+
+#if (APP_CEC_BUS_MONITOR == 1)
+    cec_monitor_tx_start(p_request->source, &p_request->message, p_request->message_length);
+#endif
+
+    p_request->attempt_count++;
+    cec_tx_deadline = system_tick_get() + (uint32_t)(5 + 40 * p_request->message_length);
+    cec_tx_state = CEC_TX_STATE_BUSY;
+}
+
+void cec_tx_request_complete(cec_tx_request_t * p_request, fsp_err_t result, cec_error_t tx_error)
+{
+    uint32_t opcode_list_point = opcode_description_find(p_request->message.opcode);
+    uint8_t  data_length = (uint8_t)(p_request->message_length - 2U);
+
+    APP_PRINT("[> CEC Out] Dest: %d (%s),\r\n", p_request->message.destination, &cec_logical_device_list[p_request->message.destination][0]);
+    APP_PRINT("            Opcode: 0x%x (%s)", p_request->message.opcode, &cec_opcode_list[opcode_list_point].opcode_desc_str[0]);
+    if(data_length > 0)
+    {
+        APP_PRINT(", Data: ");
+        for(int j=0; j<data_length; j++)
+        {
+            APP_PRINT("0x%x,", p_request->message.data[j]);
+        }
+    }
+    APP_PRINT(" sending ... ");
+
+    if(FSP_SUCCESS == result)
+    {
+        cec_tx_statistics.success_count++;
+        if(p_request->attempt_count > 1)
+        {
+            APP_PRINT("Success (%d attempts)\r\n", p_request->attempt_count);
+            cec_tx_statistics.success_after_retry_count++;
+        }
+        else
+        {
+            APP_PRINT("Success\r\n");
+        }
+
+        if(p_request->attempt_count > (CEC_TX_RETRANSMISSION_MAX + 1))
+        {
+            cec_tx_statistics.attempt_histogram[CEC_TX_RETRANSMISSION_MAX]++;
+        }
+        else
+        {
+            cec_tx_statistics.attempt_histogram[p_request->attempt_count - 1]++;
+        }
+    }
+    else if(FSP_ERR_ASSERTION == result)
+    {
+        APP_PRINT("Error (0x%x)\r\n", tx_error);
+        cec_tx_statistics.error_count++;
+    }
+    else
+    {
+        APP_PRINT("Timeout\r\n");
+        cec_tx_statistics.timeout_count++;
+    }
+
+    cec_tx_last_error = tx_error;
+    if(NULL != p_request->p_result)
+    {
+        *p_request->p_result = result;
+    }
+
+    /* Remove the request from TX queue */
+    cec_tx_queue_read_point = (uint8_t)((cec_tx_queue_read_point + 1) % CEC_TX_QUEUE_NUMBER);
+    cec_tx_queue_count--;
+    cec_tx_state = CEC_TX_STATE_IDLE;
+}
+
+fsp_err_t cec_request_post(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                           uint8_t reply_opcode, cec_reply_state_t * p_state)
+{
+    fsp_err_t             fsp_err;
+    cec_reply_request_t * p_request = NULL;
+
+    if(cec_unsupported_opcode_skip_check(destination, opcode))
+    {
+        return FSP_ERR_UNSUPPORTED;
+    }
+
+    for(uint32_t i=0; i<CEC_REPLY_REQUEST_NUMBER; i++)
+    {
+        if(!cec_reply_request_list[i].is_used)
+        {
+            p_request = &cec_reply_request_list[i];
+            break;
+        }
+    }
+
+    if(NULL == p_request)
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    p_request->tx_result = FSP_ERR_IN_USE;
+    fsp_err = cec_message_post(destination, opcode, data_buff, data_buff_length, &p_request->tx_result);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        return fsp_err;
+    }
+
+    p_request->is_used        = true;
+    p_request->is_sent        = false;
+    p_request->destination    = destination;
+    p_request->request_opcode = opcode;
+    p_request->reply_opcode   = reply_opcode;
+    p_request->p_state        = p_state;
+    *p_state = CEC_REPLY_STATE_PENDING;
+
+    return FSP_SUCCESS;
+}
+
+cec_reply_state_t cec_request_send(cec_addr_t destination, uint8_t opcode, uint8_t const * data_buff, uint8_t data_buff_length,
+                                   uint8_t reply_opcode)
+{
+    cec_reply_state_t state;
+    fsp_err_t         fsp_err;
+
+    fsp_err = cec_request_post(destination, opcode, data_buff, data_buff_length, reply_opcode, &state);
+    if(FSP_ERR_UNSUPPORTED == fsp_err)
+    {
+        /* Rejected without transmission by the cached Feature Abort */
+        return CEC_REPLY_STATE_REJECTED;
+    }
+    else if(FSP_SUCCESS != fsp_err)
+    {
+        return CEC_REPLY_STATE_NOT_DELIVERED;
+    }
+
+    /* Wait for the reply. Received messages are processed meanwhile to find it. */
+    while(CEC_REPLY_STATE_PENDING == state)
+    {
+        cec_tx_process();
+        cec_rx_data_check();
+        cec_reply_process();
+    }
+
+    return state;
+}
+
+void cec_reply_process(void)
+{
+    for(uint32_t i=0; i<CEC_REPLY_REQUEST_NUMBER; i++)
+    {
+        cec_reply_request_t * p_request = &cec_reply_request_list[i];
+
+        if(!p_request->is_used || (FSP_ERR_IN_USE == p_request->tx_result))
+        {
+            continue;
+        }
+
+        if(NULL == p_request->p_state)
+        {
+            /* Already resolved. Release the entry now the transmission result is written. */
+            p_request->is_used = false;
+        }
+        else if(FSP_SUCCESS != p_request->tx_result)
+        {
+            *p_request->p_state = CEC_REPLY_STATE_NOT_DELIVERED;
+            p_request->is_used = false;
+        }
+        else if(!p_request->is_sent)
+        {
+            /* Response time starts at the end of the transmission */
+            p_request->is_sent = true;
+            p_request->deadline = system_tick_get() + APP_CEC_REPLY_TIMEOUT_MS;
+        }
+        else if(SYSTEM_TICK_IS_REACHED(p_request->deadline))
+        {
+            *p_request->p_state = CEC_REPLY_STATE_TIMEOUT;
+            p_request->is_used = false;
+        }
+        else
+        {
+            /* Waiting for the reply */
+        }
+    }
+}
+
+void cec_reply_resolve(cec_rx_message_buff_t const * p_buff)
+{
+    for(uint32_t i=0; i<CEC_REPLY_REQUEST_NUMBER; i++)
+    {
+        cec_reply_request_t * p_request = &cec_reply_request_list[i];
+
+        if(!p_request->is_used || (NULL == p_request->p_state))
+        {
+            continue;
+        }
+
+        if((p_request->destination != p_buff->source) && (p_request->destination != CEC_ADDR_BROADCAST))
+        {
+            continue;
+        }
+
+        if(p_buff->opcode == p_request->reply_opcode)
+        {
+            *p_request->p_state = CEC_REPLY_STATE_REPLIED;
+            p_request->p_state = NULL;
+        }
+        else if((p_buff->opcode == CEC_OPCODE_FEATURE_ABORT) && (p_buff->byte_counter >= 3) &&
+                (p_buff->data_buff[0] == p_request->request_opcode))
+        {
+            *p_request->p_state = CEC_REPLY_STATE_REJECTED;
+            p_request->p_state = NULL;
+        }
+        else
+        {
+            /* Not a reply to this request */
+        }
+    }
+}
+
+void cec_request_cancel(cec_reply_state_t const * p_state)
+{
+    /* Reply is no longer expected. The entry is released by cec_reply_process() after the transmission. */
+    for(uint32_t i=0; i<CEC_REPLY_REQUEST_NUMBER; i++)
+    {
+        if(cec_reply_request_list[i].is_used && (cec_reply_request_list[i].p_state == p_state))
+        {
+            cec_reply_request_list[i].p_state = NULL;
+        }
+    }
+}
+
+bool cec_unsupported_opcode_check(cec_addr_t destination, uint8_t opcode)
+{
+    cec_device_status_t * p_device;
+
+    if(destination >= CEC_ADDR_BROADCAST)
+    {
+        return false;
+    }
+
+    p_device = &cec_bus_device_list[destination];
+
+    /* Aging. The device may be updated or replaced, so it gets asked again. */
+    if((p_device->unsupported_opcode_tick != 0U) &&
+       !CEC_DEVICE_STATUS_IS_FRESH(true, p_device->unsupported_opcode_tick, CEC_DEVICE_STATUS_TTL_UNSUPPORTED_MS))
+    {
+        cec_unsupported_opcode_clear(destination);
+    }
+
+    return (p_device->unsupported_opcode[opcode / 32] & (1UL << (opcode % 32))) != 0U;
+}
+
+bool cec_unsupported_opcode_skip_check(cec_addr_t destination, uint8_t opcode)
+{
+    /* Used by the requests and user actions only. Answers and key events have their own fallback. */
+    if(!cec_unsupported_opcode_check(destination, opcode))
+    {
+        return false;
+    }
+
+    APP_PRINT("[> CEC Out] Dest: %d (%s), Opcode: 0x%x is not sent. Unsupported by the device.\r\n",
+              destination, &cec_logical_device_list[destination][0], opcode);
+    cec_tx_statistics.unsupported_skip_count++;
+
+    return true;
+}
+
+void cec_unsupported_opcode_learn(cec_rx_message_buff_t const * p_buff)
+{
+    cec_device_status_t * p_device;
+    uint8_t               opcode;
+
+    /* Feature Abort: [Feature Opcode] [Abort Reason] */
+    if((p_buff->opcode != CEC_OPCODE_FEATURE_ABORT) || (p_buff->byte_counter < 4) ||
+       (p_buff->source >= CEC_ADDR_UNREGISTERED))
+    {
+        return;
+    }
+
+    /* Only Unrecognized Opcode is permanent. Refused and the others depend on the device state. */
+    if(p_buff->data_buff[1] != CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE)
+    {
+        return;
+    }
+
+    p_device = &cec_bus_device_list[p_buff->source];
+    opcode   = p_buff->data_buff[0];
+
+    if(p_device->unsupported_opcode_tick == 0U)
+    {
+        /* 0 is reserved for the empty cache */
+        p_device->unsupported_opcode_tick = system_tick_get() | 1U;
+    }
+    p_device->unsupported_opcode[opcode / 32] |= (1UL << (opcode % 32));
+}
+
+void cec_unsupported_opcode_forget(cec_addr_t device, uint8_t opcode)
+{
+    /* The device has shown it supports the opcode, e.g. by requesting it */
+    if(device < CEC_ADDR_BROADCAST)
+    {
+        cec_bus_device_list[device].unsupported_opcode[opcode / 32] &= ~(1UL << (opcode % 32));
+    }
+}
+
+void cec_unsupported_opcode_clear(cec_addr_t device)
+{
+    memset(&cec_bus_device_list[device].unsupported_opcode[0], 0x0, sizeof(cec_bus_device_list[device].unsupported_opcode));
+    cec_bus_device_list[device].unsupported_opcode_tick = 0U;
+}
+
+fsp_err_t cec_key_press(cec_addr_t destination, uint8_t ui_command, uint32_t hold_ms)
+{
+    cec_key_event_t * p_event;
+
+    if(cec_key_event_queue_count >= CEC_KEY_EVENT_QUEUE_NUMBER)
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    p_event = &cec_key_event_queue[(cec_key_event_queue_read_point + cec_key_event_queue_count) % CEC_KEY_EVENT_QUEUE_NUMBER];
+    p_event->destination = destination;
+    p_event->ui_command  = ui_command;
+    p_event->hold_ms     = hold_ms;
+
+    cec_key_event_queue_count++;
+
+    return FSP_SUCCESS;
+}
+
+void cec_key_release(void)
+{
+    /* Applies to the key currently held only */
+    if(cec_key_is_pressed)
+    {
+        cec_key_release_request = true;
+    }
+}
+
+void cec_key_process(void)
+{
+    uint8_t cec_data[1];
+
+    if(cec_key_is_pressed)
+    {
+        if(cec_key_release_request || ((cec_key_current.hold_ms != 0) && SYSTEM_TICK_IS_REACHED(cec_key_release_tick)))
+        {
+            /* Release the key. Retried in next call if TX queue is full. */
+            if(FSP_SUCCESS == cec_message_post(cec_key_current.destination, CEC_OPCODE_USER_CONTROL_RELEASED, NULL, 0, NULL))
+            {
+                cec_key_is_pressed = false;
+                cec_key_release_request = false;
+            }
+        }
+        else if(cec_unsupported_opcode_check(cec_key_current.destination, CEC_OPCODE_USER_CONTROL_PRESSED))
+        {
+            /* The device aborted the key. Release it instead of repeating. */
+            cec_key_release_request = true;
+        }
+        else if(SYSTEM_TICK_IS_REACHED(cec_key_repeat_tick))
+        {
+            /* Repeat User Control Pressed while the key is held */
+            cec_data[0] = cec_key_current.ui_command;
+            if(FSP_SUCCESS == cec_message_post(cec_key_current.destination, CEC_OPCODE_USER_CONTROL_PRESSED, &cec_data[0], 1, NULL))
+            {
+                cec_key_repeat_tick = system_tick_get() + APP_CEC_KEY_REPEAT_INTERVAL_MS;
+            }
+        }
+    }
+
+    /* Next key event is pressed right after the previous one is released */
+    if((!cec_key_is_pressed) && (cec_key_event_queue_count > 0))
+    {
+        cec_key_event_t * p_event = &cec_key_event_queue[cec_key_event_queue_read_point];
+        fsp_err_t         fsp_err = FSP_ERR_UNSUPPORTED;
+
+        /* Known unsupported key is dropped. It would be aborted again and never released. */
+        if(!cec_unsupported_opcode_skip_check(p_event->destination, CEC_OPCODE_USER_CONTROL_PRESSED))
+        {
+            cec_data[0] = p_event->ui_command;
+            fsp_err = cec_message_post(p_event->destination, CEC_OPCODE_USER_CONTROL_PRESSED, &cec_data[0], 1, NULL);
+        }
+
+        if(FSP_SUCCESS == fsp_err)
+        {
+            cec_key_current = *p_event;
+            cec_key_is_pressed = true;
+            cec_key_repeat_tick = system_tick_get() + APP_CEC_KEY_REPEAT_INTERVAL_MS;
+            cec_key_release_tick = system_tick_get() + p_event->hold_ms;
+        }
+
+        /* Retried in next call if TX queue is full */
+        if(FSP_ERR_IN_USE != fsp_err)
+        {
+            cec_key_event_queue_read_point = (uint8_t)((cec_key_event_queue_read_point + 1) % CEC_KEY_EVENT_QUEUE_NUMBER);
+            cec_key_event_queue_count--;
+        }
+    }
+}
+
+bool cec_key_hold_repeat_check(cec_addr_t source, uint8_t ui_command)
+{
+    cec_key_hold_status_t * p_hold = &cec_key_hold_list[source];
+
+    if((!p_hold->is_pressed) || (p_hold->ui_command != ui_command))
+    {
+        return false;
+    }
+
+    p_hold->last_pressed_tick = system_tick_get();
+    if(p_hold->repeat_count == 0)
+    {
+        /* The key is held. Start volume ramp from now. */
+        p_hold->ramp_tick = p_hold->last_pressed_tick;
+    }
+    p_hold->repeat_count++;
+
+    return true;
+}
+
+void cec_key_hold_press(cec_addr_t source, uint8_t ui_command)
+{
+    cec_key_hold_status_t * p_hold = &cec_key_hold_list[source];
+
+    /* A different key means the previous one was released */
+    if(p_hold->is_pressed)
+    {
+        cec_key_hold_release(source, false);
+    }
+
+    p_hold->is_pressed = true;
+    p_hold->ui_command = ui_command;
+    p_hold->last_pressed_tick = system_tick_get();
+    p_hold->repeat_count = 0;
+}
+
+void cec_key_hold_release(cec_addr_t source, bool is_timeout)
+{
+    cec_key_hold_status_t * p_hold = &cec_key_hold_list[source];
+    bool    mute;
+    uint8_t volume;
+
+    if(!p_hold->is_pressed)
+    {
+        return;
+    }
+    p_hold->is_pressed = false;
+
+    if((p_hold->ui_command == USER_CONTROL_VOLUME_UP) || (p_hold->ui_command == USER_CONTROL_VOLUME_DOWN))
+    {
+        demo_system_volume_status_get(&mute, &volume);
+        APP_PRINT("[System] Sound volume %s released%s. Volume: %d%%.\r\n",
+                  (p_hold->ui_command == USER_CONTROL_VOLUME_UP) ? "up" : "down", is_timeout ? " (timeout)" : "", volume);
+    }
+    else
+    {
+        APP_PRINT("[System] User control 0x%x released%s.\r\n", p_hold->ui_command, is_timeout ? " (timeout)" : "");
+    }
+}
+
+void cec_key_hold_process(void)
+{
+    for(int i=0; i<16; i++)
+    {
+        cec_key_hold_status_t * p_hold = &cec_key_hold_list[i];
+
+        if(!p_hold->is_pressed)
+        {
+            continue;
+        }
+
+        if(SYSTEM_TICK_IS_REACHED(p_hold->last_pressed_tick + APP_CEC_KEY_RELEASE_TIMEOUT_MS))
+        {
+            /* Follower shall regard the key as released when no repeat arrives */
+            cec_key_hold_release((cec_addr_t)i, true);
+        }
+        else if((p_hold->repeat_count > 0) && SYSTEM_TICK_IS_REACHED(p_hold->ramp_tick))
+        {
+            /* Smooth volume ramp while the volume key is held */
+            if(p_hold->ui_command == USER_CONTROL_VOLUME_UP)
+            {
+                demo_system_volume_adjust(1);
+            }
+            else if(p_hold->ui_command == USER_CONTROL_VOLUME_DOWN)
+            {
+                demo_system_volume_adjust(-1);
+            }
+            p_hold->ramp_tick += APP_CEC_VOLUME_RAMP_INTERVAL_MS;
+        }
+    }
+}
+
+bool hdmi_hpd_debounce(bool * p_level)
+{
+    static bool     hpd_stable_level = false;
+    static bool     hpd_debounce_running = false;
+    static uint32_t hpd_debounce_deadline;
+    bool            level = hdmi_hpd_level_get();
+
+    /* Every edge restarts the debounce time. The level is also polled since the pin may be high already at boot. */
+    if(hdmi_hpd_edge_flag || ((level != hpd_stable_level) && !hpd_debounce_running))
+    {
+        hdmi_hpd_edge_flag = false;
+        hpd_debounce_running = true;
+        hpd_debounce_deadline = system_tick_get() + APP_HDMI_HPD_DEBOUNCE_MS;
+    }
+
+    if(hpd_debounce_running && SYSTEM_TICK_IS_REACHED(hpd_debounce_deadline))
+    {
+        hpd_debounce_running = false;
+        if(level != hpd_stable_level)
+        {
+            hpd_stable_level = level;
+            *p_level = level;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void hdmi_hpd_process(void)
+{
+    static cec_addr_t last_logical_address = CEC_ADDR_UNREGISTERED;
+    static bool       is_connect_pending = false;
+    static uint32_t   connect_retry_tick;
+    static uint32_t   connect_retry_ms;
+    fsp_err_t         fsp_err;
+    bool              level;
+    uint8_t           power_status = cec_bus_device_list[my_logical_address].power_status;
+
+    if(hdmi_hpd_debounce(&level))
+    {
+        if(level)
+        {
+            APP_PRINT("[System] HDMI connected.\r\n");
+
+            /* Handled below, and again later while it fails */
+            is_connect_pending = true;
+            connect_retry_tick = system_tick_get();
+            connect_retry_ms = APP_HDMI_CONNECT_RETRY_MS;
+        }
+        else
+        {
+            is_connect_pending = false;
+            hdmi_disconnect_handle(power_status, &last_logical_address);
+        }
+    }
+
+    if(!is_connect_pending || !SYSTEM_TICK_IS_REACHED(connect_retry_tick))
+    {
+        return;
+    }
+
+    /* Note: EDID read and logical address allocation below block the main loop. */
+    /* EDID is 256 bytes on DDC (about 25 ms at 100 kHz), and the allocation polls each candidate address */
+    /* (about 30 ms each, up to APP_CEC_ALLOCATION_TIMEOUT_MS). Received messages are kept by the RX interrupt */
+    /* meanwhile, but key repeat and the state machines pause. The time is reported below. */
+    uint32_t connect_start_tick = system_tick_get();
+
+#if (APP_HDMI_DDC_PHYSICAL_ADDR_GET == 1)
+    /* The sink may be another one or another input, so physical address is read again */
+    fsp_err = physical_address_get(&my_physical_address[0]);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        APP_PRINT("DDC physical address get failed.\r\n");
+    }
+#else
+    fsp_err = FSP_SUCCESS;
+#endif
+    if(FSP_SUCCESS == fsp_err)
+    {
+        APP_PRINT("My physical address is %x.%x.%x.%x.\r\n", my_physical_address[3], my_physical_address[2], my_physical_address[1], my_physical_address[0]);
+        cec_sad_table_update();
+
+        fsp_err = cec_logical_address_allocate(last_logical_address);
+        if(FSP_SUCCESS != fsp_err)
+        {
+            APP_PRINT("CEC logical address allocation failed.\r\n");
+        }
+    }
+
+    if(FSP_SUCCESS != fsp_err)
+    {
+        /* EDID may not be readable yet, e.g. while the sink boots. The device stays Unregistered until it works. */
+        APP_PRINT("[System] HDMI connection is retried in %d ms.\r\n", connect_retry_ms);
+        connect_retry_tick = system_tick_get() + connect_retry_ms;
+        connect_retry_ms = connect_retry_ms * 2;
+        if(connect_retry_ms > APP_HDMI_CONNECT_RETRY_MAX_MS)
+        {
+            connect_retry_ms = APP_HDMI_CONNECT_RETRY_MAX_MS;
+        }
+        return;
+    }
+
+    is_connect_pending = false;
+    cec_my_device_status_update(power_status);
+    cec_physical_address_report();
+    APP_PRINT("[System] HDMI connection handled in %d ms.\r\n", system_tick_get() - connect_start_tick);
+
+#if (APP_HDMI_SCDC_POLL == 1)
+    scdc_start();
+#endif
+#if (APP_HDMI_DDC_CI == 1)
+    ddc_ci_start();
+#endif
+}
+
+void hdmi_disconnect_handle(uint8_t power_status, cec_addr_t * p_last_logical_address)
+{
+    fsp_err_t fsp_err;
+
+    APP_PRINT("[System] HDMI disconnected.\r\n");
+
+#if (APP_HDMI_SCDC_POLL == 1)
+    scdc_stop();
+#endif
+#if (APP_HDMI_DDC_CI == 1)
+    ddc_ci_stop();
+#endif
+
+    /* ARC is gone with the link */
+    cec_arc_state_set(CEC_ARC_STATE_IDLE);
+
+    /* Without sink, there is no physical address. Release the logical address. */
+    *p_last_logical_address = my_logical_address;
+    cec_bus_device_list[my_logical_address].is_my_device = false;
+    cec_bus_device_list[my_logical_address].is_device_active = false;
+    if(my_secondary_logical_address != CEC_ADDR_UNREGISTERED)
+    {
+        cec_bus_device_list[my_secondary_logical_address].is_my_device = false;
+        cec_bus_device_list[my_secondary_logical_address].is_device_active = false;
+        my_secondary_logical_address = CEC_ADDR_UNREGISTERED;
+    }
+    memset(&my_physical_address[0], 0xF, sizeof(my_physical_address));
+
+    fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_UNREGISTERED);
+    if(FSP_SUCCESS == fsp_err)
+    {
+        my_logical_address = CEC_ADDR_UNREGISTERED;
+        cec_local_address_apply(my_logical_address);
+        cec_bus_device_list[my_logical_address].is_my_device = true;
+        cec_bus_device_list[my_logical_address].power_status = power_status;
+    }
+}
+
+void cec_physical_address_report(void)
+{
+    uint8_t           cec_data[3];
+    cec_device_type_t device_type = convert_logical_address_to_device_type(my_logical_address);
+
+    /* Report Physical Address: [Physical Address] [Device Type] */
+    cec_data[0] = (uint8_t)((my_physical_address[3] << 4) | my_physical_address[2]);
+    cec_data[1] = (uint8_t)((my_physical_address[1] << 4) | my_physical_address[0]);
+    cec_data[2] = (device_type != CEC_DEVICE_TYPE_UNKNOWN) ? (uint8_t)device_type : (uint8_t)APP_CEC_DEVICE_TYPE;
+
+    cec_message_post(CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS, &cec_data[0], 3, NULL);
+
+    if(my_secondary_logical_address != CEC_ADDR_UNREGISTERED)
+    {
+        cec_data[2] = (uint8_t)convert_logical_address_to_device_type(my_secondary_logical_address);
+        cec_message_post_from(my_secondary_logical_address, CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS, &cec_data[0], 3, NULL);
+    }
+}
+
+void cec_my_device_status_update(uint8_t power_status)
+{
+    cec_addr_t my_address_list[2] = {my_logical_address, my_secondary_logical_address};
+
+    for(uint32_t i=0; i<2; i++)
+    {
+        cec_device_status_t * p_device = &cec_bus_device_list[my_address_list[i]];
+        if((i > 0) && (my_address_list[i] == CEC_ADDR_UNREGISTERED))
+        {
+            break;
+        }
+
+        p_device->is_power_status_store = true;
+        p_device->power_status_tick = system_tick_get();
+        p_device->power_status = power_status;
+
+        p_device->is_version_store = true;
+        p_device->version_tick = system_tick_get();
+        p_device->cec_version = CEC_VERSION_1_4;
+
+        p_device->is_physical_address_store = true;
+        p_device->physical_address_tick = system_tick_get();
+        memcpy(&p_device->physical_address[0], &my_physical_address[0], 4);
+
+        p_device->is_vendor_id_store = true;
+        p_device->vendor_id_tick = system_tick_get();
+        memcpy(&p_device->vendor_id[0], &my_vendor_id[0], 3);
+    }
+}
+
+fsp_err_t cec_logical_address_allocate(cec_addr_t preferred_addr)
+{
+    fsp_err_t                               fsp_err = FSP_ERR_IN_USE;
+    cec_logical_address_candidate_t const * p_candidate;
+
+    p_candidate = cec_logical_address_candidate_find(APP_CEC_DEVICE_TYPE);
+    if(NULL == p_candidate)
+    {
+        return FSP_ERR_INVALID_ARGUMENT;
+    }
+
+    /* Re-claim the address used before the reset first, if it is still a candidate of my device type */
+    for(uint32_t i=0; i<p_candidate->candidate_number; i++)
+    {
+        if(p_candidate->candidate[i] == preferred_addr)
+        {
+            fsp_err = cec_logical_address_allocate_attempt(preferred_addr);
+            if(FSP_SUCCESS == fsp_err)
+            {
+                my_logical_address = preferred_addr;
+            }
+            break;
+        }
+    }
+
+    /* Probe candidates in order. The first one no device acknowledges is taken. */
+    for(uint32_t i=0; (FSP_SUCCESS != fsp_err) && (i<p_candidate->candidate_number); i++)
+    {
+        if(p_candidate->candidate[i] == preferred_addr)
+        {
+            continue;
+        }
+
+        fsp_err = cec_logical_address_allocate_attempt(p_candidate->candidate[i]);
+        if(FSP_SUCCESS == fsp_err)
+        {
+            my_logical_address = p_candidate->candidate[i];
+            break;
+        }
+
+        APP_PRINT("Logical address %s is in use by another device.\r\n", cec_logical_device_list[p_candidate->candidate[i]]);
+    }
+
+    if(FSP_SUCCESS != fsp_err)
+    {
+        /* All candidates are taken. The device works as Unregistered. */
+        fsp_err = cec_logical_address_allocate_attempt(CEC_ADDR_UNREGISTERED);
+        if(FSP_SUCCESS != fsp_err)
+        {
+            return fsp_err;
+        }
+        my_logical_address = CEC_ADDR_UNREGISTERED;
+    }
+
+    cec_bus_device_list[my_logical_address].is_device_active = true;
+    cec_bus_device_list[my_logical_address].is_my_device = true;
+    APP_PRINT("Logical address %s has been allocated (%d ms after boot).\r\n", cec_logical_device_list[my_logical_address], system_tick_get());
+
+#if (APP_CEC_SECONDARY_DEVICE_TYPE != CEC_DEVICE_TYPE_UNKNOWN)
+    cec_secondary_logical_address_allocate();
+#endif
+
+    /* Probing left the last polled address in the driver. Acknowledge only my addresses. */
+    cec_local_address_apply(my_logical_address);
+
+    return FSP_SUCCESS;
+}
+
+void cec_secondary_logical_address_allocate(void)
+{
+    fsp_err_t                               fsp_err = FSP_ERR_IN_USE;
+    cec_logical_address_candidate_t const * p_candidate;
+
+    my_secondary_logical_address = CEC_ADDR_UNREGISTERED;
+
+    p_candidate = cec_logical_address_candidate_find(APP_CEC_SECONDARY_DEVICE_TYPE);
+    if(NULL == p_candidate)
+    {
+        return;
+    }
+
+    for(uint32_t i=0; i<p_candidate->candidate_number; i++)
+    {
+        if(p_candidate->candidate[i] == my_logical_address)
+        {
+            continue;
+        }
+
+        fsp_err = cec_logical_address_allocate_attempt(p_candidate->candidate[i]);
+        if(FSP_SUCCESS == fsp_err)
+        {
+            my_secondary_logical_address = p_candidate->candidate[i];
+            break;
+        }
+
+        APP_PRINT("Logical address %s is in use by another device.\r\n", cec_logical_device_list[p_candidate->candidate[i]]);
+    }
+
+    if(my_secondary_logical_address == CEC_ADDR_UNREGISTERED)
+    {
+        /* The last probe was acknowledged by another device. Get ready again without claiming any address. */
+        cec_logical_address_allocate_attempt(CEC_ADDR_UNREGISTERED);
+
+        APP_PRINT("No logical address is left for the secondary device type.\r\n");
+        return;
+    }
+
+    cec_bus_device_list[my_secondary_logical_address].is_device_active = true;
+    cec_bus_device_list[my_secondary_logical_address].is_my_device = true;
+    APP_PRINT("Logical address %s has been allocated as secondary.\r\n", cec_logical_device_list[my_secondary_logical_address]);
+}
+
+bool cec_logical_address_is_mine(cec_addr_t logical_addr)
+{
+    if(logical_addr == my_logical_address)
+    {
+        return true;
+    }
+
+    return (my_secondary_logical_address != CEC_ADDR_UNREGISTERED) && (logical_addr == my_secondary_logical_address);
+}
+
+/*
+ * Acknowledge my primary and secondary logical addresses, and send from the source address.
+ * r_cec supports one local address: R_CEC_MediaInit() writes CADR with the bit of the polled address only,
+ * and stores the address to g_cec0_ctrl.local_address, from which R_CEC_Write() makes the header block.
+ * Both are written here behind the driver, so this depends on the r_cec internals (CADR ownership and the
+ * local_address field of cec_instance_ctrl_t). Call it after every R_CEC_MediaInit() and before R_CEC_Write().
+ */
+void cec_local_address_apply(cec_addr_t source)
+{
+    uint16_t cadr = (uint16_t)((1U << my_logical_address) | (1U << source));
+
+    if(my_secondary_logical_address != CEC_ADDR_UNREGISTERED)
+    {
+        cadr |= (uint16_t)(1U << my_secondary_logical_address);
+    }
+
+    R_CEC->CADR = cadr;
+    g_cec0_ctrl.local_address = source;
+}
+
+fsp_err_t cec_logical_address_allocate_attempt(cec_addr_t logical_addr)
+{
+    fsp_err_t fsp_err = FSP_SUCCESS;
+    cec_status_t cec_status;
+    uint32_t deadline;
+
+    /* R_CEC_MediaInit sends the polling message to the address. The state gets ready when it is not acknowledged. */
+    do{
+        fsp_err = R_CEC_MediaInit(&g_cec0_ctrl, logical_addr);
+    }while(FSP_ERR_IN_USE == fsp_err);
+    if(FSP_SUCCESS != fsp_err){ ERROR_INDICATE_LED_ON; __BKPT(0); }
+
+    /* MediaInit left only the polled address in CADR. My addresses keep being acknowledged during the probe. */
+    cec_local_address_apply(logical_addr);
+
+    /* Wait for local address allocation and CEC bus to be free */
+    deadline = system_tick_get() + APP_CEC_ALLOCATION_TIMEOUT_MS;
+    do{
+        fsp_err = R_CEC_StatusGet(&g_cec0_ctrl, &cec_status);
+        if(SYSTEM_TICK_IS_REACHED(deadline))
+        {
+            break;
+        }
+    }while((FSP_SUCCESS == fsp_err) && (CEC_STATE_READY != cec_status.state));
+
+    if(CEC_STATE_READY != cec_status.state)
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    return FSP_SUCCESS;
+}
+
+void cec_system_audio_mode_support_enabling(void)
+{
+    system_audio_mode_support_function = !system_audio_mode_support_function;
+
+    if(system_audio_mode_support_function)
+    {
+        APP_PRINT("System Audio mode function support enabled.\r\n");
+    }
+    else
+    {
+        /* Terminate System Audio Mode, including the one being requested. Deferred request of TV is not answered. */
+        cec_system_audio_tv_request = CEC_SYSTEM_AUDIO_TV_REQUEST_NONE;
+        if((cec_system_audio_state != CEC_SYSTEM_AUDIO_STATE_IDLE) && (cec_system_audio_state != CEC_SYSTEM_AUDIO_STATE_TERMINATING))
+        {
+            if(FSP_SUCCESS == cec_system_audio_mode_post(CEC_SYSTEM_AUDIO_STATUS_OFF))
+            {
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_TERMINATING);
+            }
+        }
+
+        APP_PRINT("System Audio mode function support disabled.\r\n");
+    }
+}
+
+void cec_system_audio_mode_request(void)
+{
+    bool active_source_find = false;
+
+    /* Enable System Audio mode support */
+    system_audio_mode_support_function = true;
+
+    switch(cec_system_audio_state)
+    {
+        case CEC_SYSTEM_AUDIO_STATE_IDLE:
+        {
+            /* The Active source must be checked to request System Audio mode */
+            for(int i=0; i<12; i++)
+            {
+                if(cec_bus_device_list[i].is_active_source)
+                {
+                    APP_PRINT("Current active source is %s.\r\n", &cec_logical_device_list[i]);
+                    active_source_find = true;
+                    break;
+                }
+            }
+
+            if(!active_source_find)
+            {
+                APP_PRINT("Active source is not found. Try bus scan to get.\r\n");
+                break;
+            }
+
+            /* Disable System Audio mode once. On is sent by cec_system_audio_process() after the TV settles. */
+            if(FSP_SUCCESS == cec_system_audio_mode_post(CEC_SYSTEM_AUDIO_STATUS_OFF))
+            {
+                cec_system_audio_deadline = system_tick_get() + CEC_SYSTEM_AUDIO_RESET_WAIT_MS;
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_RESETTING);
+            }
+            break;
+        }
+        case CEC_SYSTEM_AUDIO_STATE_ON:
+        {
+            if(FSP_SUCCESS == cec_system_audio_mode_post(CEC_SYSTEM_AUDIO_STATUS_OFF))
+            {
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_TERMINATING);
+            }
+            break;
+        }
+        default:
+        {
+            APP_PRINT("System Audio mode is changing. Try again later.\r\n");
+            break;
+        }
+    }
+}
+
+void cec_system_audio_process(void)
+{
+    fsp_err_t fsp_err;
+
+    switch(cec_system_audio_state)
+    {
+        case CEC_SYSTEM_AUDIO_STATE_RESETTING:
+        {
+            if((FSP_ERR_IN_USE == *p_cec_system_audio_tx_result) || !SYSTEM_TICK_IS_REACHED(cec_system_audio_deadline))
+            {
+                break;
+            }
+
+            fsp_err = cec_system_audio_mode_post(CEC_SYSTEM_AUDIO_STATUS_ON);
+            if(FSP_SUCCESS == fsp_err)
+            {
+                APP_PRINT("Sending System Audio On request ...\r\n");
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_REQUESTING);
+            }
+            else if(FSP_ERR_IN_USE != fsp_err)
+            {
+                /* TX queue full is retried in next call */
+                APP_PRINT("System Audio mode request failed.\r\n");
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_IDLE);
+            }
+            break;
+        }
+        case CEC_SYSTEM_AUDIO_STATE_REQUESTING:
+        {
+            if(FSP_SUCCESS == *p_cec_system_audio_tx_result)
+            {
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_ON);
+            }
+            else if(FSP_ERR_IN_USE != *p_cec_system_audio_tx_result)
+            {
+                APP_PRINT("System Audio mode request failed.\r\n");
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_IDLE);
+            }
+            break;
+        }
+        case CEC_SYSTEM_AUDIO_STATE_TERMINATING:
+        {
+            /* Off regardless of the delivery. The TV turns its speakers on when it loses us. */
+            if(FSP_ERR_IN_USE != *p_cec_system_audio_tx_result)
+            {
+                cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_IDLE);
+            }
+            break;
+        }
+        default:
+        {
+            /* Settled. Answer the request of TV deferred during the transition, unless it ended in the requested mode. */
+            if(CEC_SYSTEM_AUDIO_TV_REQUEST_NONE != cec_system_audio_tv_request)
+            {
+                bool is_on = (CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+                if(is_on != (CEC_SYSTEM_AUDIO_STATUS_ON == cec_system_audio_tv_request))
+                {
+                    cec_system_audio_tv_request_answer(cec_system_audio_tv_request);
+                }
+                cec_system_audio_tv_request = CEC_SYSTEM_AUDIO_TV_REQUEST_NONE;
+            }
+            break;
+        }
+    }
+}
+
+void cec_system_audio_state_set(cec_system_audio_state_t state)
+{
+    static char const * const state_name[] = {"Idle", "Resetting", "Requesting", "On", "Terminating"};
+
+    if(state == cec_system_audio_state)
+    {
+        return;
+    }
+
+    APP_PRINT("[System Audio] %s -> %s (%d ms)\r\n", state_name[cec_system_audio_state], state_name[state], system_tick_get());
+    cec_system_audio_state = state;
+    system_audio_mode_status = (CEC_SYSTEM_AUDIO_STATE_ON == state);
+
+    /* ARC is requested right behind Set System Audio Mode On, without waiting for its delivery */
+    if((CEC_SYSTEM_AUDIO_STATE_REQUESTING == state) || (CEC_SYSTEM_AUDIO_STATE_ON == state))
+    {
+        cec_arc_initiate();
+    }
+    else if(CEC_SYSTEM_AUDIO_STATE_TERMINATING == state)
+    {
+        cec_arc_terminate();
+    }
+}
+
+fsp_err_t cec_system_audio_mode_post(uint8_t system_audio_status)
+{
+    fsp_err_t   fsp_err;
+    fsp_err_t * p_result = NULL;
+    uint8_t     cec_data[1] = {system_audio_status};
+
+    /* Result slot not waited by any queued request. All in use is the same as TX queue full. */
+    for(uint32_t i=0; i<CEC_SYSTEM_AUDIO_TX_RESULT_NUMBER; i++)
+    {
+        if(FSP_ERR_IN_USE != cec_system_audio_tx_result_list[i])
+        {
+            p_result = &cec_system_audio_tx_result_list[i];
+            break;
+        }
+    }
+    if(NULL == p_result)
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    /* Result is checked by cec_system_audio_process(). Only the last post moves the state. */
+    *p_result = FSP_ERR_IN_USE;
+    fsp_err = cec_message_post(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1, p_result);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        *p_result = fsp_err;
+        return fsp_err;
+    }
+
+    p_cec_system_audio_tx_result = p_result;
+    return FSP_SUCCESS;
+}
 
-        if(logical_address_allocate)
-        {
-            break;
-        }
+void cec_system_audio_tv_request_answer(uint8_t system_audio_status)
+{
+    fsp_err_t fsp_err = cec_system_audio_mode_post(system_audio_status);
+
+    if(FSP_SUCCESS != fsp_err)
+    {
+        APP_PRINT("System Audio mode request from TV is not answered (TX queue full).\r\n");
+        return;
     }
 
-    if(logical_address_allocate)
+    if(CEC_SYSTEM_AUDIO_STATUS_ON == system_audio_status)
     {
-        cec_bus_device_list[my_logical_address].is_device_active = true;
-        cec_bus_device_list[my_logical_address].is_my_device = true;
-        APP_PRINT("Logical address %s has been allocated.\r\n", cec_logical_device_list[my_logical_address]);
-        return FSP_SUCCESS;
+        /* On when delivered. cec_system_audio_process() follows the result. */
+        cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_REQUESTING);
     }
     else
     {
-        return FSP_ERR_IN_USE;
+        cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_TERMINATING);
     }
 }
 
-fsp_err_t cec_logical_address_allocate_attempt(cec_addr_t logical_addr)
+void cec_arc_initiate(void)
 {
-    fsp_err_t fsp_err = FSP_SUCCESS;
-    cec_status_t cec_status;
-    uint32_t timeout_ms = 100;
+    if((CEC_ARC_STATE_ON == cec_arc_state) || (CEC_ARC_STATE_INITIATING == cec_arc_state) || !cec_arc_available_check())
+    {
+        return;
+    }
 
-    do{
-        fsp_err = R_CEC_MediaInit(&g_cec0_ctrl, logical_addr);
-    }while(FSP_ERR_IN_USE == fsp_err);
-    if(FSP_SUCCESS != fsp_err){ ERROR_INDICATE_LED_ON; __BKPT(0); }
+    cec_arc_retry_count = 0;
+    cec_arc_request_post(CEC_ARC_STATE_INITIATING);
+}
 
-    /* Wait for local address allocation and CEC bus to be free */
-    do{
-        fsp_err = R_CEC_StatusGet(&g_cec0_ctrl, &cec_status);
-        timeout_ms--;
-        if(timeout_ms == 0)
-        {
-            break;
-        }
-        R_BSP_SoftwareDelay(1, BSP_DELAY_UNITS_MILLISECONDS);
-    }while((FSP_SUCCESS == fsp_err) && (CEC_STATE_READY != cec_status.state));
+void cec_arc_terminate(void)
+{
+    if((CEC_ARC_STATE_IDLE == cec_arc_state) || (CEC_ARC_STATE_TERMINATING == cec_arc_state))
+    {
+        return;
+    }
 
-    if(CEC_STATE_READY != cec_status.state)
+    cec_arc_retry_count = 0;
+    cec_arc_request_post(CEC_ARC_STATE_TERMINATING);
+}
+
+void cec_arc_process(void)
+{
+    if(((CEC_ARC_STATE_INITIATING != cec_arc_state) && (CEC_ARC_STATE_TERMINATING != cec_arc_state)) ||
+       (CEC_REPLY_STATE_PENDING == cec_arc_reply_state))
     {
-        return FSP_ERR_IN_USE;
+        return;
     }
 
-    return FSP_SUCCESS;
+    /* Replied case has already moved the state by Report ARC Initiated or Terminated from TV */
+    if(CEC_REPLY_STATE_REJECTED == cec_arc_reply_state)
+    {
+        APP_PRINT("TV refused ARC %s.\r\n", (CEC_ARC_STATE_INITIATING == cec_arc_state) ? "initiation" : "termination");
+        cec_arc_state_set(CEC_ARC_STATE_IDLE);
+    }
+    else if(cec_arc_retry_count < APP_CEC_ARC_RETRY_COUNT)
+    {
+        /* No reply from TV. It may still be starting up. */
+        cec_arc_retry_count++;
+        cec_arc_request_post(cec_arc_state);
+    }
+    else
+    {
+        APP_PRINT("TV did not answer ARC %s.\r\n", (CEC_ARC_STATE_INITIATING == cec_arc_state) ? "initiation" : "termination");
+        cec_arc_state_set(CEC_ARC_STATE_IDLE);
+    }
 }
 
-void cec_system_audio_mode_support_enabling(void)
+void cec_arc_request_post(cec_arc_state_t state)
 {
-    system_audio_mode_support_function = !system_audio_mode_support_function;
+    fsp_err_t fsp_err;
 
-    if(system_audio_mode_support_function)
+    /* Audio System is the ARC Rx device. It starts and stops ARC, and TV (ARC Tx device) reports the result. */
+    if(CEC_ARC_STATE_INITIATING == state)
     {
-        APP_PRINT("System Audio mode function support enabled.\r\n");
+        /* Initiate ARC (0xC0) => Report ARC Initiated (0xC1). TV answers Report ARC Terminated (0xC2) if it cannot. */
+        fsp_err = cec_request_post(CEC_ADDR_TV, CEC_OPCODE_INITIATE_ARC, NULL, 0, CEC_OPCODE_REPORT_ARC_INITIATED, &cec_arc_reply_state);
     }
     else
     {
-        if(system_audio_mode_status)
-        {
-            uint8_t    cec_data[CEC_DATA_BUFFER_LENGTH];
+        /* Terminate ARC (0xC5) => Report ARC Terminated (0xC2) */
+        fsp_err = cec_request_post(CEC_ADDR_TV, CEC_OPCODE_TERMINATE_ARC, NULL, 0, CEC_OPCODE_REPORT_ARC_TERMINATED, &cec_arc_reply_state);
+    }
 
-            cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_OFF;
-            cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
+    if(FSP_SUCCESS == fsp_err)
+    {
+        cec_arc_state_set(state);
+    }
+    else if(FSP_ERR_IN_USE == fsp_err)
+    {
+        /* Queue is full. cec_arc_process() posts again. */
+        cec_arc_reply_state = CEC_REPLY_STATE_NOT_DELIVERED;
+        cec_arc_state_set(state);
+    }
+    else
+    {
+        /* TV is known not to support ARC */
+        cec_arc_state_set(CEC_ARC_STATE_IDLE);
+    }
+}
 
-            APP_PRINT("System Audio mode is disabled.\r\n");
-        }
+void cec_arc_state_set(cec_arc_state_t state)
+{
+    static char const * const state_name[] = {"Idle", "Initiating", "On", "Terminating"};
 
-        APP_PRINT("System Audio mode function support disabled.\r\n");
+    if(state == cec_arc_state)
+    {
+        return;
     }
+
+    APP_PRINT("[ARC] %s -> %s (%d ms)\r\n", state_name[cec_arc_state], state_name[state], system_tick_get());
+
+    /* Settled by a report of TV or by the link. A late reply of the last request must not move the state again. */
+    if((CEC_ARC_STATE_IDLE == state) || (CEC_ARC_STATE_ON == state))
+    {
+        cec_request_cancel(&cec_arc_reply_state);
+        cec_arc_reply_state = CEC_REPLY_STATE_REPLIED;
+    }
+
+    /* Audio input follows the established ARC */
+    if(CEC_ARC_STATE_ON == state)
+    {
+        APP_PRINT("[System] Audio input: TV (ARC).\r\n");
+    }
+    else if(CEC_ARC_STATE_ON == cec_arc_state)
+    {
+        APP_PRINT("[System] Audio input: HDMI.\r\n");
+    }
+
+    cec_arc_state = state;
 }
 
-void cec_system_audio_mode_request(void)
+bool cec_arc_available_check(void)
 {
-    fsp_err_t fsp_err = FSP_SUCCESS;
-    bool       active_source_find = false;
-    uint8_t    cec_data[CEC_DATA_BUFFER_LENGTH];
+    /* ARC is on the HDMI link to the TV. Only the device connected to the TV directly (x.0.0.0) can use it. */
+    return (APP_CEC_ARC == 1) && (my_logical_address == CEC_ADDR_AUDIO_SYSTEM) &&
+           (my_physical_address[3] != 0x0) && (my_physical_address[3] != 0xF) &&
+           (my_physical_address[2] == 0x0) && (my_physical_address[1] == 0x0) && (my_physical_address[0] == 0x0);
+}
 
-    /* Enable System Audio mode support */
-    system_audio_mode_support_function = true;
+bool cec_rx_filter_drop_check(cec_rx_message_buff_t const * p_buff)
+{
+    /* Before allocation the unregistered address is shared with other devices */
+    if(cec_rx_filter.is_self_drop && cec_logical_address_is_mine(p_buff->source) && (p_buff->source != CEC_ADDR_UNREGISTERED))
+    {
+        cec_rx_filter.self_drop_count++;
+        return true;
+    }
 
-    if(system_audio_mode_status == false)
+    if(cec_rx_filter.source_drop_bitmap & (1U << p_buff->source))
     {
-        /* The Active source must be checked to request System Audio mode */
-        for(int i=0; i<12; i++)
-        {
-            if(cec_bus_device_list[i].is_active_source)
-            {
-                APP_PRINT("Current active source is %s.\r\n", &cec_logical_device_list[i]);
-                active_source_find = true;
-                break;
-            }
-        }
+        cec_rx_filter.source_drop_count++;
+        return true;
+    }
 
-        if(active_source_find)
-        {
-            /* Disable System Audio mode once */
-            cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_OFF;
-            cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
+    /* Polling message has no opcode */
+    if((p_buff->byte_counter >= 2) && (cec_rx_filter.opcode_drop_bitmap[p_buff->opcode >> 5] & (1UL << (p_buff->opcode & 0x1F))))
+    {
+        cec_rx_filter.opcode_drop_count++;
+        return true;
+    }
 
-            R_BSP_SoftwareDelay(300, BSP_DELAY_UNITS_MILLISECONDS);
+    return false;
+}
+
+bool cec_rx_duplicate_check(cec_rx_message_buff_t const * p_buff)
+{
+    uint32_t end_time_us  = system_time_us_get();
+    uint8_t  header       = (uint8_t)((p_buff->source << 4) | p_buff->destination);
+    uint32_t operand_hash = 2166136261UL;
+    bool     is_duplicate = false;
+    cec_rx_duplicate_entry_t * p_entry = NULL;
+
+    /* Polling message is not dispatched, so its repetition does no harm */
+    if(p_buff->byte_counter < 2)
+    {
+        return false;
+    }
 
-            APP_PRINT("Sending System Audio On request ...\r\n");
+    /* FNV-1a of operands */
+    for(uint32_t i = 0; i < (uint32_t)(p_buff->byte_counter - 2); i++)
+    {
+        operand_hash = (operand_hash ^ p_buff->data_buff[i]) * 16777619UL;
+    }
 
-            cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_ON;
-            fsp_err = cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
-            if(FSP_SUCCESS == fsp_err)
-            {
-                APP_PRINT("System Audio mode is disabled.\r\n");
-                system_audio_mode_status = true;
-            }
-            else
-            {
-                APP_PRINT("System Audio mode request failed.\r\n");
-                system_audio_mode_status = false;
-            }
+    for(uint32_t i = 0; i < CEC_RX_DUPLICATE_CACHE_NUMBER; i++)
+    {
+        cec_rx_duplicate_entry_t * p_cache = &cec_rx_duplicate_cache[i];
+        if(p_cache->is_valid && (p_cache->header == header) && (p_cache->opcode == p_buff->opcode) &&
+           (p_cache->byte_counter == p_buff->byte_counter) && (p_cache->operand_hash == operand_hash))
+        {
+            /* Retransmission starts after 3 bit periods of signal free time. Key repeat comes far later. */
+            is_duplicate = ((p_buff->start_time_us - p_cache->end_time_us) < (APP_CEC_RX_DUPLICATE_WINDOW_MS * 1000));
+            p_entry = p_cache;
+            break;
         }
-        else
+
+        /* Replace the oldest entry if no match */
+        if((p_entry == NULL) || !p_cache->is_valid ||
+           (p_entry->is_valid && ((end_time_us - p_cache->end_time_us) > (end_time_us - p_entry->end_time_us))))
         {
-            APP_PRINT("Active source is not found. Try bus scan to get.\r\n");
+            p_entry = p_cache;
         }
     }
-    else
-    {
-        cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_OFF;
-        cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
 
-        APP_PRINT("System Audio mode is disabled.\r\n");
+    p_entry->is_valid     = true;
+    p_entry->header       = header;
+    p_entry->opcode       = p_buff->opcode;
+    p_entry->byte_counter = p_buff->byte_counter;
+    p_entry->operand_hash = operand_hash;
+    p_entry->end_time_us  = end_time_us;
 
-        system_audio_mode_status = false;
+    if(is_duplicate)
+    {
+        cec_rx_filter.duplicate_drop_count++;
     }
+    return is_duplicate;
+}
 
+void cec_rx_filter_opcode_set(uint8_t opcode, bool is_drop)
+{
+    if(is_drop)
+    {
+        cec_rx_filter.opcode_drop_bitmap[opcode >> 5] |= (1UL << (opcode & 0x1F));
+    }
+    else
+    {
+        cec_rx_filter.opcode_drop_bitmap[opcode >> 5] &= ~(1UL << (opcode & 0x1F));
+    }
 }
 
 void cec_rx_data_check(void)
@@ -797,10 +2267,24 @@ void cec_rx_data_check(void)
 
         if(p_buff->is_new_data)
         {
-            if(p_buff->is_error == false)
+            bool is_key_repeat = false;
+            if((p_buff->is_error == false) && (p_buff->byte_counter >= 3) &&
+               (p_buff->opcode == CEC_OPCODE_USER_CONTROL_PRESSED) && !cec_logical_address_is_mine(p_buff->source))
+            {
+                /* Repeats of a key held are absorbed by the key hold tracking without any log */
+                is_key_repeat = cec_key_hold_repeat_check(p_buff->source, p_buff->data_buff[0]);
+            }
+
+            if((p_buff->is_error == false) && (is_key_repeat == false))
             {
                 APP_PRINT("[< CEC In]  Src: %d (%s), Dest: %d (%s),\r\n", p_buff->source, &cec_logical_device_list[p_buff->source][0],
                           p_buff->destination, &cec_logical_device_list[p_buff->destination][0]);
+                /* Any frame from the device means it is present */
+                if(p_buff->source != CEC_ADDR_UNREGISTERED)
+                {
+                    cec_bus_device_list[p_buff->source].is_absent = false;
+                }
+
                 if(p_buff->byte_counter >= 2)
                 {
                     uint32_t opcode_list_point = opcode_description_find(p_buff->opcode);
@@ -817,8 +2301,12 @@ void cec_rx_data_check(void)
 
                     APP_PRINT("\r\n");
 
-                    if(p_buff->source != my_logical_address)
+                    /* Truncated frame must not update the device status with stale bytes */
+                    if(cec_rx_operand_length_validate(p_buff) && !cec_logical_address_is_mine(p_buff->source))
                     {
+                        cec_reply_resolve(p_buff);
+                        cec_unsupported_opcode_learn(p_buff);
+
                         switch(p_buff->opcode)
                         {
                             case CEC_OPCODE_IMAGE_VIEW_ON:
@@ -835,6 +2323,8 @@ void cec_rx_data_check(void)
                             }
                             case CEC_OPCODE_USER_CONTROL_PRESSED:
                             {
+                                cec_key_hold_press(p_buff->source, p_buff->data_buff[0]);
+
                                 switch(p_buff->data_buff[0])
                                 {
                                     case USER_CONTROL_VOLUME_UP:
@@ -855,6 +2345,11 @@ void cec_rx_data_check(void)
                                 }
                                 break;
                             }
+                            case CEC_OPCODE_USER_CONTROL_RELEASED:
+                            {
+                                cec_key_hold_release(p_buff->source, false);
+                                break;
+                            }
 //                            case <opcode> ToDo
 //                            {
 //                                /* Add your additional operation */
@@ -868,7 +2363,7 @@ void cec_rx_data_check(void)
                             }
                         }
                     }
-                    else
+                    else if(cec_logical_address_is_mine(p_buff->source))
                     {
                         APP_PRINT("Logical address of received message is same as my logical address. Ignore this message.\r\n");
                     }
@@ -892,19 +2387,65 @@ void cec_rx_data_check(void)
     }
 }
 
+bool cec_rx_operand_length_validate(cec_rx_message_buff_t * p_buff)
+{
+    cec_opcode_define_t const * p_define = &cec_opcode_list[opcode_description_find(p_buff->opcode)];
+    uint8_t  operand_length = (uint8_t)(p_buff->byte_counter - 2);
+    uint8_t  cec_data[2];
+
+    if(operand_length < p_define->operand_min)
+    {
+        APP_PRINT("            Operand is too short (%d < %d). Ignore this message.\r\n", operand_length, p_define->operand_min);
+
+        /* Directed message is answered. Feature Abort itself is never answered to avoid a loop. */
+        if((p_buff->destination != CEC_ADDR_BROADCAST) && !cec_logical_address_is_mine(p_buff->source) &&
+           (p_buff->opcode != CEC_OPCODE_FEATURE_ABORT) && (p_buff->opcode != CEC_OPCODE_ABORT))
+        {
+            cec_data[0] = p_buff->opcode;
+            cec_data[1] = CEC_ABOUT_REASON_INVALID_OPERAND;
+            cec_message_post_from(p_buff->destination, p_buff->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
+        }
+        return false;
+    }
+
+    /* Additional operands are ignored for compatibility with later CEC versions */
+    if(operand_length > p_define->operand_max)
+    {
+        p_buff->byte_counter = (uint8_t)(p_define->operand_max + 2);
+    }
+
+    return true;
+}
+
 void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 {
     fsp_err_t fsp_err = FSP_SUCCESS;
     uint8_t cec_data[CEC_DATA_BUFFER_LENGTH] = {0x0};
 
+    /* Replies are queued, so the RX drain loop never waits for a transmission. A full queue drops the reply. */
+    /* Answer from the address the message was directed to. Broadcast is answered by the primary address. */
+    cec_addr_t my_address = (p_rx_data->destination != CEC_ADDR_BROADCAST) ? p_rx_data->destination : my_logical_address;
+
+    /* Audio features belong to the primary address */
+    if((my_address != my_logical_address) &&
+       ((p_rx_data->opcode == CEC_OPCODE_GIVE_AUDIO_STATUS) || (p_rx_data->opcode == CEC_OPCODE_SYSTEM_AUDIO_MODE_REQUEST) ||
+        (p_rx_data->opcode == CEC_OPCODE_GIVE_SYSTEM_AUDIO_MODE_STATUS) || (p_rx_data->opcode == CEC_OPCODE_REPORT_ARC_INITIATION) ||
+        (p_rx_data->opcode == CEC_OPCODE_REPORT_ARC_TERMINATION) || (p_rx_data->opcode == CEC_OPCODE_REQUEST_SHORT_AUDIO_DESCRIPTOR)))
+    {
+        cec_data[0] = p_rx_data->opcode;
+        cec_data[1] = CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE;
+        cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
+        return;
+    }
+
     switch(p_rx_data->opcode)
     {
         case CEC_OPCODE_GIVE_PHYSICAL_ADDRESS:
         { /* Give Physical Address (0x83) => Report Physical Address */
-            if(cec_bus_device_list[my_logical_address].is_physical_address_store)
+            if(cec_bus_device_list[my_address].is_physical_address_store)
             {
-                cec_data[0] = (uint8_t)((cec_bus_device_list[my_logical_address].physical_address[3] << 4) | cec_bus_device_list[my_logical_address].physical_address[2]);
-                cec_data[1] = (uint8_t)((cec_bus_device_list[my_logical_address].physical_address[1] << 4) | cec_bus_device_list[my_logical_address].physical_address[0]);
+                cec_data[0] = (uint8_t)((cec_bus_device_list[my_address].physical_address[3] << 4) | cec_bus_device_list[my_address].physical_address[2]);
+                cec_data[1] = (uint8_t)((cec_bus_device_list[my_address].physical_address[1] << 4) | cec_bus_device_list[my_address].physical_address[0]);
             }
             else
             {
@@ -912,31 +2453,31 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
                 cec_data[1] = (uint8_t)((my_physical_address[1] << 4) | my_physical_address[0]);
             }
 
-            cec_device_type_t device_type = convert_logical_address_to_device_type(my_logical_address);
+            cec_device_type_t device_type = convert_logical_address_to_device_type(my_address);
             if(device_type != CEC_DEVICE_TYPE_UNKNOWN)
             {
                 cec_data[2] = device_type;
             }
 
-            cec_message_send(CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS, &cec_data[0], 3);
+            cec_message_post_from(my_address, CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS, &cec_data[0], 3, NULL);
 
             break;
         }
         case CEC_OPCODE_GIVE_DEVICE_VENDOR_ID:
         { /* Give Device Vendor ID (0x8C) => Device Vendor ID */
-            if(cec_bus_device_list[my_logical_address].is_vendor_id_store)
+            if(cec_bus_device_list[my_address].is_vendor_id_store)
             {
-                cec_message_send(CEC_ADDR_BROADCAST, CEC_OPCODE_DEVICE_VENDOR_ID, &cec_bus_device_list[my_logical_address].vendor_id[0], 3);
+                cec_message_post_from(my_address, CEC_ADDR_BROADCAST, CEC_OPCODE_DEVICE_VENDOR_ID, &cec_bus_device_list[my_address].vendor_id[0], 3, NULL);
             }
             else
             {
-                cec_message_send(CEC_ADDR_BROADCAST, CEC_OPCODE_DEVICE_VENDOR_ID, &my_vendor_id[0], 3);
+                cec_message_post_from(my_address, CEC_ADDR_BROADCAST, CEC_OPCODE_DEVICE_VENDOR_ID, &my_vendor_id[0], 3, NULL);
             }
             break;
         }
         case CEC_OPCODE_GIVE_OSD_NAME:
         { /* Give OSD Name (0x46) => Set OSD Name */
-            cec_message_send(p_rx_data->source, CEC_OPCODE_SET_OSD_NAME, &my_osd_name[0], MY_OSD_NAME_LENGTH);
+            cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_SET_OSD_NAME, &my_osd_name[0], MY_OSD_NAME_LENGTH, NULL);
             break;
         }
         case CEC_OPCODE_GIVE_POWER_STATUS:
@@ -949,7 +2490,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
             {
                 cec_data[0] = CEC_POWER_STATUS_STANDBY;
             }
-            cec_message_send(p_rx_data->source, CEC_OPCODE_REPORT_POWER_STATUS, &cec_data[0], 1);
+            cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_REPORT_POWER_STATUS, &cec_data[0], 1, NULL);
             break;
         }
         case CEC_OPCODE_GIVE_AUDIO_STATUS:
@@ -960,7 +2501,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 
             cec_data[0] = (uint8_t)((mute << 7) | (volume & 0x7F));
 
-            cec_message_send(p_rx_data->source, CEC_OPCODE_REPORT_AUDIO_STATUS, &cec_data[0], 1);
+            cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_REPORT_AUDIO_STATUS, &cec_data[0], 1, NULL);
             break;
         }
         case CEC_OPCODE_SYSTEM_AUDIO_MODE_REQUEST:
@@ -968,43 +2509,96 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
             if(system_audio_mode_support_function)
             {
                 /* If data field is filled, this means System Audio Mode is requested to be turned On. Otherwise, requested to be off */
-                if(p_rx_data->byte_counter >= 3)
+                uint8_t system_audio_status = (p_rx_data->byte_counter >= 3) ? CEC_SYSTEM_AUDIO_STATUS_ON : CEC_SYSTEM_AUDIO_STATUS_OFF;
+
+                /* Set System Audio Mode of our own transition is still queued. The last request wins when it ends. */
+                if((CEC_SYSTEM_AUDIO_STATE_RESETTING == cec_system_audio_state) || (CEC_SYSTEM_AUDIO_STATE_TERMINATING == cec_system_audio_state))
                 {
-                    cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_ON;
+                    APP_PRINT("System Audio mode is changing. Request from TV is answered later.\r\n");
+                    cec_system_audio_tv_request = system_audio_status;
                 }
                 else
                 {
-                    cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_OFF;
-                }
-
-                fsp_err = cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
-                if(FSP_SUCCESS == fsp_err)
-                {
-                    if(cec_data[0] == CEC_SYSTEM_AUDIO_STATUS_ON)
-                    {
-                        APP_PRINT("System Audio mode is enabled by TV.\r\n");
-                        system_audio_mode_status = true;
-                    }
-                    else
-                    {
-                        APP_PRINT("System Audio mode is disabled by TV.\r\n");
-                        system_audio_mode_status = false;
-                    }
+                    cec_system_audio_tv_request_answer(system_audio_status);
                 }
             }
             else
             {
                 APP_PRINT("Received System Audio mode request. But function is not enabled, so reject it.\r\n");
-                system_audio_mode_status = false;
 
                 cec_data[0] = CEC_SYSTEM_AUDIO_STATUS_OFF;
-                cec_message_send(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1);
+                cec_message_post(CEC_ADDR_TV, CEC_OPCODE_SET_SYSTEM_AUDIO_MODE, &cec_data[0], 1, NULL);
+            }
+            break;
+        }
+#if (APP_CEC_ARC == 1)
+        case CEC_OPCODE_REPORT_ARC_INITIATION:
+        { /* Request ARC Initiation (0xC3) => Initiate ARC (0xC0). TV may send it without our request at power on. */
+            if((p_rx_data->source == CEC_ADDR_TV) && cec_arc_available_check())
+            {
+                /* TV supports ARC after all. An old Feature Abort of Initiate ARC must not refuse it. */
+                cec_unsupported_opcode_forget(CEC_ADDR_TV, CEC_OPCODE_INITIATE_ARC);
+
+                if((CEC_ARC_STATE_INITIATING == cec_arc_state) || (CEC_ARC_STATE_ON == cec_arc_state))
+                {
+                    /* Answered again without a second reply tracker on cec_arc_reply_state. ARC state stays. */
+                    cec_message_post(CEC_ADDR_TV, CEC_OPCODE_INITIATE_ARC, NULL, 0, NULL);
+                }
+                else
+                {
+                    /* cec_arc_process() follows the report of TV */
+                    cec_arc_retry_count = 0;
+                    cec_arc_request_post(CEC_ARC_STATE_INITIATING);
+                }
+            }
+            else
+            {
+                cec_data[0] = p_rx_data->opcode;
+                cec_data[1] = CEC_ABOUT_REASON_NOT_IN_CORRECT_MODE_TO_RESPOND;
+                cec_message_post(p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
+            }
+            break;
+        }
+        case CEC_OPCODE_REPORT_ARC_TERMINATION:
+        { /* Request ARC Termination (0xC4) => Terminate ARC (0xC5) */
+            if(p_rx_data->source == CEC_ADDR_TV)
+            {
+                cec_unsupported_opcode_forget(CEC_ADDR_TV, CEC_OPCODE_TERMINATE_ARC);
+                cec_arc_retry_count = 0;
+                cec_arc_request_post(CEC_ARC_STATE_TERMINATING);
+            }
+            else
+            {
+                cec_data[0] = p_rx_data->opcode;
+                cec_data[1] = CEC_ABOUT_REASON_NOT_IN_CORRECT_MODE_TO_RESPOND;
+                cec_message_post(p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
+            }
+            break;
+        }
+        case CEC_OPCODE_REPORT_ARC_INITIATED:
+        { /* Report ARC Initiated (0xC1) => (ARC state update) */
+            if((p_rx_data->source == CEC_ADDR_TV) && (my_address == my_logical_address) && (CEC_ARC_STATE_INITIATING == cec_arc_state))
+            {
+                cec_arc_state_set(CEC_ARC_STATE_ON);
+            }
+            break;
+        }
+        case CEC_OPCODE_REPORT_ARC_TERMINATED:
+        { /* Report ARC Terminated (0xC2) => (ARC state update). Also the answer of TV which cannot initiate ARC. */
+            if((p_rx_data->source == CEC_ADDR_TV) && (my_address == my_logical_address))
+            {
+                if(CEC_ARC_STATE_INITIATING == cec_arc_state)
+                {
+                    APP_PRINT("TV refused ARC initiation.\r\n");
+                }
+                cec_arc_state_set(CEC_ARC_STATE_IDLE);
             }
             break;
         }
+#endif
         case CEC_OPCODE_GIVE_SYSTEM_AUDIO_MODE_STATUS:
         { /* Give System Audio Mode Status (0x7D) => System Audio Mode Status (0x7E) */
-            if(system_audio_mode_status)
+            if(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state)
             {
                 cec_data[0] = 0x1;
             }
@@ -1013,22 +2607,22 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
                 cec_data[0] = 0x0;
             }
 
-            cec_message_send(p_rx_data->source, CEC_OPCODE_SYSTEM_AUDIO_MODE_STATUS, &cec_data[0], 1);
+            cec_message_post(p_rx_data->source, CEC_OPCODE_SYSTEM_AUDIO_MODE_STATUS, &cec_data[0], 1, NULL);
             break;
         }
         case CEC_OPCODE_SYSTEM_AUDIO_MODE_STATUS:
         { /* System Audio Mode Status (0x7E) => (Internal data update) */
-            if(p_rx_data->byte_counter >= 3)
+            /* Status of another device does not interrupt our own transition */
+            bool is_settled = (CEC_SYSTEM_AUDIO_STATE_IDLE == cec_system_audio_state) || (CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+            if((p_rx_data->byte_counter >= 3) && is_settled)
             {
                 if(p_rx_data->data_buff[0] == 0x1)
                 {
-                    APP_PRINT("System Audio mode is enabled.\r\n");
-                    system_audio_mode_status = true;
+                    cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_ON);
                 }
                 else
                 {
-                    APP_PRINT("System Audio mode is disabled.\r\n");
-                    system_audio_mode_status = false;
+                    cec_system_audio_state_set(CEC_SYSTEM_AUDIO_STATE_IDLE);
                 }
             }
             break;
@@ -1042,6 +2636,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 
                 /* Store to internal buffer */
                 cec_bus_device_list[p_rx_data->source].is_physical_address_store = true;
+                cec_bus_device_list[p_rx_data->source].physical_address_tick = system_tick_get();
                 cec_bus_device_list[p_rx_data->source].physical_address[3] = (uint8_t)(p_rx_data->data_buff[0] >> 4);
                 cec_bus_device_list[p_rx_data->source].physical_address[2] = (uint8_t)(p_rx_data->data_buff[0] & 0x0F);
                 cec_bus_device_list[p_rx_data->source].physical_address[1] = (uint8_t)(p_rx_data->data_buff[1] >> 4);
@@ -1058,6 +2653,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 
                 /* Store to internal buffer */
                 cec_bus_device_list[p_rx_data->source].is_version_store = true;
+                cec_bus_device_list[p_rx_data->source].version_tick = system_tick_get();
                 cec_bus_device_list[p_rx_data->source].cec_version = p_rx_data->data_buff[0];
             }
             break;
@@ -1071,6 +2667,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 
                 /* Store to internal buffer */
                 cec_bus_device_list[p_rx_data->source].is_power_status_store = true;
+                cec_bus_device_list[p_rx_data->source].power_status_tick = system_tick_get();
                 if((p_rx_data->data_buff[0] == CEC_POWER_STATUS_ON) || (p_rx_data->data_buff[0] == CEC_POWER_STATUS_IN_TRANSITION_TO_ON))
                 {
                     cec_bus_device_list[p_rx_data->source].power_status = 0x1;
@@ -1097,6 +2694,36 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
 
                 /* Set a flag for current active source device */
                 cec_bus_device_list[p_rx_data->source].is_active_source = true;
+                cec_bus_device_list[p_rx_data->source].active_source_tick = system_tick_get();
+            }
+            break;
+        }
+        case CEC_OPCODE_REQUEST_SHORT_AUDIO_DESCRIPTOR:
+        { /* Request Short Audio Descriptor (0xA4) => Report Short Audio Descriptor, or Feature Abort if no format is supported */
+            uint8_t const *p_reply;
+            uint8_t        reply_length;
+
+            if(p_rx_data->destination == CEC_ADDR_BROADCAST)
+            {
+                break;
+            }
+
+            /* Table lookup per format code, and the same request is answered by the prebuilt reply */
+            reply_length = cec_sad_reply_get(&cec_sad_table, &p_rx_data->data_buff[0], (uint8_t)(p_rx_data->byte_counter - 2), &p_reply);
+            if(0 != reply_length)
+            {
+                fsp_err = cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_REPORT_SHORT_AUDIO_DESCRIPTOR, p_reply, reply_length, NULL);
+            }
+            else
+            {
+                cec_data[0] = p_rx_data->opcode;
+                cec_data[1] = CEC_ABOUT_REASON_INVALID_OPERAND;
+                fsp_err = cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
+            }
+
+            if(FSP_SUCCESS != fsp_err)
+            {
+                APP_PRINT("Request Short Audio Descriptor is not answered (TX queue full).\r\n");
             }
             break;
         }
@@ -1107,8 +2734,16 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
                 /* Raise device active flag */
                 cec_bus_device_list[p_rx_data->source].is_device_active = true;
 
+                /* Cached Feature Abort belongs to the previous vendor's device */
+                if(cec_bus_device_list[p_rx_data->source].is_vendor_id_store &&
+                   (0 != memcmp(&cec_bus_device_list[p_rx_data->source].vendor_id[0], &p_rx_data->data_buff[0], 3)))
+                {
+                    cec_unsupported_opcode_clear(p_rx_data->source);
+                }
+
                 /* Store to internal buffer */
                 cec_bus_device_list[p_rx_data->source].is_vendor_id_store = true;
+                cec_bus_device_list[p_rx_data->source].vendor_id_tick = system_tick_get();
                 memcpy(&cec_bus_device_list[p_rx_data->source].vendor_id[0], &p_rx_data->data_buff[0], 3);
             }
             break;
@@ -1126,7 +2761,7 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
                 {
                     cec_data[0] = p_rx_data->opcode;
                     cec_data[1] = CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE;
-                    cec_message_send(p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2);
+                    cec_message_post_from(my_address, p_rx_data->source, CEC_OPCODE_FEATURE_ABORT, &cec_data[0], 2, NULL);
                 }
             }
             break;
@@ -1134,59 +2769,130 @@ void cec_system_auto_response(cec_rx_message_buff_t const * p_rx_data)
     }
 }
 
+void cec_sad_table_update(void)
+{
+    uint8_t const *p_sad = &my_short_audio_descriptor[0][0];
+    uint32_t       count = MY_SAD_NUMBER;
+
+#if (APP_CEC_SAD_FROM_EDID == 1)
+    if(FSP_SUCCESS == edid_short_audio_descriptor_get(&p_sad, &count))
+    {
+        APP_PRINT("Audio formats of the sink EDID will be reported (%d SADs).\r\n", count);
+    }
+    else
+    {
+        APP_PRINT("Fixed audio formats will be reported.\r\n");
+    }
+#endif
+
+    cec_sad_table_build(&cec_sad_table, p_sad, count);
+}
+
 void cec_bus_scan(void)
 {
-    /* Request physical address to all devices sequentially */
-    APP_PRINT("Requesting physical address ...\r\n");
-    for(int i=0; i<12; i++)
+    static const struct
     {
-        if(i != my_logical_address)
+        uint8_t      opcode;
+        uint8_t      reply_opcode;
+        char const * p_name;
+    } scan_query_list[] =
+    {
+        {CEC_OPCODE_GIVE_PHYSICAL_ADDRESS,   CEC_OPCODE_REPORT_PHYSICAL_ADDRESS, "physical address"},
+        {CEC_OPCODE_GIVE_DEVICE_VENDOR_ID,   CEC_OPCODE_DEVICE_VENDOR_ID,        "vendor id"},
+        {CEC_OPCODE_GET_CEC_VERSION,         CEC_OPCODE_CEC_VERSION,             "CEC version"},
+        {CEC_OPCODE_GIVE_POWER_STATUS,       CEC_OPCODE_REPORT_POWER_STATUS,     "power status"},
+    };
+    cec_reply_state_t state;
+    uint32_t  query_count = 0;
+    uint32_t  skip_count = 0;
+    uint32_t  timeout_count = 0;
+    bool      active_source_find = false;
+
+    /* Request each status to all devices sequentially. Status learned from bus traffic and still fresh is not requested. */
+    for(uint32_t q=0; q<(sizeof(scan_query_list) / sizeof(scan_query_list[0])); q++)
+    {
+        APP_PRINT("Requesting %s ...\r\n", scan_query_list[q].p_name);
+        for(int i=0; i<12; i++)
         {
-            cec_message_send(i, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS, NULL, 0);
+            if(cec_logical_address_is_mine((cec_addr_t)i))
+            {
+                continue;
+            }
+
+            if(!cec_bus_scan_query_needed(&cec_bus_device_list[i], scan_query_list[q].opcode))
+            {
+                skip_count++;
+                continue;
+            }
 
-            R_BSP_SoftwareDelay(400, BSP_DELAY_UNITS_MILLISECONDS);
+            query_count++;
+            /* Next query starts as soon as the device replies */
+            state = cec_request_send(i, scan_query_list[q].opcode, NULL, 0, scan_query_list[q].reply_opcode);
+            if((CEC_REPLY_STATE_NOT_DELIVERED == state) && (cec_tx_last_error & CEC_ERROR_ACKERR))
+            {
+                /* No device at this address. Following queries to it are skipped. */
+                cec_bus_device_list[i].is_absent = true;
+                cec_bus_device_list[i].absent_tick = system_tick_get();
+            }
+            else if(CEC_REPLY_STATE_TIMEOUT == state)
+            {
+                timeout_count++;
+            }
+            else
+            {
+                /* Replied or rejected */
+            }
         }
     }
 
-    /* Request vendor id to all devices sequentially */
-    APP_PRINT("Requesting vendor id ...\r\n");
+    /* Request Active Source to broadcast */
     for(int i=0; i<12; i++)
     {
-        if(i != my_logical_address)
+        if(cec_bus_device_list[i].is_active_source &&
+           CEC_DEVICE_STATUS_IS_FRESH(true, cec_bus_device_list[i].active_source_tick, CEC_DEVICE_STATUS_TTL_ACTIVE_SOURCE_MS))
         {
-            cec_message_send(i, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID, NULL, 0);
-
-            R_BSP_SoftwareDelay(400, BSP_DELAY_UNITS_MILLISECONDS);
+            active_source_find = true;
         }
     }
 
-    /* Request CEC version to all devices sequentially */
-    APP_PRINT("Requesting CEC version ...\r\n");
-    for(int i=0; i<12; i++)
+    if(active_source_find)
+    {
+        skip_count++;
+    }
+    else
     {
-        if(i != my_logical_address)
+        APP_PRINT("Requesting active source ...\r\n");
+        query_count++;
+        state = cec_request_send(CEC_ADDR_BROADCAST, CEC_OPCODE_REQUEST_ACTIVE_SOURCE, NULL, 0, CEC_OPCODE_ACTIVE_SOURCE);
+        if(CEC_REPLY_STATE_TIMEOUT == state)
         {
-            cec_message_send(i, CEC_OPCODE_GET_CEC_VERSION, NULL, 0);
-
-            R_BSP_SoftwareDelay(400, BSP_DELAY_UNITS_MILLISECONDS);
+            timeout_count++;
         }
     }
 
-    /* Request Power status to all devices sequentially */
-    APP_PRINT("Requesting power status ...\r\n");
-    for(int i=0; i<12; i++)
-    {
-        if(i != my_logical_address)
-        {
-            cec_message_send(i, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0);
+    APP_PRINT("Bus scan sent %d queries, skipped %d by learned status. %d queries got no reply.\r\n", query_count, skip_count, timeout_count);
+}
 
-            R_BSP_SoftwareDelay(400, BSP_DELAY_UNITS_MILLISECONDS);
-        }
+bool cec_bus_scan_query_needed(cec_device_status_t const * p_device, uint8_t opcode)
+{
+    if(p_device->is_absent && CEC_DEVICE_STATUS_IS_FRESH(true, p_device->absent_tick, CEC_DEVICE_STATUS_TTL_ABSENT_MS))
+    {
+        return false;
     }
 
-    /* Request Active Source to broadcast */
-    APP_PRINT("Requesting active source ...\r\n");
-    cec_message_send(CEC_ADDR_BROADCAST, CEC_OPCODE_REQUEST_ACTIVE_SOURCE, NULL, 0);
+    switch(opcode)
+    {
+        case CEC_OPCODE_GIVE_PHYSICAL_ADDRESS:
+            return !CEC_DEVICE_STATUS_IS_FRESH(p_device->is_physical_address_store, p_device->physical_address_tick, CEC_DEVICE_STATUS_TTL_PHYSICAL_ADDRESS_MS);
+        case CEC_OPCODE_GIVE_DEVICE_VENDOR_ID:
+            return !CEC_DEVICE_STATUS_IS_FRESH(p_device->is_vendor_id_store, p_device->vendor_id_tick, CEC_DEVICE_STATUS_TTL_VENDOR_ID_MS);
+        case CEC_OPCODE_GET_CEC_VERSION:
+            return !CEC_DEVICE_STATUS_IS_FRESH(p_device->is_version_store, p_device->version_tick, CEC_DEVICE_STATUS_TTL_VERSION_MS);
+        case CEC_OPCODE_GIVE_POWER_STATUS:
+            return !CEC_DEVICE_STATUS_IS_FRESH(p_device->is_power_status_store, p_device->power_status_tick, CEC_DEVICE_STATUS_TTL_POWER_STATUS_MS);
+        default:
+            return true;
+    }
 }
 
 void cec_bus_status_buffer_display(void)
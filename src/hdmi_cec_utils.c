@@ -64,6 +64,17 @@ uint8_t cec_power_status_list[4][28] =
  "In transition On to Standby",
 };
 
+/* Logical address candidates of each device type. Refer to CEC Table 5 and CEC 10.2.1 in HDMI Specification */
+const cec_logical_address_candidate_t cec_logical_address_candidate_list[] =
+{
+ {CEC_DEVICE_TYPE_TV,               1, {CEC_ADDR_TV}},
+ {CEC_DEVICE_TYPE_RECORDING_DEVICE, 3, {CEC_ADDR_RECORDING_DEVICE_1, CEC_ADDR_RECORDING_DEVICE_2, CEC_ADDR_RECORDING_DEVICE_3}},
+ {CEC_DEVICE_TYPE_TUNER,            4, {CEC_ADDR_TUNER_1, CEC_ADDR_TUNER_2, CEC_ADDR_TUNER_3, CEC_ADDR_TUNER_4}},
+ {CEC_DEVICE_TYPE_PLAYBACK_DEVICE,  3, {CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_PLAYBACK_DEVICE_2, CEC_ADDR_PLAYBACK_DEVICE_3}},
+ {CEC_DEVICE_TYPE_AUDIO_SYSTEM,     1, {CEC_ADDR_AUDIO_SYSTEM}},
+};
+const uint32_t cec_logical_address_candidate_list_number = sizeof(cec_logical_address_candidate_list) / sizeof(cec_logical_address_candidate_t);
+
 /* List of characters of Features. Refer to CEC 3.1 and 3.2 in HDMI Specification */
 cec_feature_define_t cec_feature_list[] =
 {
@@ -94,79 +105,79 @@ uint32_t cec_feature_list_number = sizeof(cec_feature_list) / sizeof(cec_feature
 /* List of characters of Operand Description. Refer to CEC 15 in HDMI Specification */
 cec_opcode_define_t cec_opcode_list[] =
 {
- {.opcode = CEC_OPCODE_FEATURE_ABORT,                  .opcode_desc_str = "Feature Abort",                  .feature_bits = 0xFFFFFFFF},
- {.opcode = CEC_OPCODE_ABORT,                          .opcode_desc_str = "Abort Message",                  .feature_bits = 0xFFFFFFFF},
- {.opcode = CEC_OPCODE_ACTIVE_SOURCE,                  .opcode_desc_str = "Active Source",                  .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY | CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_IMAGE_VIEW_ON,                  .opcode_desc_str = "Image View On",                  .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY},
- {.opcode = CEC_OPCODE_TEXT_VIEW_ON,                   .opcode_desc_str = "Text View On",                   .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY},
- {.opcode = CEC_OPCODE_STANDBY,                        .opcode_desc_str = "Standby",                        .feature_bits = CEC_FEAT_SYSTEM_STANDBY},
- {.opcode = CEC_OPCODE_RECORD_OFF,                     .opcode_desc_str = "Record Off",                     .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
- {.opcode = CEC_OPCODE_RECORD_ON,                      .opcode_desc_str = "Record On",                      .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
- {.opcode = CEC_OPCODE_RECORD_STATUS,                  .opcode_desc_str = "Record Status",                  .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
- {.opcode = CEC_OPCODE_RECORD_TV_SCREEN,               .opcode_desc_str = "Record TV Screen",               .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
- {.opcode = CEC_OPCODE_CLEAR_ANALOG_TIMER,             .opcode_desc_str = "Clear Analogue Timer",           .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_CLEAR_DIGITAL_TIMER,            .opcode_desc_str = "Clear Digital Timer",            .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_CLEAR_EXTERNAL_TIMER,           .opcode_desc_str = "Clear External Timer",           .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_SET_ANALOG_TIMER,               .opcode_desc_str = "Set Analogue Timer",             .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_SET_DIGITAL_TIMER,              .opcode_desc_str = "Set Digital Timer",              .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_SET_EXTERNAL_TIMER,             .opcode_desc_str = "Set External Timer",             .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_SET_TIMER_PROGRAM_TITLE,        .opcode_desc_str = "Set Timer Program Title",        .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_TIMER_CLEARED_STATUS,           .opcode_desc_str = "Timer Cleared Status",           .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_TIMER_STATUS,                   .opcode_desc_str = "Timer Status",                   .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
- {.opcode = CEC_OPCODE_DECK_CONTROL,                   .opcode_desc_str = "Deck Control",                   .feature_bits = CEC_FEAT_DECK_CONTROL},
- {.opcode = CEC_OPCODE_DECK_STATUS,                    .opcode_desc_str = "Deck Status",                    .feature_bits = CEC_FEAT_DECK_CONTROL},
- {.opcode = CEC_OPCODE_GIVE_DECK_STATUS,               .opcode_desc_str = "Give Deck Status",               .feature_bits = CEC_FEAT_DECK_CONTROL},
- {.opcode = CEC_OPCODE_PLAY,                           .opcode_desc_str = "Play",                           .feature_bits = CEC_FEAT_DECK_CONTROL},
- {.opcode = CEC_OPCODE_GIVE_TUNER_STATUS,              .opcode_desc_str = "Give Tuner Status",              .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_SELECT_ANALOG_SERVICE,          .opcode_desc_str = "Select Analogue Service",        .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_SELECT_DIGITAL_SERVICE,         .opcode_desc_str = "Select Digital Service",         .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_TUNER_DEVICE_STATUS,            .opcode_desc_str = "Tuner Device Status",            .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_TUNER_STEP_DECREMENT,           .opcode_desc_str = "Tuner Step Decrement",           .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_TUNER_STEP_INCREMENT,           .opcode_desc_str = "Tuner Step Increment",           .feature_bits = CEC_FEAT_TUNER_CONTROL},
- {.opcode = CEC_OPCODE_MENU_REQUEST,                   .opcode_desc_str = "Menu Request",                   .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL},
- {.opcode = CEC_OPCODE_MENU_STATUS,                    .opcode_desc_str = "Menu Status",                    .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL},
- {.opcode = CEC_OPCODE_USER_CONTROL_PRESSED,           .opcode_desc_str = "User Control Pressed",           .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL | CEC_FEAT_REMOTE_CONTROL_PASS_THROUGH | CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_USER_CONTROL_RELEASED,          .opcode_desc_str = "User Control Released",          .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL | CEC_FEAT_REMOTE_CONTROL_PASS_THROUGH | CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_GIVE_AUDIO_STATUS,              .opcode_desc_str = "Give Audio Status",              .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_GIVE_SYSTEM_AUDIO_MODE_STATUS,  .opcode_desc_str = "Give Audio Mode Status",         .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_AUDIO_STATUS,            .opcode_desc_str = "Report Audio Status",            .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_SHORT_AUDIO_DESCRIPTOR,  .opcode_desc_str = "Report Short Audio Descriptor",  .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_REQUEST_SHORT_AUDIO_DESCRIPTOR, .opcode_desc_str = "Request Short Audio Descriptor", .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_SET_SYSTEM_AUDIO_MODE,          .opcode_desc_str = "Set System Audio Mode",          .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_SYSTEM_AUDIO_MODE_REQUEST,      .opcode_desc_str = "System Audio Mode Request",      .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_SYSTEM_AUDIO_MODE_STATUS,       .opcode_desc_str = "System Audio Mode Status",       .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
- {.opcode = CEC_OPCODE_GIVE_OSD_NAME,                  .opcode_desc_str = "Give OSD Name",                  .feature_bits = CEC_FEAT_DEVICE_OSD_NAME_TRANS},
- {.opcode = CEC_OPCODE_SET_OSD_NAME,                   .opcode_desc_str = "Set OSD Name",                   .feature_bits = CEC_FEAT_DEVICE_OSD_NAME_TRANS},
- {.opcode = CEC_OPCODE_GIVE_POWER_STATUS,              .opcode_desc_str = "Give Power Status",              .feature_bits = CEC_FEAT_DEVICE_POWER_STATUS},
- {.opcode = CEC_OPCODE_REPORT_POWER_STATUS,            .opcode_desc_str = "Report Power Status",            .feature_bits = CEC_FEAT_DEVICE_POWER_STATUS},
- {.opcode = CEC_OPCODE_SET_OSD_STRING,                 .opcode_desc_str = "Set OSD String",                 .feature_bits = CEC_FEAT_OSD_DISPLAY},
- {.opcode = CEC_OPCODE_INACTIVE_SOURCE,                .opcode_desc_str = "Inactive Source",                .feature_bits = CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_REQUEST_ACTIVE_SOURCE,          .opcode_desc_str = "Request Active Source",          .feature_bits = CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_ROUTING_CHANGE,                 .opcode_desc_str = "Routing Change",                 .feature_bits = CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_ROUTING_INFORMATION,            .opcode_desc_str = "Routing Information",            .feature_bits = CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_SET_STREAM_PATH,                .opcode_desc_str = "Set Stream Path",                .feature_bits = CEC_FEAT_ROUTING_CONTROL},
- {.opcode = CEC_OPCODE_CEC_VERSION,                    .opcode_desc_str = "CEC Version",                    .feature_bits = CEC_FEAT_SYSTEM_INFO | CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_GET_CEC_VERSION,                .opcode_desc_str = "Get CEC Version",                .feature_bits = CEC_FEAT_SYSTEM_INFO | CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_GIVE_PHYSICAL_ADDRESS,          .opcode_desc_str = "Give Physical Address",          .feature_bits = CEC_FEAT_SYSTEM_INFO},
- {.opcode = CEC_OPCODE_GET_MENU_LANGUAGE,              .opcode_desc_str = "Get Menu Language",              .feature_bits = CEC_FEAT_SYSTEM_INFO},
- {.opcode = CEC_OPCODE_REPORT_PHYSICAL_ADDRESS,        .opcode_desc_str = "Report Physical Address",        .feature_bits = CEC_FEAT_SYSTEM_INFO},
- {.opcode = CEC_OPCODE_SET_MENU_LANGUAGE,              .opcode_desc_str = "Set Menu Language",              .feature_bits = CEC_FEAT_SYSTEM_INFO},
- {.opcode = CEC_OPCODE_DEVICE_VENDOR_ID,               .opcode_desc_str = "Device Vendor ID",               .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_GIVE_DEVICE_VENDOR_ID,          .opcode_desc_str = "Give Device Vendor ID",          .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_VENDOR_COMMAND,                 .opcode_desc_str = "Vendor Command",                 .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_VENDOR_COMMNAD_W_ID,            .opcode_desc_str = "Vendor Command w/ ID",           .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_VENDOR_REMOTE_BUTTON_DOWN,      .opcode_desc_str = "Vendor Remote Button Down",      .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_VENDOR_REMOTE_BUTTON_UP,        .opcode_desc_str = "Vendor Remote Button Up",        .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
- {.opcode = CEC_OPCODE_SET_AUDIO_RATE,                 .opcode_desc_str = "Set Audio Rate",                 .feature_bits = CEC_FEAT_AUDIO_RATE_CONTROL},
- {.opcode = CEC_OPCODE_INITIATE_ARC,                   .opcode_desc_str = "Initiate ARC",                   .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_ARC_INITIATED,           .opcode_desc_str = "Report ARC Initiated",           .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_ARC_TERMINATED,          .opcode_desc_str = "Report ARC Terminated",          .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_ARC_INITIATION,          .opcode_desc_str = "Report ARC Initiation",          .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_REPORT_ARC_TERMINATION,         .opcode_desc_str = "Report ARC Termination",         .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_TERMINATE_ARC,                  .opcode_desc_str = "Terminate ARC",                  .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
- {.opcode = CEC_OPCODE_CDC_MESSAGE,                    .opcode_desc_str = "CDC Message",                    .feature_bits = CEC_FEAT_CAPABILITY_DISCOVERY_AND_CONTROL},
-
- {.opcode = CEC_OPCODE_UNKNOWN,                        .opcode_desc_str = "Unknown Opcode",                 .feature_bits = 0xFFFFFFFF},
+ {.opcode = CEC_OPCODE_FEATURE_ABORT,                  .opcode_desc_str = "Feature Abort",                  .operand_min =  2, .operand_max =  2, .feature_bits = 0xFFFFFFFF},
+ {.opcode = CEC_OPCODE_ABORT,                          .opcode_desc_str = "Abort Message",                  .operand_min =  0, .operand_max =  0, .feature_bits = 0xFFFFFFFF},
+ {.opcode = CEC_OPCODE_ACTIVE_SOURCE,                  .opcode_desc_str = "Active Source",                  .operand_min =  2, .operand_max =  2, .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY | CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_IMAGE_VIEW_ON,                  .opcode_desc_str = "Image View On",                  .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY},
+ {.opcode = CEC_OPCODE_TEXT_VIEW_ON,                   .opcode_desc_str = "Text View On",                   .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_ONE_TOUCH_PLAY},
+ {.opcode = CEC_OPCODE_STANDBY,                        .opcode_desc_str = "Standby",                        .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_STANDBY},
+ {.opcode = CEC_OPCODE_RECORD_OFF,                     .opcode_desc_str = "Record Off",                     .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
+ {.opcode = CEC_OPCODE_RECORD_ON,                      .opcode_desc_str = "Record On",                      .operand_min =  1, .operand_max =  8, .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
+ {.opcode = CEC_OPCODE_RECORD_STATUS,                  .opcode_desc_str = "Record Status",                  .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
+ {.opcode = CEC_OPCODE_RECORD_TV_SCREEN,               .opcode_desc_str = "Record TV Screen",               .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_ONE_TOUCH_RECORD},
+ {.opcode = CEC_OPCODE_CLEAR_ANALOG_TIMER,             .opcode_desc_str = "Clear Analogue Timer",           .operand_min = 11, .operand_max = 11, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_CLEAR_DIGITAL_TIMER,            .opcode_desc_str = "Clear Digital Timer",            .operand_min = 14, .operand_max = 14, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_CLEAR_EXTERNAL_TIMER,           .opcode_desc_str = "Clear External Timer",           .operand_min =  9, .operand_max = 10, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_SET_ANALOG_TIMER,               .opcode_desc_str = "Set Analogue Timer",             .operand_min = 11, .operand_max = 11, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_SET_DIGITAL_TIMER,              .opcode_desc_str = "Set Digital Timer",              .operand_min = 14, .operand_max = 14, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_SET_EXTERNAL_TIMER,             .opcode_desc_str = "Set External Timer",             .operand_min =  9, .operand_max = 10, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_SET_TIMER_PROGRAM_TITLE,        .opcode_desc_str = "Set Timer Program Title",        .operand_min =  1, .operand_max = 14, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_TIMER_CLEARED_STATUS,           .opcode_desc_str = "Timer Cleared Status",           .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_TIMER_STATUS,                   .opcode_desc_str = "Timer Status",                   .operand_min =  1, .operand_max =  3, .feature_bits = CEC_FEAT_TIMER_PROGRAMMING},
+ {.opcode = CEC_OPCODE_DECK_CONTROL,                   .opcode_desc_str = "Deck Control",                   .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DECK_CONTROL},
+ {.opcode = CEC_OPCODE_DECK_STATUS,                    .opcode_desc_str = "Deck Status",                    .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DECK_CONTROL},
+ {.opcode = CEC_OPCODE_GIVE_DECK_STATUS,               .opcode_desc_str = "Give Deck Status",               .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DECK_CONTROL},
+ {.opcode = CEC_OPCODE_PLAY,                           .opcode_desc_str = "Play",                           .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DECK_CONTROL},
+ {.opcode = CEC_OPCODE_GIVE_TUNER_STATUS,              .opcode_desc_str = "Give Tuner Status",              .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_SELECT_ANALOG_SERVICE,          .opcode_desc_str = "Select Analogue Service",        .operand_min =  4, .operand_max =  4, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_SELECT_DIGITAL_SERVICE,         .opcode_desc_str = "Select Digital Service",         .operand_min =  7, .operand_max =  7, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_TUNER_DEVICE_STATUS,            .opcode_desc_str = "Tuner Device Status",            .operand_min =  5, .operand_max =  8, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_TUNER_STEP_DECREMENT,           .opcode_desc_str = "Tuner Step Decrement",           .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_TUNER_STEP_INCREMENT,           .opcode_desc_str = "Tuner Step Increment",           .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_TUNER_CONTROL},
+ {.opcode = CEC_OPCODE_MENU_REQUEST,                   .opcode_desc_str = "Menu Request",                   .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL},
+ {.opcode = CEC_OPCODE_MENU_STATUS,                    .opcode_desc_str = "Menu Status",                    .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL},
+ {.opcode = CEC_OPCODE_USER_CONTROL_PRESSED,           .opcode_desc_str = "User Control Pressed",           .operand_min =  1, .operand_max = 14, .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL | CEC_FEAT_REMOTE_CONTROL_PASS_THROUGH | CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_USER_CONTROL_RELEASED,          .opcode_desc_str = "User Control Released",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_DEVICE_MENU_CONTROL | CEC_FEAT_REMOTE_CONTROL_PASS_THROUGH | CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_GIVE_AUDIO_STATUS,              .opcode_desc_str = "Give Audio Status",              .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_GIVE_SYSTEM_AUDIO_MODE_STATUS,  .opcode_desc_str = "Give Audio Mode Status",         .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_AUDIO_STATUS,            .opcode_desc_str = "Report Audio Status",            .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_SHORT_AUDIO_DESCRIPTOR,  .opcode_desc_str = "Report Short Audio Descriptor",  .operand_min =  3, .operand_max = 12, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_REQUEST_SHORT_AUDIO_DESCRIPTOR, .opcode_desc_str = "Request Short Audio Descriptor", .operand_min =  1, .operand_max =  4, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_SET_SYSTEM_AUDIO_MODE,          .opcode_desc_str = "Set System Audio Mode",          .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_SYSTEM_AUDIO_MODE_REQUEST,      .opcode_desc_str = "System Audio Mode Request",      .operand_min =  0, .operand_max =  2, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_SYSTEM_AUDIO_MODE_STATUS,       .opcode_desc_str = "System Audio Mode Status",       .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_SYSTEM_AUDIO_CONTROL},
+ {.opcode = CEC_OPCODE_GIVE_OSD_NAME,                  .opcode_desc_str = "Give OSD Name",                  .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_DEVICE_OSD_NAME_TRANS},
+ {.opcode = CEC_OPCODE_SET_OSD_NAME,                   .opcode_desc_str = "Set OSD Name",                   .operand_min =  1, .operand_max = 14, .feature_bits = CEC_FEAT_DEVICE_OSD_NAME_TRANS},
+ {.opcode = CEC_OPCODE_GIVE_POWER_STATUS,              .opcode_desc_str = "Give Power Status",              .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_DEVICE_POWER_STATUS},
+ {.opcode = CEC_OPCODE_REPORT_POWER_STATUS,            .opcode_desc_str = "Report Power Status",            .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_DEVICE_POWER_STATUS},
+ {.opcode = CEC_OPCODE_SET_OSD_STRING,                 .opcode_desc_str = "Set OSD String",                 .operand_min =  2, .operand_max = 14, .feature_bits = CEC_FEAT_OSD_DISPLAY},
+ {.opcode = CEC_OPCODE_INACTIVE_SOURCE,                .opcode_desc_str = "Inactive Source",                .operand_min =  2, .operand_max =  2, .feature_bits = CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_REQUEST_ACTIVE_SOURCE,          .opcode_desc_str = "Request Active Source",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_ROUTING_CHANGE,                 .opcode_desc_str = "Routing Change",                 .operand_min =  4, .operand_max =  4, .feature_bits = CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_ROUTING_INFORMATION,            .opcode_desc_str = "Routing Information",            .operand_min =  2, .operand_max =  2, .feature_bits = CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_SET_STREAM_PATH,                .opcode_desc_str = "Set Stream Path",                .operand_min =  2, .operand_max =  2, .feature_bits = CEC_FEAT_ROUTING_CONTROL},
+ {.opcode = CEC_OPCODE_CEC_VERSION,                    .opcode_desc_str = "CEC Version",                    .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_SYSTEM_INFO | CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_GET_CEC_VERSION,                .opcode_desc_str = "Get CEC Version",                .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_INFO | CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_GIVE_PHYSICAL_ADDRESS,          .opcode_desc_str = "Give Physical Address",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_INFO},
+ {.opcode = CEC_OPCODE_GET_MENU_LANGUAGE,              .opcode_desc_str = "Get Menu Language",              .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_SYSTEM_INFO},
+ {.opcode = CEC_OPCODE_REPORT_PHYSICAL_ADDRESS,        .opcode_desc_str = "Report Physical Address",        .operand_min =  3, .operand_max =  3, .feature_bits = CEC_FEAT_SYSTEM_INFO},
+ {.opcode = CEC_OPCODE_SET_MENU_LANGUAGE,              .opcode_desc_str = "Set Menu Language",              .operand_min =  3, .operand_max =  3, .feature_bits = CEC_FEAT_SYSTEM_INFO},
+ {.opcode = CEC_OPCODE_DEVICE_VENDOR_ID,               .opcode_desc_str = "Device Vendor ID",               .operand_min =  3, .operand_max =  3, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_GIVE_DEVICE_VENDOR_ID,          .opcode_desc_str = "Give Device Vendor ID",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_VENDOR_COMMAND,                 .opcode_desc_str = "Vendor Command",                 .operand_min =  0, .operand_max = 14, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_VENDOR_COMMNAD_W_ID,            .opcode_desc_str = "Vendor Command w/ ID",           .operand_min =  3, .operand_max = 14, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_VENDOR_REMOTE_BUTTON_DOWN,      .opcode_desc_str = "Vendor Remote Button Down",      .operand_min =  0, .operand_max = 14, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_VENDOR_REMOTE_BUTTON_UP,        .opcode_desc_str = "Vendor Remote Button Up",        .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_VENDOR_SPECIFIC},
+ {.opcode = CEC_OPCODE_SET_AUDIO_RATE,                 .opcode_desc_str = "Set Audio Rate",                 .operand_min =  1, .operand_max =  1, .feature_bits = CEC_FEAT_AUDIO_RATE_CONTROL},
+ {.opcode = CEC_OPCODE_INITIATE_ARC,                   .opcode_desc_str = "Initiate ARC",                   .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_ARC_INITIATED,           .opcode_desc_str = "Report ARC Initiated",           .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_ARC_TERMINATED,          .opcode_desc_str = "Report ARC Terminated",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_ARC_INITIATION,          .opcode_desc_str = "Report ARC Initiation",          .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_REPORT_ARC_TERMINATION,         .opcode_desc_str = "Report ARC Termination",         .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_TERMINATE_ARC,                  .opcode_desc_str = "Terminate ARC",                  .operand_min =  0, .operand_max =  0, .feature_bits = CEC_FEAT_AUDIO_RETURN_CHANNEL_CONTROL},
+ {.opcode = CEC_OPCODE_CDC_MESSAGE,                    .opcode_desc_str = "CDC Message",                    .operand_min =  3, .operand_max = 14, .feature_bits = CEC_FEAT_CAPABILITY_DISCOVERY_AND_CONTROL},
+
+ {.opcode = CEC_OPCODE_UNKNOWN,                        .opcode_desc_str = "Unknown Opcode",                 .operand_min =  0, .operand_max = 14, .feature_bits = 0xFFFFFFFF},
 };
 
 uint32_t cec_opcode_list_number = sizeof(cec_opcode_list) / sizeof(cec_opcode_define_t);
@@ -219,3 +230,145 @@ cec_device_type_t convert_logical_address_to_device_type(cec_addr_t addr)
 
     return device_type;
 }
+
+cec_logical_address_candidate_t const * cec_logical_address_candidate_find(cec_device_type_t device_type)
+{
+    for(uint32_t i=0; i<cec_logical_address_candidate_list_number; i++)
+    {
+        if(cec_logical_address_candidate_list[i].device_type == device_type)
+        {
+            return &cec_logical_address_candidate_list[i];
+        }
+    }
+
+    return NULL;
+}
+
+cec_tx_retry_class_t cec_tx_retry_class_get(cec_error_t error)
+{
+    /* Underrun and bus lock errors mean the line or the peripheral is in trouble, retrying does not help */
+    if(error & (CEC_ERROR_UERR | CEC_ERROR_BLERR))
+    {
+        return CEC_TX_RETRY_CLASS_NONE;
+    }
+
+    if(error & CEC_ERROR_AERR)
+    {
+        return CEC_TX_RETRY_CLASS_ARBITRATION_LOST;
+    }
+    else if(error & CEC_ERROR_ACKERR)
+    {
+        return CEC_TX_RETRY_CLASS_NACK;
+    }
+    else if(error & CEC_ERROR_TXERR)
+    {
+        return CEC_TX_RETRY_CLASS_TX_ERROR;
+    }
+
+    return CEC_TX_RETRY_CLASS_NONE;
+}
+
+uint32_t cec_tx_retry_signal_free_time_us_get(cec_tx_retry_class_t retry_class)
+{
+    uint32_t bit_periods;
+
+    switch(retry_class)
+    {
+        case CEC_TX_RETRY_CLASS_ARBITRATION_LOST:
+            /* The winner is now the present initiator, so we wait as a new initiator */
+            bit_periods = CEC_SIGNAL_FREE_TIME_NEW_INITIATOR;
+            break;
+        case CEC_TX_RETRY_CLASS_NACK:
+        case CEC_TX_RETRY_CLASS_TX_ERROR:
+            bit_periods = CEC_SIGNAL_FREE_TIME_RETRANSMISSION;
+            break;
+        default:
+            bit_periods = CEC_SIGNAL_FREE_TIME_NEXT_FRAME;
+            break;
+    }
+
+    return bit_periods * CEC_NOMINAL_BIT_PERIOD_US;
+}
+
+void cec_sad_table_build(cec_sad_table_t * p_table, uint8_t const * p_sad, uint32_t count)
+{
+    uint8_t *p_entry;
+
+    for(uint32_t id = 0; id < CEC_SAD_FORMAT_ID_NUMBER; id++)
+    {
+        for(uint32_t code = 0; code < CEC_SAD_FORMAT_CODE_NUMBER; code++)
+        {
+            p_entry = &p_table->descriptor[id][code][0];
+            p_entry[0] = 0;
+            p_entry[1] = 0;
+            p_entry[2] = 0;
+        }
+    }
+    p_table->request_length = 0;
+
+    for(uint32_t i = 0; i < count; i++, p_sad += CEC_SAD_LENGTH)
+    {
+        uint8_t format_code = (p_sad[0] >> 3) & 0x0F;
+
+        if(0 == format_code)
+        {
+            continue; /* Reserved */
+        }
+        else if(CEC_SAD_FORMAT_CODE_EXTENDED == format_code)
+        {
+            /* Audio Format ID 1 requests the extension type code */
+            p_entry = &p_table->descriptor[1][p_sad[2] >> 3][0];
+        }
+        else
+        {
+            p_entry = &p_table->descriptor[0][format_code][0];
+        }
+
+        /* First descriptor of a format is reported */
+        if(0 == p_entry[0])
+        {
+            p_entry[0] = p_sad[0];
+            p_entry[1] = p_sad[1];
+            p_entry[2] = p_sad[2];
+        }
+    }
+}
+
+uint8_t cec_sad_reply_get(cec_sad_table_t * p_table, uint8_t const * p_request, uint8_t request_length, uint8_t const ** pp_reply)
+{
+    bool is_same_request;
+
+    if(request_length > CEC_SAD_REQUEST_MAX)
+    {
+        request_length = CEC_SAD_REQUEST_MAX;
+    }
+
+    /* TV repeats the same request after every System Audio Mode change, so the last reply is kept */
+    is_same_request = (request_length == p_table->request_length);
+    for(uint8_t i = 0; is_same_request && (i < request_length); i++)
+    {
+        is_same_request = (p_request[i] == p_table->request[i]);
+    }
+
+    if(!is_same_request)
+    {
+        p_table->reply_length = 0;
+        for(uint8_t i = 0; i < request_length; i++)
+        {
+            uint8_t const *p_entry = &p_table->descriptor[(p_request[i] >> 6) & 0x01][p_request[i] & 0x3F][0];
+
+            /* Audio Format ID 2 and 3 are reserved */
+            if(((p_request[i] >> 6) < CEC_SAD_FORMAT_ID_NUMBER) && (0 != p_entry[0]))
+            {
+                p_table->reply[p_table->reply_length++] = p_entry[0];
+                p_table->reply[p_table->reply_length++] = p_entry[1];
+                p_table->reply[p_table->reply_length++] = p_entry[2];
+            }
+            p_table->request[i] = p_request[i];
+        }
+        p_table->request_length = request_length;
+    }
+
+    *pp_reply = &p_table->reply[0];
+    return p_table->reply_length;
+}
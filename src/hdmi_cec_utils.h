@@ -260,6 +260,50 @@ typedef enum cec_system_audio_status
     CEC_SYSTEM_AUDIO_STATUS_ON  = 0x01,
 }cec_system_audio_status_T;
 
+/* Signal free time in nominal bit periods. Refer to CEC 9.1 in HDMI Specification */
+#define CEC_NOMINAL_BIT_PERIOD_US               (2400)
+#define CEC_SIGNAL_FREE_TIME_RETRANSMISSION     (3) // Previous attempt was unsuccessful
+#define CEC_SIGNAL_FREE_TIME_NEW_INITIATOR      (5) // New initiator wants to send a frame
+#define CEC_SIGNAL_FREE_TIME_NEXT_FRAME         (7) // Present initiator wants to send another frame
+
+/* Maximum number of retransmissions of a frame. Refer to CEC 7.6 in HDMI Specification */
+#define CEC_TX_RETRANSMISSION_MAX               (5)
+
+/* Retry class of a failed transmission */
+typedef enum e_cec_tx_retry_class
+{
+    CEC_TX_RETRY_CLASS_NONE             = 0, // Not retried
+    CEC_TX_RETRY_CLASS_ARBITRATION_LOST = 1, // Another initiator won the bus
+    CEC_TX_RETRY_CLASS_NACK             = 2, // Follower did not acknowledge the frame
+    CEC_TX_RETRY_CLASS_TX_ERROR         = 3, // Driven bit was not seen on the line
+}cec_tx_retry_class_t;
+
+/* Short Audio Descriptor. Refer to CEC 17 in HDMI Specification and 7.5.2 in CTA-861 */
+#define CEC_SAD_LENGTH                          (3) // Same as SAD of EDID Audio Data Block
+#define CEC_SAD_REQUEST_MAX                     (4) // [Audio Format ID and Code] operands of Request Short Audio Descriptor
+#define CEC_SAD_FORMAT_ID_NUMBER                (2) // 0: [Audio Format Code], 1: Audio Format Extension Type Code
+#define CEC_SAD_FORMAT_CODE_NUMBER              (64)
+#define CEC_SAD_FORMAT_CODE_EXTENDED            (15) // [Audio Format Code] of which type is in the extension type code
+
+/* Supported SADs indexed by [Audio Format ID and Code], with the last reply prebuilt */
+typedef struct cec_sad_table
+{
+    uint8_t descriptor[CEC_SAD_FORMAT_ID_NUMBER][CEC_SAD_FORMAT_CODE_NUMBER][CEC_SAD_LENGTH]; ///< All 0: not supported
+    uint8_t request[CEC_SAD_REQUEST_MAX];                      ///< Operands of the last request
+    uint8_t request_length;                                    ///< 0: No reply is prebuilt
+    uint8_t reply[CEC_SAD_REQUEST_MAX * CEC_SAD_LENGTH];       ///< Operands of Report Short Audio Descriptor
+    uint8_t reply_length;                                      ///< 0: None of the requested formats is supported
+} cec_sad_table_t;
+
+/* Logical addresses a device type may take, in order of preference. Refer to CEC Table 5 in HDMI Specification */
+#define CEC_LOGICAL_ADDRESS_CANDIDATE_MAX       (4)
+typedef struct cec_logical_address_candidate
+{
+    cec_device_type_t device_type;
+    uint8_t           candidate_number;
+    cec_addr_t        candidate[CEC_LOGICAL_ADDRESS_CANDIDATE_MAX];
+} cec_logical_address_candidate_t;
+
 typedef struct cec_feature_type_define
 {
     cec_feature_t feature;
@@ -270,6 +314,8 @@ typedef struct cec_message_type
 {
     cec_opcode_t opcode;
     uint8_t      opcode_desc_str[35];
+    uint8_t      operand_min;  ///< Operand bytes after the opcode. Shorter frame is invalid
+    uint8_t      operand_max;  ///< Operands beyond this are ignored (reserved for future extension)
     uint32_t     feature_bits;
 } cec_opcode_define_t;
 
@@ -289,7 +335,15 @@ extern uint32_t             cec_feature_list_number;
 extern cec_opcode_define_t cec_opcode_list[];
 extern uint32_t            cec_opcode_list_number;
 
+extern const cec_logical_address_candidate_t cec_logical_address_candidate_list[];
+extern const uint32_t                        cec_logical_address_candidate_list_number;
+
 uint32_t opcode_description_find(uint8_t opcode);
 cec_device_type_t convert_logical_address_to_device_type(cec_addr_t addr);
+cec_logical_address_candidate_t const * cec_logical_address_candidate_find(cec_device_type_t device_type);
+cec_tx_retry_class_t cec_tx_retry_class_get(cec_error_t error);
+uint32_t cec_tx_retry_signal_free_time_us_get(cec_tx_retry_class_t retry_class);
+void cec_sad_table_build(cec_sad_table_t * p_table, uint8_t const * p_sad, uint32_t count);
+uint8_t cec_sad_reply_get(cec_sad_table_t * p_table, uint8_t const * p_request, uint8_t request_length, uint8_t const ** pp_reply);
 
 #endif /* End of __CEC_HDMI_UTILS_H__ */
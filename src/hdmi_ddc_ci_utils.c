@@ -0,0 +1,437 @@
+/***********************************************************************************************************************
+ * File Name    : hdmi_ddc_ci_utils.c
+ * Description  : Contains data structures and functions used in hdmi_ddc_ci_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include "hdmi_ddc_ci_utils.h"
+#include "hdmi_ddc_utils.h"
+#include "application_utils.h"
+#include "rtt_common_utils.h"
+
+///############# Application Option Setting #############
+#define DDC_CI_REPLY_DELAY_MS        (40) // Wait from a request to reading its reply
+#define DDC_CI_MESSAGE_INTERVAL_MS   (50) // Wait from a message to the next one
+#define DDC_CI_RETRY_COUNT           (2)  // Retries after a failed write, or a broken or null reply
+#define DDC_CI_REQUEST_QUEUE_SIZE    (8)
+///########## End of Application Option Setting #########
+
+typedef enum ddc_ci_request_type
+{
+    DDC_CI_REQUEST_VCP_GET,
+    DDC_CI_REQUEST_VCP_SET,
+} ddc_ci_request_type_t;
+
+typedef struct ddc_ci_request
+{
+    ddc_ci_request_type_t   type;
+    uint8_t                 code;
+    uint16_t                value;       /* Set value */
+    uint8_t                 volume;      /* System volume the set value is scaled from. Audio only. */
+    ddc_ci_vcp_value_t    * p_result;    /* Get result */
+    ddc_ci_vcp_value_t    * p_batch;     /* First value of the batch, given to the callback */
+    uint32_t                batch_count; /* Non-zero on the last request of a batch */
+    ddc_ci_batch_callback_t p_callback;
+} ddc_ci_request_t;
+
+typedef enum ddc_ci_state
+{
+    DDC_CI_STATE_STOPPED,      /* No display */
+    DDC_CI_STATE_IDLE,         /* Waiting for a request and the message interval */
+    DDC_CI_STATE_WRITE,        /* Writing a request */
+    DDC_CI_STATE_REPLY_DELAY,  /* Waiting for the display to prepare the reply */
+    DDC_CI_STATE_REPLY_READ,   /* Reading the reply */
+    DDC_CI_STATE_RETRY_DELAY,  /* Waiting to write the request again after a bad reply */
+} ddc_ci_state_t;
+
+static ddc_ci_state_t   ddc_ci_state = DDC_CI_STATE_STOPPED;
+static uint32_t         ddc_ci_deadline;
+static ddc_ci_request_t ddc_ci_request_queue[DDC_CI_REQUEST_QUEUE_SIZE];
+static uint32_t         ddc_ci_queue_head = 0;
+static uint32_t         ddc_ci_queue_count = 0;
+static ddc_ci_request_t ddc_ci_request_current;
+static bool             ddc_ci_is_audio_request;  /* Current request comes from ddc_ci_audio_update() */
+static uint32_t         ddc_ci_retry_count;
+static uint8_t          ddc_ci_reply[DDC_CI_VCP_REPLY_LENGTH];
+
+/* Audio state requested by the system and the one the display has */
+static bool             ddc_ci_audio_is_mute;
+static uint8_t          ddc_ci_audio_volume;
+static bool             ddc_ci_audio_is_sent = false;
+static bool             ddc_ci_audio_sent_is_mute;
+static uint8_t          ddc_ci_audio_sent_volume;
+
+/* Read at start to know the display and to scale the volume */
+static ddc_ci_vcp_value_t ddc_ci_start_values[] =
+{
+    {DDC_CI_VCP_BRIGHTNESS,   false, false, 0, 0},
+    {DDC_CI_VCP_AUDIO_VOLUME, false, false, 0, 0},
+    {DDC_CI_VCP_INPUT_SOURCE, false, false, 0, 0},
+};
+
+static uint8_t ddc_ci_checksum(uint8_t initial, uint8_t const *p_data, uint32_t length)
+{
+    uint8_t checksum = initial;
+
+    for(uint32_t i=0; i<length; i++)
+    {
+        checksum ^= p_data[i];
+    }
+
+    return checksum;
+}
+
+static fsp_err_t ddc_ci_request_write(ddc_ci_request_t const *p_request)
+{
+    uint8_t  message[6];
+    uint32_t length;
+
+    /* Length byte, opcode and parameters follow the source address. Checksum is XOR from the destination address. */
+    if(DDC_CI_REQUEST_VCP_GET == p_request->type)
+    {
+        message[0] = DDC_CI_LENGTH_FLAG | 2;
+        message[1] = DDC_CI_OPCODE_VCP_GET;
+        message[2] = p_request->code;
+        length = 3;
+    }
+    else
+    {
+        message[0] = DDC_CI_LENGTH_FLAG | 4;
+        message[1] = DDC_CI_OPCODE_VCP_SET;
+        message[2] = p_request->code;
+        message[3] = (uint8_t)(p_request->value >> 8);
+        message[4] = (uint8_t)(p_request->value & 0xFF);
+        length = 5;
+    }
+    message[length] = ddc_ci_checksum(DDC_CI_DISPLAY_WRITE_ADDRESS ^ DDC_CI_HOST_ADDRESS, &message[0], length);
+
+    return ddc_write_start(HDMI_DDC_I2C_ADDR_DDC_CI, DDC_CI_HOST_ADDRESS, &message[0], length + 1);
+}
+
+static bool ddc_ci_reply_parse(ddc_ci_request_t const *p_request)
+{
+    uint8_t const *reply = &ddc_ci_reply[0];
+
+    if(ddc_ci_checksum(DDC_CI_VIRTUAL_HOST_ADDRESS, reply, DDC_CI_VCP_REPLY_LENGTH - 1) != reply[DDC_CI_VCP_REPLY_LENGTH - 1])
+    {
+        return false;
+    }
+
+    /* Null message (length 0) means the display is not ready */
+    if((reply[1] != (DDC_CI_LENGTH_FLAG | 8)) || (reply[2] != DDC_CI_OPCODE_VCP_REPLY) || (reply[4] != p_request->code))
+    {
+        return false;
+    }
+
+    p_request->p_result->is_valid     = true;
+    p_request->p_result->is_supported = (reply[3] == 0x00);
+    p_request->p_result->maximum      = (uint16_t)((reply[6] << 8) | reply[7]);
+    p_request->p_result->current      = (uint16_t)((reply[8] << 8) | reply[9]);
+
+    return true;
+}
+
+static fsp_err_t ddc_ci_request_post(ddc_ci_request_t const *p_request)
+{
+    if(ddc_ci_queue_count >= DDC_CI_REQUEST_QUEUE_SIZE)
+    {
+        return FSP_ERR_OVERFLOW;
+    }
+
+    ddc_ci_request_queue[(ddc_ci_queue_head + ddc_ci_queue_count) % DDC_CI_REQUEST_QUEUE_SIZE] = *p_request;
+    ddc_ci_queue_count++;
+
+    return FSP_SUCCESS;
+}
+
+/* Request to bring the display audio to the system one. Scaled by the maximum the display reported. */
+static bool ddc_ci_audio_request_get(ddc_ci_request_t *p_request)
+{
+    ddc_ci_vcp_value_t const *p_volume = &ddc_ci_start_values[1];
+    uint16_t maximum = (p_volume->is_supported && (p_volume->maximum != 0)) ? p_volume->maximum : 100;
+
+    memset(p_request, 0, sizeof(ddc_ci_request_t));
+    p_request->type = DDC_CI_REQUEST_VCP_SET;
+
+    if(!ddc_ci_audio_is_sent || (ddc_ci_audio_sent_is_mute != ddc_ci_audio_is_mute))
+    {
+        p_request->code  = DDC_CI_VCP_AUDIO_MUTE;
+        p_request->value = ddc_ci_audio_is_mute ? DDC_CI_VCP_AUDIO_MUTE_ON : DDC_CI_VCP_AUDIO_MUTE_OFF;
+        return true;
+    }
+    if(ddc_ci_audio_sent_volume != ddc_ci_audio_volume)
+    {
+        p_request->code   = DDC_CI_VCP_AUDIO_VOLUME;
+        p_request->value  = (uint16_t)(((uint32_t)ddc_ci_audio_volume * maximum) / 100);
+        p_request->volume = ddc_ci_audio_volume;
+        return true;
+    }
+
+    return false;
+}
+
+/* Complete the current request and schedule the next message */
+static void ddc_ci_request_complete(bool is_success)
+{
+    ddc_ci_request_t const *p_request = &ddc_ci_request_current;
+
+    if(ddc_ci_is_audio_request && is_success)
+    {
+        if(DDC_CI_VCP_AUDIO_MUTE == p_request->code)
+        {
+            ddc_ci_audio_sent_is_mute = (DDC_CI_VCP_AUDIO_MUTE_ON == p_request->value);
+            ddc_ci_audio_is_sent = true;
+        }
+        else
+        {
+            /* The system volume may have moved during the transfer. It is sent next time. */
+            ddc_ci_audio_sent_volume = p_request->volume;
+        }
+    }
+
+    if((NULL != p_request->p_callback) && (0 != p_request->batch_count))
+    {
+        p_request->p_callback(p_request->p_batch, p_request->batch_count);
+    }
+
+    ddc_ci_deadline = system_tick_get() + DDC_CI_MESSAGE_INTERVAL_MS;
+    ddc_ci_state = DDC_CI_STATE_IDLE;
+}
+
+static void ddc_ci_start_values_callback(ddc_ci_vcp_value_t const * p_values, uint32_t count)
+{
+    for(uint32_t i=0; i<count; i++)
+    {
+        if(p_values[i].is_valid && p_values[i].is_supported)
+        {
+            APP_PRINT("[Display] DDC/CI VCP 0x%02x: %d / %d\r\n", p_values[i].code, p_values[i].current, p_values[i].maximum);
+        }
+    }
+}
+
+void ddc_ci_start(void)
+{
+    ddc_ci_stop();
+
+    /* Display is probed by the first batch. Audio is sent again to the new display. */
+    ddc_ci_audio_is_sent = false;
+    ddc_ci_deadline = system_tick_get();
+    ddc_ci_state = DDC_CI_STATE_IDLE;
+
+    ddc_ci_vcp_get_batch(&ddc_ci_start_values[0], sizeof(ddc_ci_start_values) / sizeof(ddc_ci_vcp_value_t), ddc_ci_start_values_callback);
+}
+
+void ddc_ci_stop(void)
+{
+    if((DDC_CI_STATE_WRITE == ddc_ci_state) || (DDC_CI_STATE_REPLY_READ == ddc_ci_state))
+    {
+        ddc_transfer_abort();
+    }
+
+    ddc_ci_queue_count = 0;
+    ddc_ci_state = DDC_CI_STATE_STOPPED;
+}
+
+fsp_err_t ddc_ci_vcp_get_batch(ddc_ci_vcp_value_t * p_values, uint32_t count, ddc_ci_batch_callback_t p_callback)
+{
+    ddc_ci_request_t request;
+
+    if((count == 0) || ((ddc_ci_queue_count + count) > DDC_CI_REQUEST_QUEUE_SIZE))
+    {
+        return FSP_ERR_OVERFLOW;
+    }
+
+    /* Requests of a batch run back to back in the queue. The last one reports the batch. */
+    for(uint32_t i=0; i<count; i++)
+    {
+        p_values[i].is_valid = false;
+        p_values[i].is_supported = false;
+
+        memset(&request, 0, sizeof(request));
+        request.type        = DDC_CI_REQUEST_VCP_GET;
+        request.code        = p_values[i].code;
+        request.p_result    = &p_values[i];
+        request.p_batch     = p_values;
+        request.batch_count = (i == (count - 1)) ? count : 0;
+        request.p_callback  = p_callback;
+        ddc_ci_request_post(&request);
+    }
+
+    return FSP_SUCCESS;
+}
+
+fsp_err_t ddc_ci_vcp_set(uint8_t code, uint16_t value)
+{
+    ddc_ci_request_t request;
+
+    /* Pending set of the same feature is overwritten with the newer value */
+    for(uint32_t i=0; i<ddc_ci_queue_count; i++)
+    {
+        ddc_ci_request_t *p_queued = &ddc_ci_request_queue[(ddc_ci_queue_head + i) % DDC_CI_REQUEST_QUEUE_SIZE];
+        if((DDC_CI_REQUEST_VCP_SET == p_queued->type) && (code == p_queued->code))
+        {
+            p_queued->value = value;
+            return FSP_SUCCESS;
+        }
+    }
+
+    memset(&request, 0, sizeof(request));
+    request.type  = DDC_CI_REQUEST_VCP_SET;
+    request.code  = code;
+    request.value = value;
+
+    return ddc_ci_request_post(&request);
+}
+
+void ddc_ci_audio_update(bool is_mute, uint8_t volume)
+{
+    /* Sent from ddc_ci_process() when there is no other request, so a volume ramp sends only the latest value */
+    ddc_ci_audio_is_mute = is_mute;
+    ddc_ci_audio_volume  = volume;
+}
+
+void ddc_ci_process(void)
+{
+    fsp_err_t fsp_err;
+
+    switch(ddc_ci_state)
+    {
+        case DDC_CI_STATE_IDLE:
+            if(!SYSTEM_TICK_IS_REACHED(ddc_ci_deadline))
+            {
+                break;
+            }
+
+            if(ddc_ci_queue_count != 0)
+            {
+                ddc_ci_request_current = ddc_ci_request_queue[ddc_ci_queue_head];
+                ddc_ci_is_audio_request = false;
+            }
+            else if(ddc_ci_audio_request_get(&ddc_ci_request_current))
+            {
+                ddc_ci_is_audio_request = true;
+            }
+            else
+            {
+                break;
+            }
+
+            /* DDC may be used by SCDC. Try again next time. */
+            if(FSP_SUCCESS != ddc_ci_request_write(&ddc_ci_request_current))
+            {
+                break;
+            }
+
+            if(!ddc_ci_is_audio_request)
+            {
+                ddc_ci_queue_head = (ddc_ci_queue_head + 1) % DDC_CI_REQUEST_QUEUE_SIZE;
+                ddc_ci_queue_count--;
+            }
+            ddc_ci_retry_count = 0;
+            ddc_ci_state = DDC_CI_STATE_WRITE;
+            break;
+
+        case DDC_CI_STATE_WRITE:
+            fsp_err = ddc_transfer_poll();
+            if(FSP_ERR_IN_USE == fsp_err)
+            {
+                break;
+            }
+
+            if((FSP_SUCCESS != fsp_err) && (ddc_ci_retry_count < DDC_CI_RETRY_COUNT))
+            {
+                /* Display may be busy, or SCDC collided on the bus. Write the request again after the message interval. */
+                ddc_ci_retry_count++;
+                ddc_ci_deadline = system_tick_get() + DDC_CI_MESSAGE_INTERVAL_MS;
+                ddc_ci_state = DDC_CI_STATE_RETRY_DELAY;
+                break;
+            }
+            else if(FSP_SUCCESS != fsp_err)
+            {
+                /* No ACK even after the retries means the display has no DDC/CI or it is disabled in its menu */
+                APP_PRINT("[Display] DDC/CI is not available.\r\n");
+                ddc_ci_request_complete(false);
+                ddc_ci_stop();
+                break;
+            }
+
+            if(DDC_CI_REQUEST_VCP_GET == ddc_ci_request_current.type)
+            {
+                ddc_ci_deadline = system_tick_get() + DDC_CI_REPLY_DELAY_MS;
+                ddc_ci_state = DDC_CI_STATE_REPLY_DELAY;
+            }
+            else
+            {
+                ddc_ci_request_complete(true);
+            }
+            break;
+
+        case DDC_CI_STATE_REPLY_DELAY:
+            if(!SYSTEM_TICK_IS_REACHED(ddc_ci_deadline))
+            {
+                break;
+            }
+
+            if(FSP_SUCCESS == ddc_receive_start(HDMI_DDC_I2C_ADDR_DDC_CI, &ddc_ci_reply[0], sizeof(ddc_ci_reply)))
+            {
+                ddc_ci_state = DDC_CI_STATE_REPLY_READ;
+            }
+            break;
+
+        case DDC_CI_STATE_REPLY_READ:
+            fsp_err = ddc_transfer_poll();
+            if(FSP_ERR_IN_USE == fsp_err)
+            {
+                break;
+            }
+
+            if((FSP_SUCCESS == fsp_err) && ddc_ci_reply_parse(&ddc_ci_request_current))
+            {
+                ddc_ci_request_complete(true);
+            }
+            else if(ddc_ci_retry_count < DDC_CI_RETRY_COUNT)
+            {
+                /* Write the request again after the message interval */
+                ddc_ci_retry_count++;
+                ddc_ci_deadline = system_tick_get() + DDC_CI_MESSAGE_INTERVAL_MS;
+                ddc_ci_state = DDC_CI_STATE_RETRY_DELAY;
+            }
+            else
+            {
+                ddc_ci_request_complete(false);
+            }
+            break;
+
+        case DDC_CI_STATE_RETRY_DELAY:
+            if(!SYSTEM_TICK_IS_REACHED(ddc_ci_deadline))
+            {
+                break;
+            }
+
+            if(FSP_SUCCESS == ddc_ci_request_write(&ddc_ci_request_current))
+            {
+                ddc_ci_state = DDC_CI_STATE_WRITE;
+            }
+            break;
+
+        default:
+            /* Stopped */
+            break;
+    }
+}
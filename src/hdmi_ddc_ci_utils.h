@@ -0,0 +1,70 @@
+/***********************************************************************************************************************
+ * File Name    : hdmi_ddc_ci_utils.h
+ * Description  : Contains data structures and functions used in hdmi_ddc_ci_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef __HDMI_DDC_CI_UTILS_H__
+#define __HDMI_DDC_CI_UTILS_H__
+#include "hal_data.h"
+
+/*
+ * DDC/CI (MCCS) at DDC address 0x37
+ */
+#define DDC_CI_HOST_ADDRESS          (0x51) /* Source address byte of host messages */
+#define DDC_CI_DISPLAY_WRITE_ADDRESS (0x6E) /* 8-bit write address of the display, included in the checksum */
+#define DDC_CI_VIRTUAL_HOST_ADDRESS  (0x50) /* Used for the checksum of display messages */
+#define DDC_CI_LENGTH_FLAG           (0x80)
+
+#define DDC_CI_OPCODE_VCP_GET        (0x01)
+#define DDC_CI_OPCODE_VCP_REPLY      (0x02)
+#define DDC_CI_OPCODE_VCP_SET        (0x03)
+
+#define DDC_CI_VCP_REPLY_LENGTH      (11)
+
+/* VCP codes */
+#define DDC_CI_VCP_BRIGHTNESS        (0x10)
+#define DDC_CI_VCP_INPUT_SOURCE      (0x60)
+#define DDC_CI_VCP_AUDIO_VOLUME      (0x62)
+#define DDC_CI_VCP_AUDIO_MUTE        (0x8D)
+
+#define DDC_CI_VCP_AUDIO_MUTE_ON     (0x01)
+#define DDC_CI_VCP_AUDIO_MUTE_OFF    (0x02)
+
+/* Value of a VCP feature read from the display */
+typedef struct ddc_ci_vcp_value
+{
+    uint8_t  code;
+    bool     is_valid;      ///< Reply received with the valid checksum
+    bool     is_supported;  ///< Result code of the reply is "No Error"
+    uint16_t maximum;
+    uint16_t current;
+} ddc_ci_vcp_value_t;
+
+/* Called when all reads of a batch are done. Failed reads have is_valid false. */
+typedef void (* ddc_ci_batch_callback_t)(ddc_ci_vcp_value_t const * p_values, uint32_t count);
+
+void      ddc_ci_start(void);
+void      ddc_ci_stop(void);
+void      ddc_ci_process(void);
+fsp_err_t ddc_ci_vcp_get_batch(ddc_ci_vcp_value_t * p_values, uint32_t count, ddc_ci_batch_callback_t p_callback);
+fsp_err_t ddc_ci_vcp_set(uint8_t code, uint16_t value);
+void      ddc_ci_audio_update(bool is_mute, uint8_t volume);
+
+#endif /* End of __HDMI_DDC_CI_UTILS_H__ */
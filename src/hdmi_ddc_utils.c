@@ -25,14 +25,295 @@
 
 ///############# Application Option Setting #############
 #define DEBUG_EDID_RECEIVED_DATA_OUTPUT  (0) // 0: Disabled, 1: Enabled
+#define DEBUG_DDC_INTERRUPT_STATISTICS   (0) // 0: Disabled, 1: Count SCI interrupts of DDC (vector table is moved to RAM to hook them)
+#define DEBUG_DDC_DTC_BENCHMARK          (0) // 0: Disabled, 1: Compare EDID read with and without DTC. Needs DEBUG_DDC_INTERRUPT_STATISTICS
+#define DEBUG_EDID_PARSER_BENCHMARK      (0) // 0: Disabled, 1: Measure parser throughput with the received EDID
+#define DEBUG_EDID_PARSER_BENCHMARK_LOOP (100)
 ///########## End of Application Option Setting #########
 
 static volatile bool iic_rx_complete_flag = false;
 static volatile bool iic_tx_complete_flag = false;
 static volatile bool iic_error_flag = false;
 
-static edid_data_t               edid_base_data;
-static edid_cta_extention_data_t edid_cta_data;
+#if (DEBUG_DDC_DTC_BENCHMARK == 1) && (DEBUG_DDC_INTERRUPT_STATISTICS == 0)
+#error "DEBUG_DDC_DTC_BENCHMARK needs DEBUG_DDC_INTERRUPT_STATISTICS"
+#endif
+
+static ddc_transfer_statistics_t ddc_transfer_statistics;
+
+#if (DEBUG_DDC_INTERRUPT_STATISTICS == 1)
+/* Vector table in RAM, where the SCI interrupts of DDC are hooked. VTOR needs the alignment of the table size. */
+#define DDC_VECTOR_NUMBER     (16 + BSP_ICU_VECTOR_MAX_ENTRIES)
+#define DDC_VECTOR_ALIGNMENT  (512)
+#if (DDC_VECTOR_NUMBER * 4) > DDC_VECTOR_ALIGNMENT
+#error "DDC_VECTOR_ALIGNMENT must be the power of 2 not less than the vector table size"
+#endif
+
+typedef void (* ddc_isr_t)(void);
+
+typedef enum ddc_sci_isr
+{
+    DDC_SCI_ISR_TXI,
+    DDC_SCI_ISR_RXI,
+    DDC_SCI_ISR_TEI,
+    DDC_SCI_ISR_NUMBER,
+} ddc_sci_isr_t;
+
+static ddc_isr_t ddc_vector_table[DDC_VECTOR_NUMBER] __attribute__((aligned(DDC_VECTOR_ALIGNMENT)));
+static ddc_isr_t ddc_sci_isr_original[DDC_SCI_ISR_NUMBER];
+
+static void ddc_interrupt_statistics_install(void);
+static void ddc_sci_isr_call(ddc_sci_isr_t isr, uint32_t *p_count);
+static void ddc_sci_txi_isr(void);
+static void ddc_sci_rxi_isr(void);
+static void ddc_sci_tei_isr(void);
+#endif
+
+/* Received bytes handed to the EDID parser while the read is in progress */
+typedef struct ddc_rx_stream
+{
+    edid_parser_t * p_parser;
+    uint8_t const * p_dest;
+    uint32_t        length;
+    uint32_t        fed;
+} ddc_rx_stream_t;
+
+/* Background transfer driven by ddc_transfer_poll() */
+typedef enum ddc_async_state
+{
+    DDC_ASYNC_STATE_IDLE,
+    DDC_ASYNC_STATE_READ_OFFSET, /* Writing the offset of a read */
+    DDC_ASYNC_STATE_READ_DATA,   /* Reading after the repeated start */
+    DDC_ASYNC_STATE_WRITE,       /* Writing the offset and data */
+} ddc_async_state_t;
+
+static ddc_async_state_t ddc_async_state = DDC_ASYNC_STATE_IDLE;
+static uint8_t           ddc_async_buffer[1 + DDC_ASYNC_WRITE_LENGTH_MAX]; /* Offset followed by write data */
+static uint8_t         * p_ddc_async_dest;
+static uint32_t          ddc_async_length;
+
+static const uint8_t edid_header_pattern[8] = {0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00};
+
+/* Base block and the first extension are contiguous, so EDID is read into them in one transaction */
+static struct
+{
+    edid_data_t               base;
+    edid_cta_extention_data_t cta;
+} edid_block_data;
+
+static bool    edid_vendor_id_found = false;
+static uint8_t edid_vendor_id[3];
+
+/* SADs of the Audio Data Block. Received ones are used after the CTA extension checksum is valid. */
+static uint8_t  edid_sad_received[EDID_CTA_SAD_MAX * EDID_CTA_SAD_LENGTH];
+static uint32_t edid_sad_received_count = 0;
+static uint8_t  edid_sad[EDID_CTA_SAD_MAX * EDID_CTA_SAD_LENGTH];
+static uint32_t edid_sad_count = 0;
+
+/* SCDC_Present of HF-VSDB. Same validation as the SADs. */
+static bool edid_scdc_present_received = false;
+static bool edid_scdc_present = false;
+
+/* CEC vendor ID of sink manufacturers. Add your sink if it is not listed. */
+static const edid_vendor_id_map_t edid_vendor_id_list[] =
+{
+    {"SAM", {0x00, 0x00, 0xF0}}, /* Samsung */
+    {"GSM", {0x00, 0xE0, 0x91}}, /* LG */
+    {"SNY", {0x08, 0x00, 0x46}}, /* Sony */
+    {"MEI", {0x00, 0x80, 0x45}}, /* Panasonic */
+    {"PHL", {0x00, 0x90, 0x3E}}, /* Philips */
+    {"TSB", {0x00, 0x00, 0x39}}, /* Toshiba */
+    {"SHP", {0x08, 0x00, 0x1F}}, /* Sharp */
+    {"VIZ", {0x6B, 0x74, 0x6D}}, /* Vizio */
+    {"ONK", {0x00, 0x09, 0xB0}}, /* Onkyo */
+    {"YMH", {0x00, 0xA0, 0xDE}}, /* Yamaha */
+    {"PIO", {0x00, 0xE0, 0x36}}, /* Pioneer */
+    {"DON", {0x00, 0x05, 0xCD}}, /* Denon */
+    {"MJI", {0x00, 0x06, 0x78}}, /* Marantz */
+    {"LOE", {0x00, 0x09, 0x82}}, /* Loewe */
+    {"MED", {0x00, 0x0C, 0xB8}}, /* Medion */
+    {"AOC", {0x00, 0x24, 0x67}}, /* AOC */
+    {"BNQ", {0x80, 0x65, 0xE9}}, /* BenQ */
+};
+
+static fsp_err_t edid_manufacturer_vendor_id_find(uint8_t const *manufacturer_id, uint8_t *vendor_id);
+
+static void edid_parser_event_raise(edid_parser_t *p_parser, edid_parser_event_t event, uint8_t const *p_data, uint32_t length)
+{
+    edid_parser_callback_args_t args;
+
+    if(NULL == p_parser->p_callback)
+    {
+        return;
+    }
+
+    args.event    = event;
+    args.p_parser = p_parser;
+    args.p_data   = p_data;
+    args.length   = length;
+    p_parser->p_callback(&args);
+}
+
+static void edid_parser_fail(edid_parser_t *p_parser, fsp_err_t error)
+{
+    p_parser->failed_state = p_parser->state;
+    p_parser->state        = EDID_PARSER_STATE_ERROR;
+    p_parser->error        = error;
+    edid_parser_event_raise(p_parser, EDID_PARSER_EVENT_ERROR, NULL, 0);
+}
+
+static void edid_parser_base_byte(edid_parser_t *p_parser, uint8_t data)
+{
+    uint8_t offset = p_parser->offset;
+
+    /* Check the header pattern byte by byte to fail as early as possible */
+    if(offset < sizeof(edid_header_pattern))
+    {
+        if(data != edid_header_pattern[offset])
+        {
+            edid_parser_fail(p_parser, FSP_ERR_INVALID_DATA);
+        }
+    }
+    else if((offset == 8) || (offset == 9))
+    {
+        p_parser->manufacturer_id[offset - 8] = data;
+    }
+    else if(offset == 126)
+    {
+        p_parser->number_of_extensions = data;
+    }
+    else if(offset == 127)
+    {
+        /* Sum of all 128 bytes including the checksum is 0 */
+        if(p_parser->checksum != 0)
+        {
+            edid_parser_fail(p_parser, FSP_ERR_INVALID_DATA);
+            return;
+        }
+
+        p_parser->state = (p_parser->number_of_extensions == 0) ? EDID_PARSER_STATE_DONE : EDID_PARSER_STATE_CTA;
+        p_parser->error = (p_parser->number_of_extensions == 0) ? FSP_SUCCESS : p_parser->error;
+        edid_parser_event_raise(p_parser, EDID_PARSER_EVENT_BASE_BLOCK_VALID, NULL, 0);
+    }
+}
+
+static void edid_parser_data_block_byte(edid_parser_t *p_parser, uint8_t data)
+{
+    uint8_t const *block = &p_parser->data_block[0];
+
+    /* The header byte tells the payload length */
+    if(p_parser->data_block_fill == 0)
+    {
+        p_parser->data_block_length = (uint8_t)((data & 0x1F) + 1);
+    }
+    p_parser->data_block[p_parser->data_block_fill++] = data;
+
+    if(p_parser->data_block_fill < p_parser->data_block_length)
+    {
+        return;
+    }
+    p_parser->data_block_fill = 0;
+
+    edid_parser_event_raise(p_parser, EDID_PARSER_EVENT_CTA_DATA_BLOCK, block, p_parser->data_block_length);
+
+    /* HDMI VSDB: IEEE OUI 0x000C03 (LSB first) followed by physical address A.B.C.D */
+    if(((block[0] >> 5) == CTA_DATA_TYPE_VENDOR_SPECIFIC) && (p_parser->data_block_length >= 6) &&
+       (block[1] == (uint8_t)EDID_CTA_IEEE_IDENTIFIER_HDMI) &&
+       (block[2] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HDMI >> 8)) &&
+       (block[3] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HDMI >> 16)) &&
+       !p_parser->is_physical_address_found)
+    {
+        p_parser->physical_address[3] = (uint8_t)(block[4] >> 4);
+        p_parser->physical_address[2] = (uint8_t)(block[4] & 0x0F);
+        p_parser->physical_address[1] = (uint8_t)(block[5] >> 4);
+        p_parser->physical_address[0] = (uint8_t)(block[5] & 0x0F);
+        p_parser->is_physical_address_found = true;
+
+        edid_parser_event_raise(p_parser, EDID_PARSER_EVENT_PHYSICAL_ADDRESS, &p_parser->physical_address[0], 4);
+    }
+}
+
+static void edid_parser_cta_byte(edid_parser_t *p_parser, uint8_t data)
+{
+    uint8_t offset = p_parser->offset;
+
+    if(offset == 0)
+    {
+        /* Check the extension flag. 0x02 for CTA EDID */
+        if(data != EDID_CTA_EXTENSION_TAG)
+        {
+            edid_parser_fail(p_parser, FSP_ERR_INVALID_DATA);
+        }
+    }
+    else if(offset == 1)
+    {
+        p_parser->cta_revision = data;
+    }
+    else if(offset == 2)
+    {
+        /* The collection cannot run into the checksum. Out of range means no data block, as edid_cta_physical_address_find() */
+        p_parser->cta_dtd_offset = (data < EDID_CTA_DATA_SIZE) ? data : 0;
+    }
+    else if(offset == 127)
+    {
+        if(p_parser->checksum != 0)
+        {
+            edid_parser_fail(p_parser, FSP_ERR_INVALID_DATA);
+            return;
+        }
+
+        p_parser->state = EDID_PARSER_STATE_DONE;
+        p_parser->error = FSP_SUCCESS;
+        edid_parser_event_raise(p_parser, EDID_PARSER_EVENT_CTA_BLOCK_VALID, NULL, 0);
+    }
+    else if((p_parser->cta_revision == EDID_CTA_REVISION_3) &&
+            (offset >= EDID_CTA_DATA_BLOCK_OFFSET) && (offset < p_parser->cta_dtd_offset))
+    {
+        /* Data block collection lies between byte 4 and the first DTD */
+        edid_parser_data_block_byte(p_parser, data);
+    }
+}
+
+void edid_parser_init(edid_parser_t *p_parser, void (* p_callback)(edid_parser_callback_args_t * p_args))
+{
+    memset(p_parser, 0, sizeof(edid_parser_t));
+    p_parser->state      = EDID_PARSER_STATE_BASE;
+    p_parser->error      = FSP_ERR_INVALID_DATA; /* Until all blocks are received */
+    p_parser->p_callback = p_callback;
+}
+
+void edid_parser_feed(edid_parser_t *p_parser, uint8_t const *p_data, uint32_t length)
+{
+    for(uint32_t i=0; i<length; i++)
+    {
+        /* Bytes after the last block (e.g. don't care data of a sink without extension) are ignored */
+        if((EDID_PARSER_STATE_BASE != p_parser->state) && (EDID_PARSER_STATE_CTA != p_parser->state))
+        {
+            return;
+        }
+
+        p_parser->checksum = (uint8_t)(p_parser->checksum + p_data[i]);
+
+        if(EDID_PARSER_STATE_BASE == p_parser->state)
+        {
+            edid_parser_base_byte(p_parser, p_data[i]);
+        }
+        else
+        {
+            edid_parser_cta_byte(p_parser, p_data[i]);
+        }
+
+        if(p_parser->offset == 127)
+        {
+            p_parser->offset   = 0;
+            p_parser->checksum = 0;
+        }
+        else
+        {
+            p_parser->offset++;
+        }
+    }
+}
 
 
 fsp_err_t edid_format_check(edid_data_t const *data)
@@ -40,8 +321,8 @@ fsp_err_t edid_format_check(edid_data_t const *data)
     uint8_t checksum_sum_result = 0x0;
 
     /* Check the header pattern. 0x00, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0x00 */
-    if(!((data->header.header_pattern[0] == EDID_HEADER_FIXED_HEADER_PATTERN_FIRST_32BIT) &&
-         (data->header.header_pattern[1] == EDID_HEADER_FIXED_HEADER_PATTERN_SECOND_32BIT)))
+    /* Compared byte by byte, which does not depend on endianness and alignment of the buffer */
+    if(0 != memcmp(&data->header, &edid_header_pattern[0], sizeof(edid_header_pattern)))
     {
         return FSP_ERR_INVALID_DATA;
     }
@@ -52,7 +333,8 @@ fsp_err_t edid_format_check(edid_data_t const *data)
         checksum_sum_result += *((uint8_t *)data + i);
     }
 
-    if((0xFF - checksum_sum_result + 1) != data->checksum)
+    /* Sum of all 128 bytes is 0. Checksum is 0 when the other bytes sum to 0. */
+    if((uint8_t)(0x100 - checksum_sum_result) != data->checksum)
     {
         return FSP_ERR_INVALID_DATA;
     }
@@ -76,7 +358,8 @@ fsp_err_t edid_cta_format_check(edid_cta_extention_data_t const *data)
         checksum_sum_result += *((uint8_t *)data + i);
     }
 
-    if((0xFF - checksum_sum_result + 1) != data->checksum)
+    /* Sum of all 128 bytes is 0. Checksum is 0 when the other bytes sum to 0. */
+    if((uint8_t)(0x100 - checksum_sum_result) != data->checksum)
     {
         return FSP_ERR_INVALID_DATA;
     }
@@ -84,169 +367,577 @@ fsp_err_t edid_cta_format_check(edid_cta_extention_data_t const *data)
     return FSP_SUCCESS;
 }
 
-fsp_err_t physical_address_get(uint8_t *addr)
+/* Hand the bytes received so far to the parser */
+static void ddc_rx_stream_feed(ddc_rx_stream_t *p_stream, bool is_complete)
 {
-    fsp_err_t fsp_err = FSP_SUCCESS;
-    uint8_t iic_transfer_data[10] = {0x0};
-    uint8_t iic_read_data[128] = {0x0};
+    uint32_t received = p_stream->length;
 
-    /* Open R_IIC master driver */
-//    fsp_err = R_IIC_MASTER_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg);
-    fsp_err = R_SCI_I2C_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg);
-    if(FSP_SUCCESS != fsp_err)
+    if(!is_complete)
     {
-        APP_PRINT("R_IIC_MASTER_Open failed\r\n");
-        return fsp_err;
+        /* DTC writes back its destination pointer after every byte, which tells how far the read is. */
+        /* Out of range means the transfer is not set up yet or is done by CPU, which is fed on completion. */
+        uintptr_t current = (uintptr_t)g_ddc_transfer_rx.p_cfg->p_info->p_dest;
+        uintptr_t start   = (uintptr_t)p_stream->p_dest;
+        if((current < start) || (current > (start + p_stream->length)))
+        {
+            return;
+        }
+        received = (uint32_t)(current - start);
+    }
+
+    if(received > p_stream->fed)
+    {
+        edid_parser_feed(p_stream->p_parser, p_stream->p_dest + p_stream->fed, received - p_stream->fed);
+        p_stream->fed = received;
+    }
+}
+
+/* Wait for the transfer flag. Interrupts of the transfer are counted by the hooked SCI vectors. */
+static fsp_err_t ddc_transfer_wait(volatile bool *p_complete_flag, ddc_rx_stream_t *p_stream)
+{
+    uint32_t start_cycle = DWT->CYCCNT;
+
+    while(!*p_complete_flag)
+    {
+        if(iic_error_flag)
+        {
+            iic_error_flag = false;
+            APP_PRINT("CEC-DDC channel error\r\n");
+            return FSP_ERR_ABORTED;
+        }
+
+        if(NULL != p_stream)
+        {
+            ddc_rx_stream_feed(p_stream, false);
+        }
+    }
+    *p_complete_flag = false;
+
+    if(NULL != p_stream)
+    {
+        ddc_rx_stream_feed(p_stream, true);
+    }
+
+    ddc_transfer_statistics.wait_cycles += (DWT->CYCCNT - start_cycle);
+
+    return FSP_SUCCESS;
+}
+
+void ddc_transfer_statistics_get(ddc_transfer_statistics_t *p_statistics)
+{
+    *p_statistics = ddc_transfer_statistics;
+}
+
+#if (DEBUG_DDC_INTERRUPT_STATISTICS == 1)
+/*
+ * Copy the vector table to RAM and hook the SCI TXI, RXI and TEI vectors of DDC.
+ * Only these interrupts are counted, so CEC, HPD, GPT and SysTick do not inflate the load of DDC.
+ * With DTC, the CPU sees RXI and TXI only at the end of each DTC transfer, so they are the DTC end events.
+ */
+static void ddc_interrupt_statistics_install(void)
+{
+    IRQn_Type const irq[DDC_SCI_ISR_NUMBER] =
+    {
+        [DDC_SCI_ISR_TXI] = g_ddc_source_i2c_master_cfg.txi_irq,
+        [DDC_SCI_ISR_RXI] = g_ddc_source_i2c_master_cfg.rxi_irq,
+        [DDC_SCI_ISR_TEI] = g_ddc_source_i2c_master_cfg.tei_irq,
+    };
+    ddc_isr_t const hook[DDC_SCI_ISR_NUMBER] =
+    {
+        [DDC_SCI_ISR_TXI] = ddc_sci_txi_isr,
+        [DDC_SCI_ISR_RXI] = ddc_sci_rxi_isr,
+        [DDC_SCI_ISR_TEI] = ddc_sci_tei_isr,
+    };
+
+    if(SCB->VTOR == (uint32_t)&ddc_vector_table[0])
+    {
+        return;
+    }
+
+    memcpy(&ddc_vector_table[0], (void const *)SCB->VTOR, sizeof(ddc_vector_table));
+    for(uint32_t i=0; i<DDC_SCI_ISR_NUMBER; i++)
+    {
+        if(irq[i] >= 0)
+        {
+            ddc_sci_isr_original[i] = ddc_vector_table[16 + irq[i]];
+            ddc_vector_table[16 + irq[i]] = hook[i];
+        }
+    }
+
+    __disable_irq();
+    SCB->VTOR = (uint32_t)&ddc_vector_table[0];
+    __DSB();
+    __ISB();
+    __enable_irq();
+}
+
+static void ddc_sci_isr_call(ddc_sci_isr_t isr, uint32_t *p_count)
+{
+    uint32_t start_cycle = DWT->CYCCNT;
+
+    ddc_sci_isr_original[isr]();
+
+    (*p_count)++;
+    ddc_transfer_statistics.interrupt_cycles += (DWT->CYCCNT - start_cycle);
+}
+
+static void ddc_sci_txi_isr(void)
+{
+    ddc_sci_isr_call(DDC_SCI_ISR_TXI, &ddc_transfer_statistics.txi_count);
+}
+
+static void ddc_sci_rxi_isr(void)
+{
+    ddc_sci_isr_call(DDC_SCI_ISR_RXI, &ddc_transfer_statistics.rxi_count);
+}
+
+static void ddc_sci_tei_isr(void)
+{
+    ddc_sci_isr_call(DDC_SCI_ISR_TEI, &ddc_transfer_statistics.tei_count);
+}
+
+static void ddc_transfer_statistics_print(char const *p_label)
+{
+    APP_PRINT("%s: %d us, SCI interrupts TXI %d, RXI %d, TEI %d, %d us CPU time in them.\r\n", p_label,
+              ddc_transfer_statistics.wait_cycles / (SystemCoreClock / 1000000),
+              ddc_transfer_statistics.txi_count, ddc_transfer_statistics.rxi_count, ddc_transfer_statistics.tei_count,
+              ddc_transfer_statistics.interrupt_cycles / (SystemCoreClock / 1000000));
+}
+#endif
+
+#if (DEBUG_DDC_DTC_BENCHMARK == 1)
+/* Same EDID read with DTC (configured) and without it (driver reopened by CPU transfer) */
+static void ddc_dtc_benchmark(void)
+{
+    static i2c_master_cfg_t cfg_without_dtc; /* Referenced by the driver while open */
+    static uint8_t          buffer[EDID_DATA_SIZE + EDID_CTA_DATA_SIZE];
+
+    if(FSP_SUCCESS == ddc_read(HDMI_DDC_I2C_ADDR_EDID, 0x00, &buffer[0], sizeof(buffer)))
+    {
+        ddc_transfer_statistics_print("EDID read with DTC");
     }
 
-    /* Initialize internal flags */
+    cfg_without_dtc = g_ddc_source_i2c_master_cfg;
+    cfg_without_dtc.p_transfer_tx = NULL;
+    cfg_without_dtc.p_transfer_rx = NULL;
+    R_SCI_I2C_Close(&g_ddc_source_i2c_master_ctrl);
+    if(FSP_SUCCESS == R_SCI_I2C_Open(&g_ddc_source_i2c_master_ctrl, &cfg_without_dtc))
+    {
+        if(FSP_SUCCESS == ddc_read(HDMI_DDC_I2C_ADDR_EDID, 0x00, &buffer[0], sizeof(buffer)))
+        {
+            ddc_transfer_statistics_print("EDID read without DTC");
+        }
+        R_SCI_I2C_Close(&g_ddc_source_i2c_master_ctrl);
+    }
+
+    if(FSP_SUCCESS != R_SCI_I2C_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg))
+    {
+        APP_PRINT("R_SCI_I2C_Open failed\r\n");
+    }
+}
+#endif
+
+/* DDC read which optionally parses EDID while the bytes arrive */
+static fsp_err_t ddc_read_parse(uint8_t slave_address, uint8_t offset, uint8_t *p_dest, uint32_t length,
+                                edid_parser_t *p_parser)
+{
+    fsp_err_t       fsp_err = FSP_SUCCESS;
+    ddc_rx_stream_t stream  = {p_parser, p_dest, length, 0};
+
+    /* Blocking transfer has priority over the background one */
+    ddc_transfer_abort();
+
+    /* Initialize internal flags and statistics of this transfer */
+    memset(&ddc_transfer_statistics, 0, sizeof(ddc_transfer_statistics));
     iic_tx_complete_flag = false;
+    iic_rx_complete_flag = false;
     iic_error_flag = false;
 
-    /* Set slave address of DDC EDID */
-    fsp_err = R_SCI_I2C_SlaveAddressSet(&g_ddc_source_i2c_master_ctrl, HDMI_DDC_I2C_ADDR_EDID, I2C_MASTER_ADDR_MODE_7BIT);
+    fsp_err = R_SCI_I2C_SlaveAddressSet(&g_ddc_source_i2c_master_ctrl, slave_address, I2C_MASTER_ADDR_MODE_7BIT);
     if(FSP_SUCCESS != fsp_err)
     {
         APP_PRINT("R_IIC_MASTER_SlaveAddressSet failed\r\n");
         return fsp_err;
     }
 
-    /// Read EDID 128 byte
-    /* Offset of first 128 byte EDID is 0x00 */
-    iic_transfer_data[0] = 0x00;
-
-    /* Execute writing offset */
-    fsp_err = R_SCI_I2C_Write(&g_ddc_source_i2c_master_ctrl, iic_transfer_data, 1, false);
+    /* Write the offset without STOP. The read follows with a repeated start (combined format). */
+    fsp_err = R_SCI_I2C_Write(&g_ddc_source_i2c_master_ctrl, &offset, 1, true);
     if(FSP_SUCCESS != fsp_err)
     {
         APP_PRINT("R_IIC_MASTER_Write failed\r\n");
         return fsp_err;
-
     }
 
     /* Wait for tx completion */
-    while(!iic_tx_complete_flag)
+    fsp_err = ddc_transfer_wait(&iic_tx_complete_flag, NULL);
+    if(FSP_SUCCESS != fsp_err)
     {
-        if(iic_error_flag)
-        {
-            iic_error_flag = false;
-            APP_PRINT("CEC-DDC channel error\r\n");
-            return FSP_ERR_ABORTED;
-        }
+        return fsp_err;
     }
-    iic_tx_complete_flag = false;
 
-    /* Execute 128 byte read */
-    fsp_err = R_SCI_I2C_Read(&g_ddc_source_i2c_master_ctrl, iic_read_data, 128, false);
+    /* Read directly into the destination */
+    if(NULL != p_parser)
+    {
+        /* Clear the pointer left by the previous read, which may point into this buffer */
+        g_ddc_transfer_rx.p_cfg->p_info->p_dest = NULL;
+    }
+    fsp_err = R_SCI_I2C_Read(&g_ddc_source_i2c_master_ctrl, p_dest, length, false);
     if(FSP_SUCCESS != fsp_err)
     {
         APP_PRINT("R_IIC_MASTER_Read failed\r\n");
         return fsp_err;
     }
 
-    /* Wait for rx completion */
-    while(!iic_rx_complete_flag)
+    /* Wait for rx completion. With DTC, the callback comes once per block. */
+    fsp_err = ddc_transfer_wait(&iic_rx_complete_flag, (NULL != p_parser) ? &stream : NULL);
+    if(FSP_SUCCESS != fsp_err)
     {
-        if(iic_error_flag)
-        {
-            APP_PRINT("CEC-DDC channel error\r\n");
-            return FSP_ERR_ABORTED;
-        }
+        return fsp_err;
     }
-    iic_rx_complete_flag = false;
 
-    memcpy(&edid_base_data, &iic_read_data[0], EDID_DATA_SIZE);
+    return FSP_SUCCESS;
+}
 
-#if (DEBUG_EDID_RECEIVED_DATA_OUTPUT == 1)
-    APP_PRINT("\r\nEDID (First 128byte):");
-    for(uint32_t i=0; i<sizeof(iic_read_data); i++)
+fsp_err_t ddc_read(uint8_t slave_address, uint8_t offset, uint8_t *p_dest, uint32_t length)
+{
+    return ddc_read_parse(slave_address, offset, p_dest, length, NULL);
+}
+
+static fsp_err_t ddc_async_start(uint8_t slave_address, uint8_t *p_data, uint32_t length, bool is_read, bool restart)
+{
+    fsp_err_t fsp_err;
+
+    if(DDC_ASYNC_STATE_IDLE != ddc_async_state)
     {
-        if(i % 16 == 0)
-        {
-            APP_PRINT("\r\n");
-        }
-        APP_PRINT("0x%02x ", iic_read_data[i]);
+        return FSP_ERR_IN_USE;
     }
-    APP_PRINT("\r\n");
-#endif
 
-    fsp_err = edid_format_check(&edid_base_data);
+    /* The driver may not be opened yet when the physical address is fixed */
+    fsp_err = R_SCI_I2C_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg);
+    if((FSP_SUCCESS != fsp_err) && (FSP_ERR_ALREADY_OPEN != fsp_err))
+    {
+        return fsp_err;
+    }
+
+    iic_tx_complete_flag = false;
+    iic_rx_complete_flag = false;
+    iic_error_flag = false;
+
+    fsp_err = R_SCI_I2C_SlaveAddressSet(&g_ddc_source_i2c_master_ctrl, slave_address, I2C_MASTER_ADDR_MODE_7BIT);
     if(FSP_SUCCESS != fsp_err)
     {
-        APP_PRINT("Received EDID data is broken\r\n");
         return fsp_err;
     }
 
-    if(edid_base_data.number_of_extensions != 0)
+    if(is_read)
     {
-        /* Read EDID next 128 byte */
-        iic_transfer_data[0] = 0x80;
+        return R_SCI_I2C_Read(&g_ddc_source_i2c_master_ctrl, p_data, length, false);
+    }
+    return R_SCI_I2C_Write(&g_ddc_source_i2c_master_ctrl, p_data, length, restart);
+}
 
-        iic_tx_complete_flag = false;
-        iic_error_flag = false;
-        fsp_err = R_SCI_I2C_Write(&g_ddc_source_i2c_master_ctrl, iic_transfer_data, 1, false);
-        if(FSP_SUCCESS != fsp_err)
-        {
-            APP_PRINT("R_IIC_MASTER_Write failed\r\n");
-            return fsp_err;
-        }
+fsp_err_t ddc_read_start(uint8_t slave_address, uint8_t offset, uint8_t *p_dest, uint32_t length)
+{
+    fsp_err_t fsp_err;
 
-        while(!iic_tx_complete_flag)
-        {
-            if(iic_error_flag)
+    ddc_async_buffer[0] = offset;
+    fsp_err = ddc_async_start(slave_address, &ddc_async_buffer[0], 1, false, true);
+    if(FSP_SUCCESS == fsp_err)
+    {
+        p_ddc_async_dest = p_dest;
+        ddc_async_length = length;
+        ddc_async_state  = DDC_ASYNC_STATE_READ_OFFSET;
+    }
+
+    return fsp_err;
+}
+
+fsp_err_t ddc_write_start(uint8_t slave_address, uint8_t offset, uint8_t const *p_src, uint32_t length)
+{
+    fsp_err_t fsp_err;
+
+    if(length > DDC_ASYNC_WRITE_LENGTH_MAX)
+    {
+        return FSP_ERR_INVALID_SIZE;
+    }
+    if(DDC_ASYNC_STATE_IDLE != ddc_async_state)
+    {
+        return FSP_ERR_IN_USE;
+    }
+
+    ddc_async_buffer[0] = offset;
+    memcpy(&ddc_async_buffer[1], p_src, length);
+    fsp_err = ddc_async_start(slave_address, &ddc_async_buffer[0], length + 1, false, false);
+    if(FSP_SUCCESS == fsp_err)
+    {
+        ddc_async_state = DDC_ASYNC_STATE_WRITE;
+    }
+
+    return fsp_err;
+}
+
+fsp_err_t ddc_receive_start(uint8_t slave_address, uint8_t *p_dest, uint32_t length)
+{
+    fsp_err_t fsp_err;
+
+    /* Read without offset, e.g. DDC/CI reply */
+    fsp_err = ddc_async_start(slave_address, p_dest, length, true, false);
+    if(FSP_SUCCESS == fsp_err)
+    {
+        ddc_async_state = DDC_ASYNC_STATE_READ_DATA;
+    }
+
+    return fsp_err;
+}
+
+fsp_err_t ddc_transfer_poll(void)
+{
+    fsp_err_t fsp_err;
+
+    /* No transfer means it was aborted by ddc_transfer_abort() */
+    if(DDC_ASYNC_STATE_IDLE == ddc_async_state)
+    {
+        return FSP_ERR_ABORTED;
+    }
+
+    /* NACK (e.g. no SCDC on the sink) ends the transfer with STOP condition */
+    if(iic_error_flag)
+    {
+        iic_error_flag  = false;
+        ddc_async_state = DDC_ASYNC_STATE_IDLE;
+        return FSP_ERR_ABORTED;
+    }
+
+    switch(ddc_async_state)
+    {
+        case DDC_ASYNC_STATE_READ_OFFSET:
+            if(iic_tx_complete_flag)
             {
-                APP_PRINT("CEC-DDC channel error\r\n");
-                return FSP_ERR_ABORTED;
+                iic_tx_complete_flag = false;
+                fsp_err = R_SCI_I2C_Read(&g_ddc_source_i2c_master_ctrl, p_ddc_async_dest, ddc_async_length, false);
+                if(FSP_SUCCESS != fsp_err)
+                {
+                    ddc_async_state = DDC_ASYNC_STATE_IDLE;
+                    return fsp_err;
+                }
+                ddc_async_state = DDC_ASYNC_STATE_READ_DATA;
             }
-        }
-        iic_tx_complete_flag = false;
+            break;
+
+        case DDC_ASYNC_STATE_READ_DATA:
+            if(iic_rx_complete_flag)
+            {
+                iic_rx_complete_flag = false;
+                ddc_async_state = DDC_ASYNC_STATE_IDLE;
+                return FSP_SUCCESS;
+            }
+            break;
+
+        case DDC_ASYNC_STATE_WRITE:
+            if(iic_tx_complete_flag)
+            {
+                iic_tx_complete_flag = false;
+                ddc_async_state = DDC_ASYNC_STATE_IDLE;
+                return FSP_SUCCESS;
+            }
+            break;
+
+        default:
+            break;
+    }
+
+    return FSP_ERR_IN_USE;
+}
+
+void ddc_transfer_abort(void)
+{
+    if(DDC_ASYNC_STATE_IDLE != ddc_async_state)
+    {
+        R_SCI_I2C_Abort(&g_ddc_source_i2c_master_ctrl);
+        ddc_async_state = DDC_ASYNC_STATE_IDLE;
+    }
+}
+
+#if (DEBUG_EDID_PARSER_BENCHMARK == 1)
+/* Throughput of the streaming parser and the whole-block checks over the received EDID */
+static void edid_parser_benchmark(void)
+{
+    edid_parser_t parser;
+    uint8_t       address[4];
+    uint32_t      start_cycle;
+    uint32_t      stream_cycles;
+    uint32_t      block_cycles;
+
+    start_cycle = DWT->CYCCNT;
+    for(uint32_t i=0; i<DEBUG_EDID_PARSER_BENCHMARK_LOOP; i++)
+    {
+        edid_parser_init(&parser, NULL);
+        edid_parser_feed(&parser, (uint8_t const *)&edid_block_data, sizeof(edid_block_data));
+    }
+    stream_cycles = (DWT->CYCCNT - start_cycle) / DEBUG_EDID_PARSER_BENCHMARK_LOOP;
 
-        iic_rx_complete_flag = false;
-        iic_error_flag = false;
-        fsp_err = R_SCI_I2C_Read(&g_ddc_source_i2c_master_ctrl, iic_read_data, 128, false);
-        if(FSP_SUCCESS != fsp_err)
+    start_cycle = DWT->CYCCNT;
+    for(uint32_t i=0; i<DEBUG_EDID_PARSER_BENCHMARK_LOOP; i++)
+    {
+        if((FSP_SUCCESS == edid_format_check(&edid_block_data.base)) &&
+           (FSP_SUCCESS == edid_cta_format_check(&edid_block_data.cta)))
         {
-            APP_PRINT("R_IIC_MASTER_Write failed\r\n");
-            return fsp_err;
+            edid_cta_physical_address_find(&edid_block_data.cta, &address[0]);
         }
+    }
+    block_cycles = (DWT->CYCCNT - start_cycle) / DEBUG_EDID_PARSER_BENCHMARK_LOOP;
 
-        while(!iic_rx_complete_flag)
-        {
-            if(iic_error_flag)
+    APP_PRINT("EDID parser: streaming %d cycles (%d EDIDs/s), whole block %d cycles (%d EDIDs/s)\r\n",
+              stream_cycles, SystemCoreClock / ((stream_cycles != 0) ? stream_cycles : 1),
+              block_cycles, SystemCoreClock / ((block_cycles != 0) ? block_cycles : 1));
+}
+#endif
+
+static void edid_parser_event_handler(edid_parser_callback_args_t *p_args)
+{
+    switch(p_args->event)
+    {
+        case EDID_PARSER_EVENT_BASE_BLOCK_VALID:
+            /* Select the vendor ID of the sink by its manufacturer while the extension is still coming */
+            edid_vendor_id_found = (FSP_SUCCESS == edid_manufacturer_vendor_id_find(&p_args->p_parser->manufacturer_id[0], &edid_vendor_id[0]));
+            break;
+
+        case EDID_PARSER_EVENT_CTA_DATA_BLOCK:
+#if (DEBUG_EDID_RECEIVED_DATA_OUTPUT == 1)
+            APP_PRINT("CTA data block: tag %d, %d bytes\r\n", p_args->p_data[0] >> 5, p_args->length);
+#endif
+            if((p_args->p_data[0] >> 5) == CTA_DATA_TYPE_AUDIO)
             {
-                APP_PRINT("CEC-DDC channel error\r\n");
-                return FSP_ERR_ABORTED;
+                /* Audio Data Block: SADs follow the header byte */
+                edid_sad_received_count = (p_args->length - 1) / EDID_CTA_SAD_LENGTH;
+                memcpy(&edid_sad_received[0], &p_args->p_data[1], edid_sad_received_count * EDID_CTA_SAD_LENGTH);
             }
+            else if(((p_args->p_data[0] >> 5) == CTA_DATA_TYPE_VENDOR_SPECIFIC) && (p_args->length >= 7) &&
+                    (p_args->p_data[1] == (uint8_t)EDID_CTA_IEEE_IDENTIFIER_HF) &&
+                    (p_args->p_data[2] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HF >> 8)) &&
+                    (p_args->p_data[3] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HF >> 16)))
+            {
+                /* HF-VSDB: OUI, Version, Max_TMDS_Character_Rate, then the SCDC_Present flag */
+                edid_scdc_present_received = ((p_args->p_data[6] & EDID_HF_VSDB_SCDC_PRESENT) != 0);
+            }
+            break;
+
+        case EDID_PARSER_EVENT_CTA_BLOCK_VALID:
+            memcpy(&edid_sad[0], &edid_sad_received[0], edid_sad_received_count * EDID_CTA_SAD_LENGTH);
+            edid_sad_count = edid_sad_received_count;
+            edid_scdc_present = edid_scdc_present_received;
+            break;
+
+        default:
+            break;
+    }
+}
+
+fsp_err_t physical_address_get(uint8_t *addr)
+{
+    fsp_err_t fsp_err = FSP_SUCCESS;
+    uint32_t  start_cycle;
+    uint32_t  read_time_us;
+    edid_parser_t parser;
+
+    /* Open R_IIC master driver */
+//    fsp_err = R_IIC_MASTER_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg);
+    /* Called again on every hot plug. The driver stays open after the first call. */
+    fsp_err = R_SCI_I2C_Open(&g_ddc_source_i2c_master_ctrl, &g_ddc_source_i2c_master_cfg);
+    if((FSP_SUCCESS != fsp_err) && (FSP_ERR_ALREADY_OPEN != fsp_err))
+    {
+        APP_PRINT("R_IIC_MASTER_Open failed\r\n");
+        return fsp_err;
+    }
+
+    /* Measure DDC time by the cycle counter. ddc_read() also uses it for the interrupt statistics. */
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL |= DWT_CTRL_CYCCNTENA_Msk;
+#if (DEBUG_DDC_INTERRUPT_STATISTICS == 1)
+    ddc_interrupt_statistics_install();
+#endif
+    start_cycle = DWT->CYCCNT;
+
+    /// Read EDID 256 byte
+    /* Base block and the first extension are read in one transaction from offset 0x00. */
+    /* Sinks without extension return don't care data for the second block, which is not used. */
+    /* The parser validates and walks the data as it arrives, so it is done when the read completes. */
+    edid_vendor_id_found = false;
+    edid_sad_received_count = 0;
+    edid_sad_count = 0;
+    edid_scdc_present_received = false;
+    edid_scdc_present = false;
+    edid_parser_init(&parser, edid_parser_event_handler);
+    fsp_err = ddc_read_parse(HDMI_DDC_I2C_ADDR_EDID, 0x00, (uint8_t *)&edid_block_data, sizeof(edid_block_data), &parser);
+    if(FSP_SUCCESS != fsp_err)
+    {
+        return fsp_err;
+    }
+
+    read_time_us = (DWT->CYCCNT - start_cycle) / (SystemCoreClock / 1000000);
+    APP_PRINT("EDID read via DDC took %d us.\r\n", read_time_us);
+#if (DEBUG_DDC_INTERRUPT_STATISTICS == 1)
+    ddc_transfer_statistics_print("EDID read (parsed while receiving)");
+#endif
+#if (DEBUG_DDC_DTC_BENCHMARK == 1)
+    ddc_dtc_benchmark();
+#endif
+
+#if (DEBUG_EDID_PARSER_BENCHMARK == 1)
+    edid_parser_benchmark();
+#endif
+
+#if (DEBUG_EDID_RECEIVED_DATA_OUTPUT == 1)
+    APP_PRINT("\r\nEDID (First 128byte):");
+    for(uint32_t i=0; i<sizeof(edid_block_data.base); i++)
+    {
+        if(i % 16 == 0)
+        {
+            APP_PRINT("\r\n");
         }
-        iic_rx_complete_flag = false;
+        APP_PRINT("0x%02x ", *((uint8_t *)&edid_block_data.base + i));
+    }
+    APP_PRINT("\r\n");
+#endif
 
-        memcpy(&edid_cta_data, &iic_read_data[0], EDID_CTA_DATA_SIZE);
+    if((EDID_PARSER_STATE_ERROR == parser.state) && (EDID_PARSER_STATE_BASE == parser.failed_state))
+    {
+        APP_PRINT("Received EDID data is broken\r\n");
+        return parser.error;
+    }
 
+    if(parser.number_of_extensions != 0)
+    {
 #if (DEBUG_EDID_RECEIVED_DATA_OUTPUT == 1)
         APP_PRINT("EDID (Next 128byte):");
-        for(uint32_t i=0; i<sizeof(iic_read_data); i++)
+        for(uint32_t i=0; i<sizeof(edid_block_data.cta); i++)
         {
             if(i % 16 == 0)
             {
                 APP_PRINT("\r\n");
             }
-            APP_PRINT("0x%02x ", iic_read_data[i]);
+            APP_PRINT("0x%02x ", *((uint8_t *)&edid_block_data.cta + i));
         }
         APP_PRINT("\r\n\r\n");
 #endif
 
-        fsp_err = edid_cta_format_check(&edid_cta_data);
-        if(FSP_SUCCESS != fsp_err)
+        if(EDID_PARSER_STATE_DONE != parser.state)
         {
             APP_PRINT("Received EDID CTA data is broken or it's not CTA formatted data\r\n");
-            return fsp_err;
+            return parser.error;
         }
 
-        fsp_err = edid_cta_physical_address_find((edid_cta_extention_data_t *)&edid_cta_data, addr);
-        if(fsp_err != FSP_SUCCESS)
+        /* Check the revision number. 0x03 for version 3 (from CTA 861-B onward) */
+        if(parser.cta_revision != EDID_CTA_REVISION_3)
         {
-            return fsp_err;
+            return FSP_ERR_UNSUPPORTED;
         }
+
+        if(!parser.is_physical_address_found)
+        {
+            return FSP_ERR_NOT_FOUND;
+        }
+        memcpy(addr, &parser.physical_address[0], sizeof(parser.physical_address));
     }
 
     return FSP_SUCCESS;
@@ -270,51 +961,109 @@ void ddc_source_iic_callback(i2c_master_callback_args_t *p_args)
 
 fsp_err_t edid_cta_physical_address_find(edid_cta_extention_data_t const *data, uint8_t *address)
 {
-    fsp_err_t                    result = FSP_SUCCESS;
-
-    uint8_t                      scan_point = 0x0;
-    edid_cta_data_block_header_t header;
+    uint32_t scan_point = 0;
+    uint32_t scan_end;
 
     /* Check the revision number. 0x03 for version 3 (from CTA 861-B onward) */
     /* HDMI 1.3a and 1.4 use 861-D. So this value should be 0x03 */
-    if(data->revision_number != 0x3)
+    if(data->revision_number != EDID_CTA_REVISION_3)
     {
         return FSP_ERR_UNSUPPORTED;
     }
 
-    /* Attempt to find Vendor Specific Data Block for "HDMI Licensing LLC" in data_block field */
-    result = FSP_ERR_NOT_FOUND;
+    /* Data block collection lies between byte 4 and the first DTD. 0 means no data block. */
+    if((data->byte_number < EDID_CTA_DATA_BLOCK_OFFSET) || (data->byte_number > (EDID_CTA_DATA_BLOCK_OFFSET + sizeof(data->data_block))))
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    scan_end = (uint32_t)data->byte_number - EDID_CTA_DATA_BLOCK_OFFSET;
 
-    do{
-        memcpy(&header, &data->data_block[scan_point], sizeof(edid_cta_data_block_header_t));
+    /* Attempt to find Vendor Specific Data Block for "HDMI Licensing LLC" in data_block field */
+    while(scan_point < scan_end)
+    {
+        uint8_t const *block  = &data->data_block[scan_point];
+        uint32_t       length = (uint32_t)(block[0] & 0x1F); /* Payload bytes after the header */
 
-        if(header.block_type_tag == CTA_DATA_TYPE_VENDOR_SPECIFIC)
+        /* Block must not run over the collection */
+        if((scan_point + 1 + length) > scan_end)
         {
-            edid_cta_data_vendor_specific_t data_vendor;
-            memcpy(&data_vendor, &data->data_block[scan_point], sizeof(edid_cta_data_vendor_specific_t));
-
-            /* Check IEEE Registration Identifier */
-            if(data_vendor.ieee_identifier == EDID_CTA_IEEE_IDENTIFIER_HDMI)
-            {
-                address[0] = data_vendor.physical_address_1;
-                address[1] = data_vendor.physical_address_2;
-                address[2] = data_vendor.physical_address_3;
-                address[3] = data_vendor.physical_address_4;
-
-                result = FSP_SUCCESS;
-                break;
-            }
+            break;
         }
 
-        if((1 <= header.block_type_tag) && (header.block_type_tag <= 7))
+        /* IEEE OUI 0x000C03 (LSB first) followed by physical address A.B.C.D */
+        if(((block[0] >> 5) == CTA_DATA_TYPE_VENDOR_SPECIFIC) && (length >= 5) &&
+           (block[1] == (uint8_t)EDID_CTA_IEEE_IDENTIFIER_HDMI) &&
+           (block[2] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HDMI >> 8)) &&
+           (block[3] == (uint8_t)(EDID_CTA_IEEE_IDENTIFIER_HDMI >> 16)))
         {
-            scan_point += (uint8_t)(header.byte_number + 1);
+            address[3] = (uint8_t)(block[4] >> 4);
+            address[2] = (uint8_t)(block[4] & 0x0F);
+            address[1] = (uint8_t)(block[5] >> 4);
+            address[0] = (uint8_t)(block[5] & 0x0F);
+            return FSP_SUCCESS;
         }
-        else
+
+        scan_point += 1 + length;
+    }
+
+    return FSP_ERR_NOT_FOUND;
+}
+
+fsp_err_t edid_vendor_id_find(edid_data_t const *data, uint8_t *vendor_id)
+{
+    return edid_manufacturer_vendor_id_find(&data->header.manifacturer_id[0], vendor_id);
+}
+
+static fsp_err_t edid_manufacturer_vendor_id_find(uint8_t const *manufacturer_id, uint8_t *vendor_id)
+{
+    char pnp_id[4];
+
+    /* Manufacturer ID is 3 letters compressed in 5 bits each, big-endian. 1 is 'A'. */
+    pnp_id[0] = (char)('A' - 1 + ((manufacturer_id[0] >> 2) & 0x1F));
+    pnp_id[1] = (char)('A' - 1 + (((manufacturer_id[0] & 0x03) << 3) | (manufacturer_id[1] >> 5)));
+    pnp_id[2] = (char)('A' - 1 + (manufacturer_id[1] & 0x1F));
+    pnp_id[3] = '\0';
+
+    for(uint32_t i=0; i<(sizeof(edid_vendor_id_list) / sizeof(edid_vendor_id_map_t)); i++)
+    {
+        if(0 == memcmp(&edid_vendor_id_list[i].pnp_id[0], &pnp_id[0], 3))
         {
-            scan_point++;
+            memcpy(vendor_id, &edid_vendor_id_list[i].vendor_id[0], 3);
+            return FSP_SUCCESS;
         }
-    }while(scan_point < 123);
+    }
+
+    APP_PRINT("Vendor ID of EDID manufacturer %s is unknown\r\n", pnp_id);
+    return FSP_ERR_NOT_FOUND;
+}
 
-    return result;
+fsp_err_t edid_vendor_id_get(uint8_t *vendor_id)
+{
+    /* Valid after physical_address_get() read EDID */
+    if(!edid_vendor_id_found)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    memcpy(vendor_id, &edid_vendor_id[0], 3);
+    return FSP_SUCCESS;
+}
+
+fsp_err_t edid_short_audio_descriptor_get(uint8_t const **pp_sad, uint32_t *p_count)
+{
+    /* Valid after physical_address_get() read EDID with an Audio Data Block */
+    if(0 == edid_sad_count)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    *pp_sad  = &edid_sad[0];
+    *p_count = edid_sad_count;
+    return FSP_SUCCESS;
+}
+
+bool edid_scdc_present_check(void)
+{
+    /* Valid after physical_address_get() read EDID. SCDC must not be accessed without it (HDMI 2.0). */
+    return edid_scdc_present;
 }
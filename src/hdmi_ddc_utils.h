@@ -29,6 +29,8 @@
 #define HDMI_DDC_I2C_ADDR_EDID   (0x50)
 #define HDMI_DDC_I2C_ADDR_SCDC   (0x54)
 
+#define DDC_ASYNC_WRITE_LENGTH_MAX (16)
+
 #define EDID_DATA_SIZE     (128)
 #define EDID_CTA_DATA_SIZE (128)
 
@@ -36,6 +38,30 @@
 #define EDID_HEADER_FIXED_HEADER_PATTERN_SECOND_32BIT (0x00FFFFFF)
 #define EDID_CTA_EXTENSION_TAG (0x02)
 #define EDID_CTA_IEEE_IDENTIFIER_HDMI (0x000C03)
+#define EDID_CTA_IEEE_IDENTIFIER_HF   (0xC45DD8) /* HDMI Forum VSDB (HF-VSDB) */
+#define EDID_HF_VSDB_SCDC_PRESENT     (0x80)     /* Byte 6 of HF-VSDB: sink supports SCDC */
+#define EDID_CTA_REVISION_3    (0x03)
+#define EDID_CTA_DATA_BLOCK_OFFSET (4)
+#define EDID_CTA_DATA_BLOCK_MAX_SIZE (32)
+#define EDID_CTA_SAD_LENGTH          (3)
+#define EDID_CTA_SAD_MAX             ((EDID_CTA_DATA_BLOCK_MAX_SIZE - 1) / EDID_CTA_SAD_LENGTH)
+
+/* Map of EDID manufacturer ID (PNP ID) to CEC vendor ID (IEEE OUI) */
+typedef struct edid_vendor_id_map
+{
+    char    pnp_id[4];    ///< 3 letters of EDID manufacturer ID
+    uint8_t vendor_id[3]; ///< CEC [Vendor ID], most significant byte first
+}edid_vendor_id_map_t;
+
+/* Statistics of the last blocking DDC transfer. Interrupts are counted only with DEBUG_DDC_INTERRUPT_STATISTICS. */
+typedef struct ddc_transfer_statistics
+{
+    uint32_t txi_count;        ///< SCI TXI interrupts. With DTC, each one is the end of a DTC transfer
+    uint32_t rxi_count;        ///< SCI RXI interrupts. With DTC, each one is the end of a DTC transfer
+    uint32_t tei_count;        ///< SCI TEI interrupts
+    uint32_t interrupt_cycles; ///< CPU cycles spent in those interrupts, including the callback
+    uint32_t wait_cycles;      ///< CPU cycles of the whole wait
+}ddc_transfer_statistics_t;
 
 /*
  * Definition for EDID field
@@ -157,10 +183,73 @@ typedef struct edid_cta_data_vendor_specific
     /* Additional bytes may be present, but the HDMI spec. says they shall be 00. */
 }edid_cta_data_vendor_specific_t;
 
+/*
+ * Definition for streaming EDID parser
+ */
+typedef enum edid_parser_event
+{
+    EDID_PARSER_EVENT_BASE_BLOCK_VALID,  ///< Base block received with the valid header and checksum
+    EDID_PARSER_EVENT_CTA_DATA_BLOCK,    ///< A CTA data block received. Not validated by the checksum yet.
+    EDID_PARSER_EVENT_PHYSICAL_ADDRESS,  ///< HDMI VSDB physical address received. Not validated by the checksum yet.
+    EDID_PARSER_EVENT_CTA_BLOCK_VALID,   ///< CTA extension received with the valid checksum
+    EDID_PARSER_EVENT_ERROR,             ///< Broken data. Following bytes are ignored.
+}edid_parser_event_t;
+
+typedef enum edid_parser_state
+{
+    EDID_PARSER_STATE_BASE,  ///< Receiving the base block
+    EDID_PARSER_STATE_CTA,   ///< Receiving the first extension
+    EDID_PARSER_STATE_DONE,  ///< All blocks received and validated
+    EDID_PARSER_STATE_ERROR, ///< Parse failed
+}edid_parser_state_t;
+
+struct edid_parser;
+
+typedef struct edid_parser_callback_args
+{
+    edid_parser_event_t        event;
+    struct edid_parser const * p_parser;
+    uint8_t const            * p_data; ///< Data block including its header byte, or physical address
+    uint32_t                   length;
+}edid_parser_callback_args_t;
+
+typedef struct edid_parser
+{
+    edid_parser_state_t state;
+    fsp_err_t           error;                 ///< Reason of EDID_PARSER_STATE_ERROR
+    edid_parser_state_t failed_state;          ///< Block being received when the parse failed
+    uint8_t             offset;                ///< Offset in the current 128-byte block
+    uint8_t             checksum;              ///< Running sum of the current block
+    uint8_t             manufacturer_id[2];
+    uint8_t             number_of_extensions;
+    uint8_t             cta_revision;
+    uint8_t             cta_dtd_offset;        ///< End of the CTA data block collection
+    uint8_t             data_block_fill;       ///< Received bytes of the current data block
+    uint8_t             data_block_length;     ///< Total bytes of the current data block including header
+    uint8_t             data_block[EDID_CTA_DATA_BLOCK_MAX_SIZE];
+    bool                is_physical_address_found;
+    uint8_t             physical_address[4];   ///< Same order as physical_address_get()
+    void (* p_callback)(edid_parser_callback_args_t * p_args); ///< May be NULL
+}edid_parser_t;
+
+void      edid_parser_init(edid_parser_t *p_parser, void (* p_callback)(edid_parser_callback_args_t * p_args));
+void      edid_parser_feed(edid_parser_t *p_parser, uint8_t const *p_data, uint32_t length);
+
 fsp_err_t edid_format_check(edid_data_t const *data);
 fsp_err_t edid_cta_format_check(edid_cta_extention_data_t const *data);
 
+fsp_err_t ddc_read(uint8_t slave_address, uint8_t offset, uint8_t *p_dest, uint32_t length);
+fsp_err_t ddc_read_start(uint8_t slave_address, uint8_t offset, uint8_t *p_dest, uint32_t length);
+fsp_err_t ddc_write_start(uint8_t slave_address, uint8_t offset, uint8_t const *p_src, uint32_t length);
+fsp_err_t ddc_receive_start(uint8_t slave_address, uint8_t *p_dest, uint32_t length);
+fsp_err_t ddc_transfer_poll(void);
+void      ddc_transfer_abort(void);
+void      ddc_transfer_statistics_get(ddc_transfer_statistics_t *p_statistics);
 fsp_err_t physical_address_get(uint8_t *addr);
 fsp_err_t edid_cta_physical_address_find(edid_cta_extention_data_t const *data, uint8_t *address);
+fsp_err_t edid_vendor_id_find(edid_data_t const *data, uint8_t *vendor_id);
+fsp_err_t edid_vendor_id_get(uint8_t *vendor_id);
+fsp_err_t edid_short_audio_descriptor_get(uint8_t const **pp_sad, uint32_t *p_count);
+bool      edid_scdc_present_check(void);
 
 #endif /* End of __HDMI_DDC_UTILS_H__ */
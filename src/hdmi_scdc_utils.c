@@ -0,0 +1,247 @@
+/***********************************************************************************************************************
+ * File Name    : hdmi_scdc_utils.c
+ * Description  : Contains data structures and functions used in hdmi_scdc_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include "hdmi_scdc_utils.h"
+#include "hdmi_ddc_utils.h"
+#include "application_utils.h"
+#include "rtt_common_utils.h"
+
+///############# Application Option Setting #############
+#define SCDC_POLL_INTERVAL_MS         (1000)  // Interval of status reads
+#define SCDC_ABSENT_RETRY_INTERVAL_MS (10000) // Interval of retries while the sink does not answer
+///########## End of Application Option Setting #########
+
+#define SCDC_REG(reg) (scdc_registers[(reg) - SCDC_POLL_FIRST_REG])
+
+typedef enum scdc_state
+{
+    SCDC_STATE_STOPPED,       /* No sink */
+    SCDC_STATE_IDLE,          /* Waiting for the next poll */
+    SCDC_STATE_VERSION_READ,  /* Reading sink version */
+    SCDC_STATE_STATUS_READ,   /* Reading update flags, status flags and error counters */
+    SCDC_STATE_UPDATE_CLEAR,  /* Writing back update flags to clear them */
+} scdc_state_t;
+
+static scdc_state_t           scdc_state = SCDC_STATE_STOPPED;
+static uint32_t               scdc_next_poll_tick;
+static bool                   scdc_is_version_known = false;
+static uint8_t                scdc_sink_version;
+static uint8_t                scdc_registers[SCDC_POLL_LENGTH];
+static uint8_t                scdc_update_clear;
+static scdc_link_statistics_t scdc_link_statistics;
+
+static void scdc_status_evaluate(void)
+{
+    uint8_t last_flags = scdc_link_statistics.status_flags_0;
+    uint8_t flags      = SCDC_REG(SCDC_REG_STATUS_FLAGS_0);
+    uint8_t checksum   = 0;
+
+    scdc_link_statistics.poll_count++;
+    scdc_link_statistics.status_flags_0 = flags;
+    scdc_link_statistics.is_scrambled   = ((SCDC_REG(SCDC_REG_SCRAMBLER_STATUS) & SCDC_SCRAMBLER_STATUS_SCRAMBLED) != 0);
+
+    /* Count falling edges of clock detection and channel lock */
+    if((last_flags & SCDC_STATUS_FLAGS_0_CLOCK_DETECTED) && !(flags & SCDC_STATUS_FLAGS_0_CLOCK_DETECTED))
+    {
+        scdc_link_statistics.clock_lost_count++;
+        APP_PRINT("[HDMI] TMDS clock lost.\r\n");
+    }
+    for(uint32_t ch=0; ch<SCDC_CHANNEL_NUMBER; ch++)
+    {
+        uint8_t locked = (uint8_t)(SCDC_STATUS_FLAGS_0_CH0_LOCKED << ch);
+        if((last_flags & locked) && !(flags & locked))
+        {
+            scdc_link_statistics.channel_unlock_count++;
+            APP_PRINT("[HDMI] TMDS channel %d unlocked.\r\n", ch);
+        }
+    }
+
+    if(SCDC_REG(SCDC_REG_UPDATE_0) & SCDC_UPDATE_0_STATUS_UPDATE)
+    {
+        scdc_link_statistics.status_update_count++;
+    }
+
+    /* Error counters are meaningful when the sink raised CED_Update. The sink resets them when it is cleared. */
+    if(SCDC_REG(SCDC_REG_UPDATE_0) & SCDC_UPDATE_0_CED_UPDATE)
+    {
+        scdc_link_statistics.ced_update_count++;
+
+        /* Sum of the counters and the checksum is 0 */
+        for(uint8_t reg=SCDC_REG_ERR_DET_0_L; reg<=SCDC_REG_ERR_DET_CHECKSUM; reg++)
+        {
+            checksum = (uint8_t)(checksum + SCDC_REG(reg));
+        }
+        if(checksum != 0)
+        {
+            scdc_link_statistics.ced_checksum_error_count++;
+            return;
+        }
+
+        for(uint32_t ch=0; ch<SCDC_CHANNEL_NUMBER; ch++)
+        {
+            uint8_t low  = SCDC_REG(SCDC_REG_ERR_DET_0_L + (2 * ch));
+            uint8_t high = SCDC_REG(SCDC_REG_ERR_DET_0_L + (2 * ch) + 1);
+            if(high & SCDC_ERR_DET_VALID)
+            {
+                scdc_link_statistics.character_error_count[ch] += (((uint32_t)high << 8) | low) & SCDC_ERR_DET_COUNT_MASK;
+            }
+        }
+    }
+}
+
+void scdc_start(void)
+{
+    /* Sink version is read again because the sink may be another one */
+    ddc_transfer_abort();
+    scdc_is_version_known = false;
+    scdc_link_statistics.is_present     = false;
+    scdc_link_statistics.status_flags_0 = 0;
+    scdc_link_statistics.is_declared    = edid_scdc_present_check();
+
+    /* Sinks without SCDC_Present may use DDC address 0x54 for something else */
+    if(!scdc_link_statistics.is_declared)
+    {
+        APP_PRINT("[HDMI] SCDC is not declared in the sink EDID. Not polled.\r\n");
+        scdc_state = SCDC_STATE_STOPPED;
+        return;
+    }
+
+    scdc_next_poll_tick = system_tick_get();
+    scdc_state = SCDC_STATE_IDLE;
+}
+
+void scdc_stop(void)
+{
+    if((SCDC_STATE_STOPPED != scdc_state) && (SCDC_STATE_IDLE != scdc_state))
+    {
+        ddc_transfer_abort();
+    }
+    scdc_link_statistics.is_present = false;
+    scdc_state = SCDC_STATE_STOPPED;
+}
+
+void scdc_process(void)
+{
+    fsp_err_t fsp_err;
+
+    switch(scdc_state)
+    {
+        case SCDC_STATE_IDLE:
+            if(!SYSTEM_TICK_IS_REACHED(scdc_next_poll_tick))
+            {
+                break;
+            }
+
+            if(!scdc_is_version_known)
+            {
+                fsp_err = ddc_read_start(HDMI_DDC_I2C_ADDR_SCDC, SCDC_REG_SINK_VERSION, &scdc_sink_version, 1);
+                scdc_state = SCDC_STATE_VERSION_READ;
+            }
+            else
+            {
+                /* All registers of interest are read in one transaction */
+                fsp_err = ddc_read_start(HDMI_DDC_I2C_ADDR_SCDC, SCDC_POLL_FIRST_REG, &scdc_registers[0], SCDC_POLL_LENGTH);
+                scdc_state = SCDC_STATE_STATUS_READ;
+            }
+
+            if(FSP_SUCCESS != fsp_err)
+            {
+                /* DDC is used by another transfer. Try again next time. */
+                scdc_state = SCDC_STATE_IDLE;
+                scdc_next_poll_tick = system_tick_get() + SCDC_POLL_INTERVAL_MS;
+            }
+            break;
+
+        case SCDC_STATE_VERSION_READ:
+            fsp_err = ddc_transfer_poll();
+            if(FSP_ERR_IN_USE == fsp_err)
+            {
+                break;
+            }
+
+            scdc_state = SCDC_STATE_IDLE;
+            if(FSP_SUCCESS != fsp_err)
+            {
+                /* Sinks before HDMI 2.0 have no SCDC */
+                scdc_link_statistics.no_response_count++;
+                scdc_next_poll_tick = system_tick_get() + SCDC_ABSENT_RETRY_INTERVAL_MS;
+                break;
+            }
+
+            scdc_is_version_known = true;
+            scdc_link_statistics.is_present   = true;
+            scdc_link_statistics.sink_version = scdc_sink_version;
+            APP_PRINT("[HDMI] SCDC sink version %d.\r\n", scdc_sink_version);
+            break;
+
+        case SCDC_STATE_STATUS_READ:
+            fsp_err = ddc_transfer_poll();
+            if(FSP_ERR_IN_USE == fsp_err)
+            {
+                break;
+            }
+
+            scdc_state = SCDC_STATE_IDLE;
+            scdc_next_poll_tick = system_tick_get() + SCDC_POLL_INTERVAL_MS;
+            if(FSP_SUCCESS != fsp_err)
+            {
+                scdc_link_statistics.no_response_count++;
+                break;
+            }
+
+            scdc_status_evaluate();
+
+            /* Update flags are cleared by writing 1 to them */
+            scdc_update_clear = SCDC_REG(SCDC_REG_UPDATE_0) & (SCDC_UPDATE_0_STATUS_UPDATE | SCDC_UPDATE_0_CED_UPDATE);
+            if(scdc_update_clear != 0)
+            {
+                if(FSP_SUCCESS == ddc_write_start(HDMI_DDC_I2C_ADDR_SCDC, SCDC_REG_UPDATE_0, &scdc_update_clear, 1))
+                {
+                    scdc_state = SCDC_STATE_UPDATE_CLEAR;
+                }
+            }
+            break;
+
+        case SCDC_STATE_UPDATE_CLEAR:
+            fsp_err = ddc_transfer_poll();
+            if(FSP_ERR_IN_USE == fsp_err)
+            {
+                break;
+            }
+
+            scdc_state = SCDC_STATE_IDLE;
+            if(FSP_SUCCESS != fsp_err)
+            {
+                scdc_link_statistics.no_response_count++;
+            }
+            break;
+
+        default:
+            /* Stopped */
+            break;
+    }
+}
+
+scdc_link_statistics_t const * scdc_link_statistics_get(void)
+{
+    return &scdc_link_statistics;
+}
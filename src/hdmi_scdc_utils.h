@@ -0,0 +1,79 @@
+/***********************************************************************************************************************
+ * File Name    : hdmi_scdc_utils.h
+ * Description  : Contains data structures and functions used in hdmi_scdc_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef __HDMI_SCDC_UTILS_H__
+#define __HDMI_SCDC_UTILS_H__
+#include "hal_data.h"
+
+/*
+ * SCDC (Status and Control Data Channel) registers at DDC address 0x54
+ */
+#define SCDC_REG_SINK_VERSION      (0x01)
+#define SCDC_REG_SOURCE_VERSION    (0x02)
+#define SCDC_REG_UPDATE_0          (0x10)
+#define SCDC_REG_UPDATE_1          (0x11)
+#define SCDC_REG_TMDS_CONFIG       (0x20)
+#define SCDC_REG_SCRAMBLER_STATUS  (0x21)
+#define SCDC_REG_CONFIG_0          (0x30)
+#define SCDC_REG_STATUS_FLAGS_0    (0x40)
+#define SCDC_REG_STATUS_FLAGS_1    (0x41)
+#define SCDC_REG_ERR_DET_0_L       (0x50)
+#define SCDC_REG_ERR_DET_CHECKSUM  (0x56)
+
+/* Registers read in one transaction every poll */
+#define SCDC_POLL_FIRST_REG        (SCDC_REG_UPDATE_0)
+#define SCDC_POLL_LAST_REG         (SCDC_REG_ERR_DET_CHECKSUM)
+#define SCDC_POLL_LENGTH           (SCDC_POLL_LAST_REG - SCDC_POLL_FIRST_REG + 1)
+
+#define SCDC_UPDATE_0_STATUS_UPDATE     (0x01)
+#define SCDC_UPDATE_0_CED_UPDATE        (0x02)
+#define SCDC_STATUS_FLAGS_0_CLOCK_DETECTED (0x01)
+#define SCDC_STATUS_FLAGS_0_CH0_LOCKED  (0x02) /* Ch1 and Ch2 follow in the next bits */
+#define SCDC_SCRAMBLER_STATUS_SCRAMBLED (0x01)
+#define SCDC_ERR_DET_VALID              (0x80) /* In the high byte of each counter */
+#define SCDC_ERR_DET_COUNT_MASK         (0x7FFF)
+#define SCDC_CHANNEL_NUMBER             (3)
+
+/* Link health seen through SCDC */
+typedef struct scdc_link_statistics
+{
+    bool     is_declared;                 ///< SCDC_Present set in HF-VSDB of the sink EDID. Not polled otherwise
+    bool     is_present;                  ///< Sink answered at SCDC address
+    uint8_t  sink_version;
+    uint8_t  status_flags_0;              ///< Latest Status_Flags_0
+    bool     is_scrambled;
+    uint32_t poll_count;                  ///< Successful status reads
+    uint32_t no_response_count;           ///< Failed transfers, e.g. NACK from a sink without SCDC
+    uint32_t clock_lost_count;            ///< Clock_Detected went 1 to 0
+    uint32_t channel_unlock_count;        ///< Ch_Locked of any channel went 1 to 0
+    uint32_t status_update_count;         ///< Status_Update flag raised by the sink
+    uint32_t ced_update_count;            ///< CED_Update flag raised by the sink
+    uint32_t ced_checksum_error_count;    ///< Error counters discarded by their checksum
+    uint32_t character_error_count[SCDC_CHANNEL_NUMBER]; ///< Accumulated character errors per channel
+} scdc_link_statistics_t;
+
+void scdc_start(void);
+void scdc_stop(void);
+void scdc_process(void);
+scdc_link_statistics_t const * scdc_link_statistics_get(void);
+
+#endif /* End of __HDMI_SCDC_UTILS_H__ */
@@ -0,0 +1,397 @@
+/***********************************************************************************************************************
+ * File Name    : cec_host_fake.c
+ * Description  : Fake FSP drivers and CEC line of the host tests. The application code runs unchanged on top of them.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdarg.h>
+#include "cec_host_fake.h"
+#include "../../src/application_utils.h"
+#include "../../src/data_flash_utils.h"
+
+/* Time of a frame on the line. Start bit 4.5 ms and 24 ms per block. */
+#define CEC_HOST_FRAME_MS(blocks)        ((4500U + (24000U * (uint32_t)(blocks)) + 999U) / 1000U)
+#define CEC_HOST_ARBITRATION_LOST_MS     (5U)  // Arbitration is lost in the initiator bits of the header block
+
+cec_host_tx_frame_t cec_host_tx_frame_list[CEC_HOST_TX_FRAME_NUMBER];
+uint32_t            cec_host_tx_frame_count = 0;
+uint16_t            cec_host_occupied_address_bitmap = 0;
+bool                cec_host_hpd_level = false;
+bool                cec_host_is_verbose = false;
+
+static cec_error_t               cec_host_tx_outcome_queue[CEC_HOST_TX_OUTCOME_NUMBER];
+static uint32_t                  cec_host_tx_outcome_read_point = 0;
+static uint32_t                  cec_host_tx_outcome_count = 0;
+static cec_host_tx_outcome_get_t cec_host_tx_outcome_function = NULL;
+static bool                      cec_host_tx_is_pending = false;
+static uint32_t                  cec_host_tx_complete_tick;
+static cec_error_t               cec_host_tx_pending_outcome;
+static cec_state_t               cec_host_cec_state = CEC_STATE_UNINIT;
+
+/* Target environment */
+static SysTick_Type   cec_host_systick = {0, 99999, 99999, 0};
+static DWT_Type       cec_host_dwt;
+static CoreDebug_Type cec_host_core_debug;
+static SCB_Type       cec_host_scb;
+static R_CEC_Type     cec_host_cec_registers;
+SysTick_Type   * SysTick   = &cec_host_systick;
+DWT_Type       * DWT       = &cec_host_dwt;
+CoreDebug_Type * CoreDebug = &cec_host_core_debug;
+SCB_Type       * SCB       = &cec_host_scb;
+R_CEC_Type     * R_CEC     = &cec_host_cec_registers;
+uint32_t         SystemCoreClock = 100000000;
+
+/* Driver instances generated by FSP configurator */
+ioport_instance_ctrl_t     g_ioport_ctrl;
+const ioport_cfg_t         g_bsp_pin_cfg;
+cec_instance_ctrl_t        g_cec0_ctrl;
+const cec_cfg_t            g_cec0_cfg;
+sci_i2c_instance_ctrl_t    g_ddc_source_i2c_master_ctrl;
+const i2c_master_cfg_t     g_ddc_source_i2c_master_cfg = {-1, -1, -1, -1, NULL, NULL};
+static transfer_info_t     cec_host_transfer_info;
+static transfer_cfg_t      cec_host_transfer_cfg = {&cec_host_transfer_info};
+const transfer_instance_t  g_ddc_transfer_rx = {NULL, &cec_host_transfer_cfg, NULL};
+icu_instance_ctrl_t        g_external_irq_sw1_ctrl;
+icu_instance_ctrl_t        g_external_irq_sw2_ctrl;
+icu_instance_ctrl_t        g_external_irq_hpd_ctrl;
+const external_irq_cfg_t   g_external_irq_sw1_cfg;
+const external_irq_cfg_t   g_external_irq_sw2_cfg;
+const external_irq_cfg_t   g_external_irq_hpd_cfg;
+gpt_instance_ctrl_t        g_led_pwm_gpt_timer_ctrl;
+const timer_cfg_t          g_led_pwm_gpt_timer_cfg = {1000};
+gpt_instance_ctrl_t        g_cec_timing_gpt_timer_ctrl;
+const timer_cfg_t          g_cec_timing_gpt_timer_cfg = {0xFFFFFFFF};
+flash_hp_instance_ctrl_t   g_flash0_ctrl;
+const flash_cfg_t          g_flash0_cfg;
+
+void SysTick_Handler(void);
+
+void cec_host_fatal_error(char const * p_file, int line)
+{
+    /* ERROR_INDICATE_LED_ON; __BKPT(0); on the target */
+    fprintf(stderr, "%s:%d: fatal error of the application\n", p_file, line);
+    abort();
+}
+
+void cec_host_reset(void)
+{
+    cec_host_tx_frame_count = 0;
+    cec_host_tx_outcome_read_point = 0;
+    cec_host_tx_outcome_count = 0;
+    cec_host_tx_outcome_function = NULL;
+    cec_host_tx_is_pending = false;
+    cec_host_occupied_address_bitmap = 0;
+}
+
+static void cec_host_tx_complete(void)
+{
+    cec_callback_args_t args = {0};
+
+    cec_host_tx_is_pending = false;
+    cec_host_cec_state = CEC_STATE_READY;
+    cec_host_tx_frame_list[cec_host_tx_frame_count - 1].end_tick = system_tick_get();
+
+    if(0 == cec_host_tx_pending_outcome)
+    {
+        args.event = CEC_EVENT_TX_COMPLETE;
+    }
+    else
+    {
+        args.event  = CEC_EVENT_ERR;
+        args.errors = cec_host_tx_pending_outcome;
+    }
+    cec_interrupt_callback(&args);
+}
+
+void cec_host_tick_advance(uint32_t ms)
+{
+    for(uint32_t i = 0; i < ms; i++)
+    {
+        SysTick_Handler();
+
+        if(cec_host_tx_is_pending && ((int32_t)(system_tick_get() - cec_host_tx_complete_tick) >= 0))
+        {
+            cec_host_tx_complete();
+        }
+    }
+}
+
+void cec_host_tx_outcome_push(cec_error_t outcome)
+{
+    if(cec_host_tx_outcome_count >= CEC_HOST_TX_OUTCOME_NUMBER)
+    {
+        abort();
+    }
+
+    cec_host_tx_outcome_queue[(cec_host_tx_outcome_read_point + cec_host_tx_outcome_count) % CEC_HOST_TX_OUTCOME_NUMBER] = outcome;
+    cec_host_tx_outcome_count++;
+}
+
+void cec_host_tx_outcome_function_set(cec_host_tx_outcome_get_t p_function)
+{
+    cec_host_tx_outcome_function = p_function;
+}
+
+bool cec_host_tx_is_busy(void)
+{
+    return cec_host_tx_is_pending;
+}
+
+void cec_host_rx_bytes(uint8_t const * p_bytes, uint32_t length)
+{
+    cec_callback_args_t args = {0};
+
+    for(uint32_t i = 0; i < length; i++)
+    {
+        args.event     = CEC_EVENT_RX_DATA;
+        args.data_byte = p_bytes[i];
+        cec_interrupt_callback(&args);
+    }
+
+    args.event = CEC_EVENT_RX_COMPLETE;
+    cec_interrupt_callback(&args);
+}
+
+void cec_host_rx_frame(uint8_t source, uint8_t destination, uint8_t opcode, uint8_t const * p_data, uint8_t data_length)
+{
+    uint8_t bytes[2 + CEC_DATA_BUFFER_LENGTH];
+
+    bytes[0] = (uint8_t)((source << 4) | destination);
+    bytes[1] = opcode;
+    if(data_length > 0)
+    {
+        memcpy(&bytes[2], p_data, data_length);
+    }
+
+    cec_host_rx_bytes(&bytes[0], 2U + data_length);
+}
+
+/* r_cec. Frames are recorded and completed after their time on the line with the scripted outcome. */
+fsp_err_t R_CEC_Open(cec_instance_ctrl_t * p_ctrl, cec_cfg_t const * p_cfg)
+{
+    (void)p_cfg;
+    p_ctrl->open = 1;
+    cec_host_cec_state = CEC_STATE_INIT;
+    return FSP_SUCCESS;
+}
+
+fsp_err_t R_CEC_MediaInit(cec_instance_ctrl_t * p_ctrl, cec_addr_t local_address)
+{
+    /* Polling message. The address is free when no other device acknowledges it. */
+    p_ctrl->local_address = local_address;
+    R_CEC->CADR = (uint16_t)(1U << local_address);
+    if((CEC_ADDR_UNREGISTERED != local_address) && (cec_host_occupied_address_bitmap & (1U << local_address)))
+    {
+        cec_host_cec_state = CEC_STATE_INIT;
+    }
+    else
+    {
+        cec_host_cec_state = CEC_STATE_READY;
+    }
+    return FSP_SUCCESS;
+}
+
+fsp_err_t R_CEC_Write(cec_instance_ctrl_t * p_ctrl, cec_message_t const * p_message, uint32_t message_size)
+{
+    cec_host_tx_frame_t * p_frame;
+
+    if(cec_host_tx_is_pending || (message_size < 1) || (message_size > (2 + CEC_DATA_BUFFER_LENGTH)))
+    {
+        return FSP_ERR_IN_USE;
+    }
+    if(cec_host_tx_frame_count >= CEC_HOST_TX_FRAME_NUMBER)
+    {
+        abort();
+    }
+
+    p_frame = &cec_host_tx_frame_list[cec_host_tx_frame_count++];
+    memset(p_frame, 0, sizeof(cec_host_tx_frame_t));
+    p_frame->start_tick  = system_tick_get();
+    p_frame->source      = (uint8_t)p_ctrl->local_address;
+    p_frame->cadr        = R_CEC->CADR;
+    p_frame->destination = p_message->destination;
+    p_frame->opcode      = p_message->opcode;
+    p_frame->length      = (uint8_t)message_size;
+    if(message_size > 2)
+    {
+        memcpy(&p_frame->data[0], &p_message->data[0], message_size - 2);
+    }
+
+    if(cec_host_tx_outcome_count > 0)
+    {
+        p_frame->outcome = cec_host_tx_outcome_queue[cec_host_tx_outcome_read_point];
+        cec_host_tx_outcome_read_point = (cec_host_tx_outcome_read_point + 1) % CEC_HOST_TX_OUTCOME_NUMBER;
+        cec_host_tx_outcome_count--;
+    }
+    else if(NULL != cec_host_tx_outcome_function)
+    {
+        p_frame->outcome = cec_host_tx_outcome_function(p_frame);
+    }
+    else
+    {
+        p_frame->outcome = 0;
+    }
+
+    /* Arbitration is lost in the header, NACK and TX errors end the frame at the failing block */
+    if(p_frame->outcome & CEC_ERROR_AERR)
+    {
+        cec_host_tx_complete_tick = system_tick_get() + CEC_HOST_ARBITRATION_LOST_MS;
+    }
+    else if(0 != p_frame->outcome)
+    {
+        cec_host_tx_complete_tick = system_tick_get() + CEC_HOST_FRAME_MS(1);
+    }
+    else
+    {
+        cec_host_tx_complete_tick = system_tick_get() + CEC_HOST_FRAME_MS(message_size);
+    }
+    cec_host_tx_pending_outcome = p_frame->outcome;
+    cec_host_tx_is_pending = true;
+    cec_host_cec_state = CEC_STATE_TX_ACTIVE;
+
+    return FSP_SUCCESS;
+}
+
+fsp_err_t R_CEC_StatusGet(cec_instance_ctrl_t * p_ctrl, cec_status_t * p_status)
+{
+    (void)p_ctrl;
+
+    /* Callers poll the status in a loop, so the time goes on */
+    cec_host_tick_advance(1);
+    p_status->state = cec_host_cec_state;
+    return FSP_SUCCESS;
+}
+
+fsp_err_t R_CEC_Close(cec_instance_ctrl_t * p_ctrl)
+{
+    p_ctrl->open = 0;
+    cec_host_cec_state = CEC_STATE_UNINIT;
+    return FSP_SUCCESS;
+}
+
+/* BSP and core */
+void R_BSP_SoftwareDelay(uint32_t delay, bsp_delay_units_t units)
+{
+    cec_host_tick_advance((delay * (uint32_t)units + 999U) / 1000U);
+}
+
+fsp_err_t R_FSP_VersionGet(fsp_pack_version_t * const p_version)
+{
+    p_version->version_id = 0;
+    return FSP_SUCCESS;
+}
+
+uint32_t SysTick_Config(uint32_t ticks)
+{
+    (void)ticks;
+    return 0;
+}
+
+/* r_ioport. Only the hot plug detect pin is read. */
+fsp_err_t R_IOPORT_Open(ioport_instance_ctrl_t * p_ctrl, const ioport_cfg_t * p_cfg) { (void)p_ctrl; (void)p_cfg; return FSP_SUCCESS; }
+fsp_err_t R_IOPORT_PinWrite(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, bsp_io_level_t level) { (void)p_ctrl; (void)pin; (void)level; return FSP_SUCCESS; }
+fsp_err_t R_IOPORT_PinCfg(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, uint32_t cfg) { (void)p_ctrl; (void)pin; (void)cfg; return FSP_SUCCESS; }
+fsp_err_t R_IOPORT_PinRead(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, bsp_io_level_t * p_pin_value)
+{
+    (void)p_ctrl;
+    (void)pin;
+    *p_pin_value = cec_host_hpd_level ? BSP_IO_LEVEL_HIGH : BSP_IO_LEVEL_LOW;
+    return FSP_SUCCESS;
+}
+
+/* r_sci_i2c. There is no sink on the DDC. */
+fsp_err_t R_SCI_I2C_Open(sci_i2c_instance_ctrl_t * p_ctrl, i2c_master_cfg_t const * p_cfg) { (void)p_ctrl; (void)p_cfg; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Close(sci_i2c_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_SCI_I2C_Read(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_dest, uint32_t bytes, bool restart) { (void)p_ctrl; (void)p_dest; (void)bytes; (void)restart; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Write(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_src, uint32_t bytes, bool restart) { (void)p_ctrl; (void)p_src; (void)bytes; (void)restart; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Abort(sci_i2c_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_SCI_I2C_SlaveAddressSet(sci_i2c_instance_ctrl_t * p_ctrl, uint32_t slave, i2c_master_addr_mode_t addr_mode) { (void)p_ctrl; (void)slave; (void)addr_mode; return FSP_ERR_UNSUPPORTED; }
+
+/* r_icu */
+fsp_err_t R_ICU_ExternalIrqOpen(icu_instance_ctrl_t * p_ctrl, external_irq_cfg_t const * p_cfg) { (void)p_ctrl; (void)p_cfg; return FSP_SUCCESS; }
+fsp_err_t R_ICU_ExternalIrqEnable(icu_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_ICU_ExternalIrqDisable(icu_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+
+/* r_gpt */
+fsp_err_t R_GPT_Open(gpt_instance_ctrl_t * p_ctrl, timer_cfg_t const * p_cfg) { (void)p_ctrl; (void)p_cfg; return FSP_SUCCESS; }
+fsp_err_t R_GPT_Close(gpt_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_GPT_Start(gpt_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_GPT_Stop(gpt_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_GPT_Enable(gpt_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_GPT_Disable(gpt_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_SUCCESS; }
+fsp_err_t R_GPT_DutyCycleSet(gpt_instance_ctrl_t * p_ctrl, uint32_t duty_cycle_counts, uint32_t pin) { (void)p_ctrl; (void)duty_cycle_counts; (void)pin; return FSP_SUCCESS; }
+fsp_err_t R_GPT_StatusGet(gpt_instance_ctrl_t * p_ctrl, timer_status_t * p_status)
+{
+    (void)p_ctrl;
+    p_status->counter = 0;
+    p_status->state = TIMER_STATE_STOPPED;
+    return FSP_SUCCESS;
+}
+fsp_err_t R_GPT_InfoGet(gpt_instance_ctrl_t * p_ctrl, timer_info_t * p_info)
+{
+    (void)p_ctrl;
+    p_info->clock_frequency = SystemCoreClock;
+    p_info->period_counts = 0xFFFFFFFF;
+    return FSP_SUCCESS;
+}
+
+/* data_flash_utils.c reads the data flash by address, so it is replaced. The host has no saved state. */
+fsp_err_t device_state_storage_initialize(device_state_t * p_state)
+{
+    (void)p_state;
+    return FSP_ERR_NOT_FOUND;
+}
+
+void device_state_storage_update(device_state_t const * p_state)
+{
+    (void)p_state;
+}
+
+void device_state_storage_process(void)
+{
+}
+
+/* SEGGER RTT. APP_PRINT goes to stdout in verbose mode, and no key is entered. */
+int SEGGER_RTT_printf(unsigned BufferIndex, const char * sFormat, ...)
+{
+    va_list args;
+    int     length = 0;
+
+    (void)BufferIndex;
+    if(cec_host_is_verbose)
+    {
+        va_start(args, sFormat);
+        length = vprintf(sFormat, args);
+        va_end(args);
+    }
+    return length;
+}
+
+int      SEGGER_RTT_HasKey(void) { return 0; }
+unsigned SEGGER_RTT_HasDataUp(unsigned BufferIndex) { (void)BufferIndex; return 0; }
+unsigned SEGGER_RTT_Read(unsigned BufferIndex, void * pBuffer, unsigned BufferSize) { (void)BufferIndex; (void)pBuffer; (void)BufferSize; return 0; }
+unsigned SEGGER_RTT_Write(unsigned BufferIndex, const void * pBuffer, unsigned NumBytes) { (void)BufferIndex; (void)pBuffer; return NumBytes; }
+unsigned SEGGER_RTT_GetAvailWriteSpace(unsigned BufferIndex) { (void)BufferIndex; return 1024; }
+int      SEGGER_RTT_ConfigUpBuffer(unsigned BufferIndex, const char * sName, void * pBuffer, unsigned BufferSize, unsigned Flags)
+{
+    (void)BufferIndex; (void)sName; (void)pBuffer; (void)BufferSize; (void)Flags;
+    return 0;
+}
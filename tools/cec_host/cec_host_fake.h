@@ -0,0 +1,61 @@
+/***********************************************************************************************************************
+ * File Name    : cec_host_fake.h
+ * Description  : Fake FSP drivers and CEC line of the host tests. The application code runs unchanged on top of them.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef CEC_HOST_FAKE_H_
+#define CEC_HOST_FAKE_H_
+#include "hal_data.h"
+
+#define CEC_HOST_TX_FRAME_NUMBER   (4096)
+#define CEC_HOST_TX_OUTCOME_NUMBER (64)
+
+/* An attempt started by R_CEC_Write() */
+typedef struct cec_host_tx_frame
+{
+    uint32_t    start_tick;
+    uint32_t    end_tick;    ///< Completion or error event
+    uint8_t     source;      ///< Local address of the driver at R_CEC_Write()
+    uint16_t    cadr;        ///< Acknowledged addresses at R_CEC_Write()
+    uint8_t     destination;
+    uint8_t     opcode;
+    uint8_t     data[CEC_DATA_BUFFER_LENGTH];
+    uint8_t     length;      ///< Header and opcode included
+    cec_error_t outcome;     ///< 0: Acknowledged
+} cec_host_tx_frame_t;
+
+/* Outcome of an attempt. 0 is acknowledged, otherwise the errors reported by the CEC_EVENT_ERR */
+typedef cec_error_t (* cec_host_tx_outcome_get_t)(cec_host_tx_frame_t const * p_frame);
+
+extern cec_host_tx_frame_t cec_host_tx_frame_list[CEC_HOST_TX_FRAME_NUMBER];
+extern uint32_t            cec_host_tx_frame_count;
+extern uint16_t            cec_host_occupied_address_bitmap; ///< Bit n: another device acknowledges polling of address n
+extern bool                cec_host_hpd_level;
+extern bool                cec_host_is_verbose;              ///< Print APP_PRINT output
+
+void        cec_host_reset(void);
+void        cec_host_tick_advance(uint32_t ms);
+void        cec_host_tx_outcome_push(cec_error_t outcome);
+void        cec_host_tx_outcome_function_set(cec_host_tx_outcome_get_t p_function);
+bool        cec_host_tx_is_busy(void);
+void        cec_host_rx_frame(uint8_t source, uint8_t destination, uint8_t opcode, uint8_t const * p_data, uint8_t data_length);
+void        cec_host_rx_bytes(uint8_t const * p_bytes, uint32_t length);
+
+#endif /* CEC_HOST_FAKE_H_ */
@@ -0,0 +1,781 @@
+/***********************************************************************************************************************
+ * File Name    : cec_host_test.c
+ * Description  : Host tests of the CEC stack in hal_entry.c, driven by a fake tick and fake CEC line.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+
+/*
+ * hal_entry.c is built for the host together with this file. The FSP drivers are replaced by cec_host_fake.c:
+ * R_CEC_Write() records the frame and completes it after its time on the line, with the outcome scripted by the test.
+ * The system tick only advances when a test calls cec_host_tick_advance() or runs the main loop.
+ * Each test runs in its own process, so it starts from the state after boot.
+ *
+ * Build and run (from the repository root):
+ *   gcc -g -O1 -fsanitize=address,undefined -fno-sanitize-recover=all -Itools/cec_host \
+ *       tools/cec_host/cec_host_test.c tools/cec_host/cec_host_fake.c src/application_utils.c src/hdmi_cec_utils.c \
+ *       src/hdmi_ddc_utils.c src/hdmi_scdc_utils.c src/hdmi_ddc_ci_utils.c src/cec_monitor_utils.c \
+ *       src/cec_timing_utils.c -o cec_host_test
+ *   ./cec_host_test [-v] [<test name> ...]
+ * -v prints the APP_PRINT output of the application.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <sys/wait.h>
+#include "../../src/hal_entry.c"
+#include "cec_host_fake.h"
+
+#define CEC_HOST_SEND_TIMEOUT_MS (10000) // Bound of a wait for a TX result, so a stuck queue fails the test
+#define CEC_HOST_CONTENTION_MESSAGE_NUMBER (1000)
+
+#define CEC_HOST_ASSERT(condition) \
+    do { \
+        if(!(condition)) \
+        { \
+            fflush(stdout); \
+            fprintf(stderr, "%s:%d: assertion failed: %s\n", __FILE__, __LINE__, #condition); \
+            exit(1); \
+        } \
+    } while(0)
+
+typedef struct cec_host_test
+{
+    char const * p_name;
+    void (* p_function)(void);
+} cec_host_test_t;
+
+/* Boot sequence of hal_entry() from R_CEC_Open(), with a free bus */
+static void cec_host_boot(void)
+{
+    R_CEC_Open(&g_cec0_ctrl, &g_cec0_cfg);
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_logical_address_allocate(CEC_ADDR_UNREGISTERED));
+    cec_my_device_status_update(0x1);
+    cec_host_tx_frame_count = 0;
+}
+
+/* Background part of the main loop of hal_entry(), 1 ms per turn. CEC actions are consumed without effect. */
+static void cec_host_main_loop(uint32_t ms)
+{
+    for(uint32_t i = 0; i < ms; i++)
+    {
+        cec_rx_data_check();
+        cec_action_request_detect_flag = false;
+
+        cec_key_hold_process();
+        cec_key_process();
+        cec_tx_process();
+        cec_reply_process();
+        cec_system_audio_process();
+        cec_arc_process();
+
+        cec_host_tick_advance(1);
+    }
+}
+
+/* Runs the main loop until the result is written */
+static void cec_host_result_wait(fsp_err_t volatile * p_result)
+{
+    uint32_t deadline = system_tick_get() + CEC_HOST_SEND_TIMEOUT_MS;
+
+    while(FSP_ERR_IN_USE == *p_result)
+    {
+        CEC_HOST_ASSERT(!SYSTEM_TICK_IS_REACHED(deadline));
+        cec_host_main_loop(1);
+    }
+}
+
+/* Frames recorded by the fake line, counting from the first */
+static uint32_t cec_host_tx_opcode_count(uint32_t first, uint8_t opcode)
+{
+    uint32_t count = 0;
+
+    for(uint32_t i = first; i < cec_host_tx_frame_count; i++)
+    {
+        if(cec_host_tx_frame_list[i].opcode == opcode)
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+/*** Retransmission (user-026) ***/
+
+static void cec_host_test_tx_retry_class(void)
+{
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_ARBITRATION_LOST == cec_tx_retry_class_get(CEC_ERROR_AERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_NACK == cec_tx_retry_class_get(CEC_ERROR_ACKERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_TX_ERROR == cec_tx_retry_class_get(CEC_ERROR_TXERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_NONE == cec_tx_retry_class_get(CEC_ERROR_UERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_NONE == cec_tx_retry_class_get(CEC_ERROR_BLERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_NONE == cec_tx_retry_class_get(CEC_ERROR_AERR | CEC_ERROR_BLERR));
+    CEC_HOST_ASSERT(CEC_TX_RETRY_CLASS_ARBITRATION_LOST == cec_tx_retry_class_get(CEC_ERROR_AERR | CEC_ERROR_ACKERR));
+
+    /* 3 bit periods after a failed attempt, 5 for a new initiator, 7 for the next frame */
+    CEC_HOST_ASSERT(7200 == cec_tx_retry_signal_free_time_us_get(CEC_TX_RETRY_CLASS_NACK));
+    CEC_HOST_ASSERT(7200 == cec_tx_retry_signal_free_time_us_get(CEC_TX_RETRY_CLASS_TX_ERROR));
+    CEC_HOST_ASSERT(12000 == cec_tx_retry_signal_free_time_us_get(CEC_TX_RETRY_CLASS_ARBITRATION_LOST));
+    CEC_HOST_ASSERT(16800 == cec_tx_retry_signal_free_time_us_get(CEC_TX_RETRY_CLASS_NONE));
+}
+
+static void cec_host_test_tx_retry_after_nack_and_tx_error(void)
+{
+    fsp_err_t result = FSP_ERR_IN_USE;
+
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_host_tx_outcome_push(CEC_ERROR_TXERR);
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+
+    CEC_HOST_ASSERT(FSP_SUCCESS == result);
+    CEC_HOST_ASSERT(3 == cec_host_tx_frame_count);
+    for(uint32_t i = 1; i < cec_host_tx_frame_count; i++)
+    {
+        /* Retransmission waits at least 3 bit periods (7.2 ms) after the failed attempt */
+        uint32_t gap = cec_host_tx_frame_list[i].start_tick - cec_host_tx_frame_list[i - 1].end_tick;
+        CEC_HOST_ASSERT(gap >= 8);
+    }
+    CEC_HOST_ASSERT(1 == cec_tx_statistics.nack_count);
+    CEC_HOST_ASSERT(1 == cec_tx_statistics.tx_error_count);
+    CEC_HOST_ASSERT(1 == cec_tx_statistics.success_after_retry_count);
+    CEC_HOST_ASSERT(1 == cec_tx_statistics.attempt_histogram[2]);
+}
+
+static void cec_host_test_tx_retry_after_arbitration_lost(void)
+{
+    fsp_err_t result = FSP_ERR_IN_USE;
+
+    /* Arbitration losses do not use up the retries of NACK */
+    for(uint32_t i = 0; i < APP_CEC_TX_ARBITRATION_RETRY_COUNT; i++)
+    {
+        cec_host_tx_outcome_push(CEC_ERROR_AERR);
+    }
+    for(uint32_t i = 0; i < APP_CEC_TX_RETRY_COUNT; i++)
+    {
+        cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    }
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+
+    CEC_HOST_ASSERT(FSP_SUCCESS == result);
+    CEC_HOST_ASSERT((APP_CEC_TX_ARBITRATION_RETRY_COUNT + APP_CEC_TX_RETRY_COUNT + 1) == cec_host_tx_frame_count);
+    for(uint32_t i = 1; i <= APP_CEC_TX_ARBITRATION_RETRY_COUNT; i++)
+    {
+        /* After losing, we wait as a new initiator: 5 bit periods (12 ms) */
+        uint32_t gap = cec_host_tx_frame_list[i].start_tick - cec_host_tx_frame_list[i - 1].end_tick;
+        CEC_HOST_ASSERT(gap >= 12);
+    }
+    CEC_HOST_ASSERT(APP_CEC_TX_ARBITRATION_RETRY_COUNT == cec_tx_statistics.arbitration_lost_count);
+    CEC_HOST_ASSERT(APP_CEC_TX_RETRY_COUNT == cec_tx_statistics.nack_count);
+}
+
+static void cec_host_test_tx_retry_exhausted(void)
+{
+    fsp_err_t result = FSP_ERR_IN_USE;
+
+    for(uint32_t i = 0; i < (APP_CEC_TX_RETRY_COUNT + 1); i++)
+    {
+        cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    }
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+
+    CEC_HOST_ASSERT(FSP_ERR_ASSERTION == result);
+    CEC_HOST_ASSERT(CEC_ERROR_ACKERR == cec_tx_last_error);
+    CEC_HOST_ASSERT((APP_CEC_TX_RETRY_COUNT + 1) == cec_host_tx_frame_count);
+    CEC_HOST_ASSERT(1 == cec_tx_statistics.error_count);
+
+    /* The queue goes on with the next message */
+    result = FSP_ERR_IN_USE;
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+    CEC_HOST_ASSERT(FSP_SUCCESS == result);
+}
+
+static void cec_host_test_tx_no_retry_on_bus_error(void)
+{
+    fsp_err_t result = FSP_ERR_IN_USE;
+
+    cec_host_tx_outcome_push(CEC_ERROR_UERR);
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+
+    CEC_HOST_ASSERT(FSP_ERR_ASSERTION == result);
+    CEC_HOST_ASSERT(1 == cec_host_tx_frame_count);
+}
+
+/* Bus shared with a busy TV and a flaky follower. Outcomes of the attempts are independent. */
+static uint32_t cec_host_contention_random = 2463534242UL;
+
+static cec_error_t cec_host_contention_outcome_get(cec_host_tx_frame_t const * p_frame)
+{
+    uint32_t percent;
+
+    (void)p_frame;
+    cec_host_contention_random ^= cec_host_contention_random << 13;
+    cec_host_contention_random ^= cec_host_contention_random >> 17;
+    cec_host_contention_random ^= cec_host_contention_random << 5;
+    percent = cec_host_contention_random % 100;
+
+    if(percent < 30)
+    {
+        return CEC_ERROR_AERR;
+    }
+    else if(percent < 40)
+    {
+        return CEC_ERROR_ACKERR;
+    }
+    else if(percent < 45)
+    {
+        return CEC_ERROR_TXERR;
+    }
+    return 0;
+}
+
+static void cec_host_test_tx_delivery_under_contention(void)
+{
+    uint32_t delivered = 0;
+    uint32_t first_attempt_delivered = 0;
+    uint32_t start_tick = system_tick_get();
+
+    cec_host_tx_outcome_function_set(cec_host_contention_outcome_get);
+
+    for(uint32_t i = 0; i < CEC_HOST_CONTENTION_MESSAGE_NUMBER; i++)
+    {
+        fsp_err_t result = FSP_ERR_IN_USE;
+        uint32_t  first_frame = cec_host_tx_frame_count;
+
+        CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+        cec_host_result_wait(&result);
+        if(FSP_SUCCESS == result)
+        {
+            delivered++;
+        }
+        if(0 == cec_host_tx_frame_list[first_frame].outcome)
+        {
+            first_attempt_delivered++;
+        }
+    }
+
+    printf("    %d messages, 45%% of attempts fail: %d delivered with retry, %d by the first attempt, %d attempts, %d ms\n",
+           CEC_HOST_CONTENTION_MESSAGE_NUMBER, delivered, first_attempt_delivered, cec_host_tx_frame_count,
+           system_tick_get() - start_tick);
+
+    /* Without retry 55% of the messages arrive. With 5 + 5 retries nearly all of them. */
+    CEC_HOST_ASSERT(delivered >= (CEC_HOST_CONTENTION_MESSAGE_NUMBER * 99 / 100));
+    CEC_HOST_ASSERT(delivered == cec_tx_statistics.success_count);
+}
+
+/*** Feature Abort cache (user-031) ***/
+
+static void cec_host_feature_abort_receive(cec_addr_t source, uint8_t opcode, uint8_t reason)
+{
+    uint8_t data[2] = {opcode, reason};
+
+    cec_host_rx_frame(source, my_logical_address, CEC_OPCODE_FEATURE_ABORT, &data[0], 2);
+    cec_host_main_loop(1);
+}
+
+static void cec_host_test_unsupported_only_unrecognized_cached(void)
+{
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID, CEC_ABOUT_REASON_REFUSED);
+    CEC_HOST_ASSERT(!cec_unsupported_opcode_check(CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID));
+
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID, CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE);
+    CEC_HOST_ASSERT(cec_unsupported_opcode_check(CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID));
+    CEC_HOST_ASSERT(CEC_REPLY_STATE_REJECTED ==
+                    cec_request_send(CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID, NULL, 0, CEC_OPCODE_DEVICE_VENDOR_ID));
+    CEC_HOST_ASSERT(0 == cec_host_tx_frame_count);
+
+    /* Posting is not filtered. Answers must go out whatever the device aborted before. */
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_REPORT_POWER_STATUS, CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE);
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_REPORT_POWER_STATUS, (uint8_t const *)"\0", 1, NULL));
+}
+
+static void cec_host_test_unsupported_key_dropped(void)
+{
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_USER_CONTROL_PRESSED, CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE);
+
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_key_press(CEC_ADDR_TV, 0x41, 200));
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_key_press(CEC_ADDR_PLAYBACK_DEVICE_1, 0x42, 200));
+    cec_host_main_loop(1000);
+
+    /* Key to TV is dropped and the next one goes on */
+    CEC_HOST_ASSERT(0 == cec_key_event_queue_count);
+    CEC_HOST_ASSERT(!cec_key_is_pressed);
+    CEC_HOST_ASSERT(2 == cec_host_tx_frame_count);
+    CEC_HOST_ASSERT(CEC_ADDR_PLAYBACK_DEVICE_1 == cec_host_tx_frame_list[0].destination);
+    CEC_HOST_ASSERT(CEC_OPCODE_USER_CONTROL_PRESSED == cec_host_tx_frame_list[0].opcode);
+    CEC_HOST_ASSERT(CEC_OPCODE_USER_CONTROL_RELEASED == cec_host_tx_frame_list[1].opcode);
+}
+
+static void cec_host_test_unsupported_key_released_when_aborted(void)
+{
+    /* Held key: the first User Control Pressed is aborted by the device */
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_key_press(CEC_ADDR_TV, 0x41, 0));
+    cec_host_main_loop(100);
+    CEC_HOST_ASSERT(cec_key_is_pressed);
+
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_USER_CONTROL_PRESSED, CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE);
+    cec_host_main_loop(100);
+
+    CEC_HOST_ASSERT(!cec_key_is_pressed);
+    CEC_HOST_ASSERT(CEC_OPCODE_USER_CONTROL_RELEASED == cec_host_tx_frame_list[cec_host_tx_frame_count - 1].opcode);
+}
+
+static void cec_host_test_unsupported_arc_requested_by_tv(void)
+{
+    /* 3.0.0.0: connected to the TV directly */
+    my_physical_address[2] = 0x0;
+    CEC_HOST_ASSERT(cec_arc_available_check());
+
+    cec_host_feature_abort_receive(CEC_ADDR_TV, CEC_OPCODE_INITIATE_ARC, CEC_ABOUT_REASON_UNRECOFNIZED_OPCODE);
+    CEC_HOST_ASSERT(cec_unsupported_opcode_check(CEC_ADDR_TV, CEC_OPCODE_INITIATE_ARC));
+
+    /* Request ARC Initiation of TV wins over the cached abort */
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATION, NULL, 0);
+    cec_host_main_loop(100);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_INITIATING == cec_arc_state);
+    CEC_HOST_ASSERT(1 == cec_host_tx_opcode_count(0, CEC_OPCODE_INITIATE_ARC));
+
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATED, NULL, 0);
+    cec_host_main_loop(10);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_ON == cec_arc_state);
+}
+
+/*** Secondary logical address (user-047) ***/
+
+/* As cec_secondary_logical_address_allocate() leaves it, without APP_CEC_SECONDARY_DEVICE_TYPE in this build */
+static void cec_host_secondary_address_set(cec_addr_t logical_addr)
+{
+    my_secondary_logical_address = logical_addr;
+    cec_bus_device_list[logical_addr].is_device_active = true;
+    cec_bus_device_list[logical_addr].is_my_device = true;
+    cec_local_address_apply(my_logical_address);
+}
+
+/* Frame sent by the fake line, NULL when there is none */
+static cec_host_tx_frame_t const * cec_host_tx_frame_find(uint8_t source, uint8_t destination, uint8_t opcode)
+{
+    for(uint32_t i = 0; i < cec_host_tx_frame_count; i++)
+    {
+        cec_host_tx_frame_t const * p_frame = &cec_host_tx_frame_list[i];
+        if((p_frame->source == source) && (p_frame->destination == destination) && (p_frame->opcode == opcode))
+        {
+            return p_frame;
+        }
+    }
+    return NULL;
+}
+
+static void cec_host_test_secondary_address_is_mine(void)
+{
+    CEC_HOST_ASSERT(CEC_ADDR_AUDIO_SYSTEM == my_logical_address);
+    CEC_HOST_ASSERT(cec_logical_address_is_mine(CEC_ADDR_AUDIO_SYSTEM));
+    CEC_HOST_ASSERT(!cec_logical_address_is_mine(CEC_ADDR_PLAYBACK_DEVICE_1));
+    CEC_HOST_ASSERT(!cec_logical_address_is_mine(CEC_ADDR_UNREGISTERED));
+    CEC_HOST_ASSERT(!cec_logical_address_is_mine(CEC_ADDR_TV));
+
+    cec_host_secondary_address_set(CEC_ADDR_PLAYBACK_DEVICE_1);
+    CEC_HOST_ASSERT(cec_logical_address_is_mine(CEC_ADDR_AUDIO_SYSTEM));
+    CEC_HOST_ASSERT(cec_logical_address_is_mine(CEC_ADDR_PLAYBACK_DEVICE_1));
+    CEC_HOST_ASSERT(!cec_logical_address_is_mine(CEC_ADDR_UNREGISTERED));
+    CEC_HOST_ASSERT(!cec_logical_address_is_mine(CEC_ADDR_TV));
+
+    /* Messages to the other addresses are not acknowledged */
+    CEC_HOST_ASSERT(0 == (R_CEC->CADR & (1U << CEC_ADDR_PLAYBACK_DEVICE_2)));
+    CEC_HOST_ASSERT(0 == (R_CEC->CADR & (1U << CEC_ADDR_TV)));
+}
+
+static void cec_host_test_secondary_address_cadr(void)
+{
+    fsp_err_t result = FSP_ERR_IN_USE;
+    uint16_t  both = (uint16_t)((1U << CEC_ADDR_AUDIO_SYSTEM) | (1U << CEC_ADDR_PLAYBACK_DEVICE_1));
+
+    /* Allocation left the primary address only */
+    CEC_HOST_ASSERT((1U << CEC_ADDR_AUDIO_SYSTEM) == R_CEC->CADR);
+
+    cec_host_secondary_address_set(CEC_ADDR_PLAYBACK_DEVICE_1);
+    CEC_HOST_ASSERT(both == R_CEC->CADR);
+    CEC_HOST_ASSERT(CEC_ADDR_AUDIO_SYSTEM == g_cec0_ctrl.local_address);
+
+    cec_local_address_apply(CEC_ADDR_PLAYBACK_DEVICE_1);
+    CEC_HOST_ASSERT(both == R_CEC->CADR);
+    CEC_HOST_ASSERT(CEC_ADDR_PLAYBACK_DEVICE_1 == g_cec0_ctrl.local_address);
+
+    /* Probe of another address keeps both acknowledged */
+    cec_local_address_apply(CEC_ADDR_PLAYBACK_DEVICE_2);
+    CEC_HOST_ASSERT((both | (1U << CEC_ADDR_PLAYBACK_DEVICE_2)) == R_CEC->CADR);
+
+    /* Every attempt writes the mask before R_CEC_Write() */
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post_from(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+    CEC_HOST_ASSERT(FSP_SUCCESS == result);
+    result = FSP_ERR_IN_USE;
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post(CEC_ADDR_TV, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0, &result));
+    cec_host_result_wait(&result);
+    CEC_HOST_ASSERT(FSP_SUCCESS == result);
+    CEC_HOST_ASSERT(2 == cec_host_tx_frame_count);
+    CEC_HOST_ASSERT(CEC_ADDR_PLAYBACK_DEVICE_1 == cec_host_tx_frame_list[0].source);
+    CEC_HOST_ASSERT(both == cec_host_tx_frame_list[0].cadr);
+    CEC_HOST_ASSERT(CEC_ADDR_AUDIO_SYSTEM == cec_host_tx_frame_list[1].source);
+    CEC_HOST_ASSERT(both == cec_host_tx_frame_list[1].cadr);
+
+    /* Without secondary address */
+    my_secondary_logical_address = CEC_ADDR_UNREGISTERED;
+    cec_local_address_apply(my_logical_address);
+    CEC_HOST_ASSERT((1U << CEC_ADDR_AUDIO_SYSTEM) == R_CEC->CADR);
+}
+
+static void cec_host_test_secondary_auto_response_source(void)
+{
+    cec_host_tx_frame_t const * p_frame;
+
+    cec_host_secondary_address_set(CEC_ADDR_PLAYBACK_DEVICE_1);
+
+    /* Report Physical Address is broadcast, the source tells which device answers */
+    cec_host_rx_frame(CEC_ADDR_TV, CEC_ADDR_PLAYBACK_DEVICE_1, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS, NULL, 0);
+    cec_host_main_loop(200);
+    p_frame = cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS);
+    CEC_HOST_ASSERT(NULL != p_frame);
+    CEC_HOST_ASSERT(CEC_DEVICE_TYPE_PLAYBACK_DEVICE == p_frame->data[2]);
+    CEC_HOST_ASSERT(NULL == cec_host_tx_frame_find(CEC_ADDR_AUDIO_SYSTEM, CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS));
+
+    cec_host_rx_frame(CEC_ADDR_TV, CEC_ADDR_AUDIO_SYSTEM, CEC_OPCODE_GIVE_PHYSICAL_ADDRESS, NULL, 0);
+    cec_host_main_loop(200);
+    p_frame = cec_host_tx_frame_find(CEC_ADDR_AUDIO_SYSTEM, CEC_ADDR_BROADCAST, CEC_OPCODE_REPORT_PHYSICAL_ADDRESS);
+    CEC_HOST_ASSERT(NULL != p_frame);
+    CEC_HOST_ASSERT(CEC_DEVICE_TYPE_AUDIO_SYSTEM == p_frame->data[2]);
+
+    /* Audio features belong to the primary address, the secondary one aborts them */
+    cec_host_rx_frame(CEC_ADDR_TV, CEC_ADDR_PLAYBACK_DEVICE_1, CEC_OPCODE_GIVE_AUDIO_STATUS, NULL, 0);
+    cec_host_main_loop(200);
+    p_frame = cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_FEATURE_ABORT);
+    CEC_HOST_ASSERT(NULL != p_frame);
+    CEC_HOST_ASSERT(CEC_OPCODE_GIVE_AUDIO_STATUS == p_frame->data[0]);
+    CEC_HOST_ASSERT(NULL == cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_REPORT_AUDIO_STATUS));
+}
+
+static void cec_host_test_secondary_concurrent_requests(void)
+{
+    cec_host_secondary_address_set(CEC_ADDR_PLAYBACK_DEVICE_1);
+
+    /* Requests to both addresses arrive back to back, before the main loop drains the receive buffer */
+    cec_host_rx_frame(CEC_ADDR_TV, CEC_ADDR_AUDIO_SYSTEM, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0);
+    cec_host_rx_frame(CEC_ADDR_TV, CEC_ADDR_PLAYBACK_DEVICE_1, CEC_OPCODE_GIVE_POWER_STATUS, NULL, 0);
+    cec_host_rx_frame(CEC_ADDR_RECORDING_DEVICE_1, CEC_ADDR_PLAYBACK_DEVICE_1, CEC_OPCODE_GIVE_OSD_NAME, NULL, 0);
+    cec_host_rx_frame(CEC_ADDR_RECORDING_DEVICE_1, CEC_ADDR_AUDIO_SYSTEM, CEC_OPCODE_GIVE_OSD_NAME, NULL, 0);
+
+    /* A request of my own is on the line meanwhile */
+    CEC_HOST_ASSERT(FSP_SUCCESS == cec_message_post_from(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID, NULL, 0, NULL));
+    cec_host_main_loop(1000);
+
+    CEC_HOST_ASSERT(5 == cec_host_tx_frame_count);
+    CEC_HOST_ASSERT(NULL != cec_host_tx_frame_find(CEC_ADDR_AUDIO_SYSTEM, CEC_ADDR_TV, CEC_OPCODE_REPORT_POWER_STATUS));
+    CEC_HOST_ASSERT(NULL != cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_REPORT_POWER_STATUS));
+    CEC_HOST_ASSERT(NULL != cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_RECORDING_DEVICE_1, CEC_OPCODE_SET_OSD_NAME));
+    CEC_HOST_ASSERT(NULL != cec_host_tx_frame_find(CEC_ADDR_AUDIO_SYSTEM, CEC_ADDR_RECORDING_DEVICE_1, CEC_OPCODE_SET_OSD_NAME));
+    CEC_HOST_ASSERT(NULL != cec_host_tx_frame_find(CEC_ADDR_PLAYBACK_DEVICE_1, CEC_ADDR_TV, CEC_OPCODE_GIVE_DEVICE_VENDOR_ID));
+
+    /* Every frame kept both addresses acknowledged */
+    for(uint32_t i = 0; i < cec_host_tx_frame_count; i++)
+    {
+        CEC_HOST_ASSERT(((1U << CEC_ADDR_AUDIO_SYSTEM) | (1U << CEC_ADDR_PLAYBACK_DEVICE_1)) == cec_host_tx_frame_list[i].cadr);
+    }
+}
+
+/*** System Audio Control (user-048) ***/
+
+/* Set System Audio Mode of the status acknowledged by TV so far */
+static uint32_t cec_host_system_audio_mode_delivered_count(uint8_t system_audio_status)
+{
+    uint32_t count = 0;
+
+    for(uint32_t i = 0; i < cec_host_tx_frame_count; i++)
+    {
+        cec_host_tx_frame_t const * p_frame = &cec_host_tx_frame_list[i];
+        if((CEC_OPCODE_SET_SYSTEM_AUDIO_MODE == p_frame->opcode) && (system_audio_status == p_frame->data[0]) &&
+           (0 == p_frame->outcome) && (0 != p_frame->end_tick))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void cec_host_system_audio_mode_request_receive(bool is_on)
+{
+    uint8_t data[2] = {0x10, 0x00}; // Physical address of the active source
+
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_SYSTEM_AUDIO_MODE_REQUEST, &data[0], is_on ? 2 : 0);
+    cec_host_main_loop(1);
+}
+
+static void cec_host_test_system_audio_tv_request_on_off(void)
+{
+    system_audio_mode_support_function = true;
+
+    cec_host_system_audio_mode_request_receive(true);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_REQUESTING == cec_system_audio_state);
+    cec_host_main_loop(200);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_ON));
+
+    cec_host_system_audio_mode_request_receive(false);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_TERMINATING == cec_system_audio_state);
+    cec_host_main_loop(200);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_IDLE == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_OFF));
+}
+
+static void cec_host_test_system_audio_tv_request_while_resetting(void)
+{
+    system_audio_mode_support_function = true;
+    cec_bus_device_list[CEC_ADDR_PLAYBACK_DEVICE_1].is_active_source = true;
+
+    /* Off of the local request stays queued, not acknowledged twice */
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_system_audio_mode_request();
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_RESETTING == cec_system_audio_state);
+
+    /* Request of TV waits for the end of the reset, On is not queued behind Off */
+    cec_host_system_audio_mode_request_receive(true);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_RESETTING == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_tx_queue_count);
+
+    /* On only after TV acknowledged On */
+    for(uint32_t ms = 0; ms < 2000; ms++)
+    {
+        if(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state)
+        {
+            CEC_HOST_ASSERT(0 != cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_ON));
+        }
+        cec_host_main_loop(1);
+    }
+
+    /* The On of the reset answered TV too */
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_OFF));
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_ON));
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_TV_REQUEST_NONE == cec_system_audio_tv_request);
+}
+
+static void cec_host_test_system_audio_tv_request_while_terminating(void)
+{
+    system_audio_mode_support_function = true;
+    cec_host_system_audio_mode_request_receive(true);
+    cec_host_main_loop(200);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+
+    /* Local request to terminate, then TV asks for On again before Off is delivered */
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_system_audio_mode_request();
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_TERMINATING == cec_system_audio_state);
+    cec_host_system_audio_mode_request_receive(true);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_TERMINATING == cec_system_audio_state);
+
+    /* Off goes first, then On is answered */
+    cec_host_main_loop(1000);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_ON == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_OFF));
+    CEC_HOST_ASSERT(2 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_ON));
+}
+
+static void cec_host_test_system_audio_stale_result_ignored(void)
+{
+    system_audio_mode_support_function = true;
+
+    /* On is NACKed and retried, then the function is disabled before its delivery */
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_host_tx_outcome_push(CEC_ERROR_ACKERR);
+    cec_host_system_audio_mode_request_receive(true);
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_REQUESTING == cec_system_audio_state);
+    cec_system_audio_mode_support_enabling();
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_TERMINATING == cec_system_audio_state);
+
+    /* Completion of On must not end the termination. Idle only after Off is delivered. */
+    for(uint32_t ms = 0; ms < 2000; ms++)
+    {
+        if(CEC_SYSTEM_AUDIO_STATE_TERMINATING != cec_system_audio_state)
+        {
+            CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_OFF));
+        }
+        cec_host_main_loop(1);
+    }
+
+    CEC_HOST_ASSERT(CEC_SYSTEM_AUDIO_STATE_IDLE == cec_system_audio_state);
+    CEC_HOST_ASSERT(1 == cec_host_system_audio_mode_delivered_count(CEC_SYSTEM_AUDIO_STATUS_ON));
+}
+
+/*** Request ARC Initiation (user-049) ***/
+
+/* Reply trackers waiting for the opcode */
+static uint32_t cec_host_reply_request_count(uint8_t request_opcode)
+{
+    uint32_t count = 0;
+
+    for(uint32_t i = 0; i < CEC_REPLY_REQUEST_NUMBER; i++)
+    {
+        if(cec_reply_request_list[i].is_used && (cec_reply_request_list[i].request_opcode == request_opcode))
+        {
+            count++;
+        }
+    }
+    return count;
+}
+
+static void cec_host_test_arc_request_while_initiating(void)
+{
+    /* 3.0.0.0: connected to the TV directly */
+    my_physical_address[2] = 0x0;
+
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATION, NULL, 0);
+    cec_host_main_loop(1);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_INITIATING == cec_arc_state);
+    CEC_HOST_ASSERT(1 == cec_host_reply_request_count(CEC_OPCODE_INITIATE_ARC));
+
+    /* TV asks again before it reports. Answered, and still one tracker. */
+    cec_host_main_loop(100);
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATION, NULL, 0);
+    cec_host_main_loop(100);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_INITIATING == cec_arc_state);
+    CEC_HOST_ASSERT(1 == cec_host_reply_request_count(CEC_OPCODE_INITIATE_ARC));
+    CEC_HOST_ASSERT(2 == cec_host_tx_opcode_count(0, CEC_OPCODE_INITIATE_ARC));
+
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATED, NULL, 0);
+    cec_host_main_loop(10);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_ON == cec_arc_state);
+    CEC_HOST_ASSERT(CEC_REPLY_STATE_REPLIED == cec_arc_reply_state);
+    CEC_HOST_ASSERT(0 == cec_host_reply_request_count(CEC_OPCODE_INITIATE_ARC));
+}
+
+static void cec_host_test_arc_request_while_on(void)
+{
+    uint32_t first;
+
+    my_physical_address[2] = 0x0;
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATION, NULL, 0);
+    cec_host_main_loop(100);
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATED, NULL, 0);
+    cec_host_main_loop(10);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_ON == cec_arc_state);
+
+    /* TV asks again, e.g. after its input change. ARC stays on, and no reply is waited. */
+    first = cec_host_tx_frame_count;
+    cec_host_rx_frame(CEC_ADDR_TV, my_logical_address, CEC_OPCODE_REPORT_ARC_INITIATION, NULL, 0);
+    cec_host_main_loop(1);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_ON == cec_arc_state);
+    CEC_HOST_ASSERT(0 == cec_host_reply_request_count(CEC_OPCODE_INITIATE_ARC));
+
+    /* TV does not report this time. No retry and no timeout moves the state. */
+    cec_host_main_loop(5000);
+    CEC_HOST_ASSERT(CEC_ARC_STATE_ON == cec_arc_state);
+    CEC_HOST_ASSERT(CEC_REPLY_STATE_REPLIED == cec_arc_reply_state);
+    CEC_HOST_ASSERT(1 == cec_host_tx_opcode_count(first, CEC_OPCODE_INITIATE_ARC));
+}
+
+static cec_host_test_t const cec_host_test_list[] =
+{
+    {"tx_retry_class",                            cec_host_test_tx_retry_class},
+    {"tx_retry_after_nack_and_tx_error",          cec_host_test_tx_retry_after_nack_and_tx_error},
+    {"tx_retry_after_arbitration_lost",           cec_host_test_tx_retry_after_arbitration_lost},
+    {"tx_retry_exhausted",                        cec_host_test_tx_retry_exhausted},
+    {"tx_no_retry_on_bus_error",                  cec_host_test_tx_no_retry_on_bus_error},
+    {"tx_delivery_under_contention",              cec_host_test_tx_delivery_under_contention},
+    {"unsupported_only_unrecognized_cached",      cec_host_test_unsupported_only_unrecognized_cached},
+    {"unsupported_key_dropped",                   cec_host_test_unsupported_key_dropped},
+    {"unsupported_key_released_when_aborted",     cec_host_test_unsupported_key_released_when_aborted},
+    {"unsupported_arc_requested_by_tv",           cec_host_test_unsupported_arc_requested_by_tv},
+    {"secondary_address_is_mine",                 cec_host_test_secondary_address_is_mine},
+    {"secondary_address_cadr",                    cec_host_test_secondary_address_cadr},
+    {"secondary_auto_response_source",            cec_host_test_secondary_auto_response_source},
+    {"secondary_concurrent_requests",             cec_host_test_secondary_concurrent_requests},
+    {"system_audio_tv_request_on_off",            cec_host_test_system_audio_tv_request_on_off},
+    {"system_audio_tv_request_while_resetting",   cec_host_test_system_audio_tv_request_while_resetting},
+    {"system_audio_tv_request_while_terminating", cec_host_test_system_audio_tv_request_while_terminating},
+    {"system_audio_stale_result_ignored",         cec_host_test_system_audio_stale_result_ignored},
+    {"arc_request_while_initiating",              cec_host_test_arc_request_while_initiating},
+    {"arc_request_while_on",                      cec_host_test_arc_request_while_on},
+};
+
+static bool cec_host_test_is_selected(char const * p_name, int argc, char * argv[], int first)
+{
+    if(first >= argc)
+    {
+        return true;
+    }
+
+    for(int i = first; i < argc; i++)
+    {
+        if(0 == strcmp(p_name, argv[i]))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+int main(int argc, char * argv[])
+{
+    int      first = 1;
+    uint32_t run_count = 0;
+    uint32_t fail_count = 0;
+
+    if((argc > 1) && (0 == strcmp(argv[1], "-v")))
+    {
+        cec_host_is_verbose = true;
+        first = 2;
+    }
+
+    for(uint32_t i = 0; i < (sizeof(cec_host_test_list) / sizeof(cec_host_test_list[0])); i++)
+    {
+        cec_host_test_t const * p_test = &cec_host_test_list[i];
+        int                     status;
+        pid_t                   pid;
+
+        if(!cec_host_test_is_selected(p_test->p_name, argc, argv, first))
+        {
+            continue;
+        }
+
+        printf("%s\n", p_test->p_name);
+        fflush(stdout);
+
+        pid = fork();
+        if(0 == pid)
+        {
+            cec_host_boot();
+            p_test->p_function();
+            fflush(stdout);
+            _exit(0);
+        }
+
+        run_count++;
+        if((pid < 0) || (waitpid(pid, &status, 0) != pid) || !WIFEXITED(status) || (0 != WEXITSTATUS(status)))
+        {
+            printf("    FAILED\n");
+            fail_count++;
+        }
+    }
+
+    printf("%d tests, %d failed\n", run_count, fail_count);
+    return (0 == fail_count) ? 0 : 1;
+}
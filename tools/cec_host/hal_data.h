@@ -0,0 +1,299 @@
+/***********************************************************************************************************************
+ * File Name    : hal_data.h
+ * Description  : Host replacement of the FSP generated hal_data.h, so the application builds for the host tests.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef HAL_DATA_H_
+#define HAL_DATA_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Error codes */
+typedef enum e_fsp_err
+{
+    FSP_SUCCESS                  = 0,
+    FSP_ERR_ASSERTION            = 1,
+    FSP_ERR_INVALID_POINTER      = 2,
+    FSP_ERR_INVALID_ARGUMENT     = 3,
+    FSP_ERR_INVALID_DATA         = 4,
+    FSP_ERR_IN_USE               = 5,
+    FSP_ERR_TIMEOUT              = 6,
+    FSP_ERR_ABORTED              = 7,
+    FSP_ERR_UNSUPPORTED          = 8,
+    FSP_ERR_NOT_FOUND            = 9,
+    FSP_ERR_NOT_OPEN             = 10,
+    FSP_ERR_ALREADY_OPEN         = 11,
+    FSP_ERR_BLANK_CHECK_FAILED   = 12,
+    FSP_ERR_NOT_ERASED           = 13,
+    FSP_ERR_WRITE_FAILED         = 14,
+    FSP_ERR_ERASE_FAILED         = 15,
+    FSP_ERR_OVERFLOW             = 16,
+    FSP_ERR_INVALID_STATE        = 17,
+    FSP_ERR_INVALID_MODE         = 18,
+    FSP_ERR_INVALID_SIZE         = 19,
+    FSP_ERR_OUT_OF_MEMORY        = 20,
+    FSP_ERR_UNDERFLOW            = 21,
+    FSP_ERR_INVALID_CHANNEL      = 22,
+    FSP_ERR_INVALID_HW_CONDITION = 23,
+} fsp_err_t;
+
+/* BSP and core. The host has no interrupts, so critical sections are empty. */
+#define FSP_PARAMETER_NOT_USED(p)   (void)(p)
+#define __BKPT(x)                   cec_host_fatal_error(__FILE__, __LINE__)
+#define __NOP()                     ((void)0)
+#define __DSB()                     ((void)0)
+#define __ISB()                     ((void)0)
+#define __WFI()                     ((void)0)
+#define FSP_CRITICAL_SECTION_DEFINE uint32_t old_mask_level = 0U
+#define FSP_CRITICAL_SECTION_ENTER  (void)old_mask_level
+#define FSP_CRITICAL_SECTION_EXIT   (void)old_mask_level
+static inline uint32_t __get_PRIMASK(void) { return 0; }
+static inline void __set_PRIMASK(uint32_t mask) { (void)mask; }
+static inline void __disable_irq(void) { }
+static inline void __enable_irq(void) { }
+void cec_host_fatal_error(char const * p_file, int line);
+
+typedef enum e_bsp_delay_units
+{
+    BSP_DELAY_UNITS_SECONDS      = 1000000,
+    BSP_DELAY_UNITS_MILLISECONDS = 1000,
+    BSP_DELAY_UNITS_MICROSECONDS = 1,
+} bsp_delay_units_t;
+void R_BSP_SoftwareDelay(uint32_t delay, bsp_delay_units_t units);
+
+typedef enum e_bsp_warm_start_event
+{
+    BSP_WARM_START_RESET,
+    BSP_WARM_START_POST_CLOCK,
+    BSP_WARM_START_POST_C,
+} bsp_warm_start_event_t;
+
+typedef union st_fsp_pack_version
+{
+    uint32_t version_id;
+    struct { uint8_t build; uint8_t patch; uint8_t minor; uint8_t major; } version_id_b;
+} fsp_pack_version_t;
+fsp_err_t R_FSP_VersionGet(fsp_pack_version_t * const p_version);
+
+typedef int IRQn_Type;
+typedef struct { volatile uint32_t CTRL; volatile uint32_t LOAD; volatile uint32_t VAL; volatile uint32_t CALIB; } SysTick_Type;
+typedef struct { volatile uint32_t CTRL; volatile uint32_t CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+typedef struct { volatile uint32_t ICSR; volatile uint32_t VTOR; } SCB_Type;
+extern SysTick_Type   * SysTick;
+extern DWT_Type       * DWT;
+extern CoreDebug_Type * CoreDebug;
+extern SCB_Type       * SCB;
+extern uint32_t         SystemCoreClock;
+uint32_t SysTick_Config(uint32_t ticks);
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL)
+#define SCB_ICSR_PENDSTSET_Msk     (1UL << 26)
+#define BSP_ICU_VECTOR_MAX_ENTRIES (96)
+
+/* r_ioport */
+typedef int bsp_io_port_pin_t;
+typedef enum e_bsp_io_level { BSP_IO_LEVEL_LOW, BSP_IO_LEVEL_HIGH } bsp_io_level_t;
+#define BSP_IO_PORT_00_PIN_06 (0x006)
+#define BSP_IO_PORT_00_PIN_07 (0x007)
+#define BSP_IO_PORT_00_PIN_08 (0x008)
+#define BSP_IO_PORT_01_PIN_05 (0x105)
+#define BSP_IO_PORT_02_PIN_06 (0x206)
+#define BSP_IO_PORT_03_PIN_01 (0x301)
+#define BSP_IO_PORT_04_PIN_03 (0x403)
+#define BSP_IO_PORT_04_PIN_09 (0x409)
+typedef enum e_ioport_cfg_options { IOPORT_CFG_PERIPHERAL_PIN = 0x10000 } ioport_cfg_options_t;
+typedef enum e_ioport_peripheral { IOPORT_PERIPHERAL_GPT0 = 0x02000000, IOPORT_PERIPHERAL_GPT1 = 0x03000000 } ioport_peripheral_t;
+typedef struct st_ioport_instance_ctrl { uint32_t open; } ioport_instance_ctrl_t;
+typedef struct st_ioport_cfg { uint32_t number_of_pins; } ioport_cfg_t;
+extern ioport_instance_ctrl_t g_ioport_ctrl;
+extern const ioport_cfg_t     g_bsp_pin_cfg;
+#define IOPORT_CFG_NAME g_bsp_pin_cfg
+fsp_err_t R_IOPORT_Open(ioport_instance_ctrl_t * p_ctrl, const ioport_cfg_t * p_cfg);
+fsp_err_t R_IOPORT_PinWrite(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, bsp_io_level_t level);
+fsp_err_t R_IOPORT_PinRead(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, bsp_io_level_t * p_pin_value);
+fsp_err_t R_IOPORT_PinCfg(ioport_instance_ctrl_t * p_ctrl, bsp_io_port_pin_t pin, uint32_t cfg);
+
+/* r_cec */
+typedef enum e_cec_addr
+{
+    CEC_ADDR_TV                 = 0,
+    CEC_ADDR_RECORDING_DEVICE_1 = 1,
+    CEC_ADDR_RECORDING_DEVICE_2 = 2,
+    CEC_ADDR_TUNER_1            = 3,
+    CEC_ADDR_PLAYBACK_DEVICE_1  = 4,
+    CEC_ADDR_AUDIO_SYSTEM       = 5,
+    CEC_ADDR_TUNER_2            = 6,
+    CEC_ADDR_TUNER_3            = 7,
+    CEC_ADDR_PLAYBACK_DEVICE_2  = 8,
+    CEC_ADDR_RECORDING_DEVICE_3 = 9,
+    CEC_ADDR_TUNER_4            = 10,
+    CEC_ADDR_PLAYBACK_DEVICE_3  = 11,
+    CEC_ADDR_SPECIFIC_USE       = 14,
+    CEC_ADDR_UNREGISTERED       = 15,
+    CEC_ADDR_BROADCAST          = 15,
+} cec_addr_t;
+typedef enum e_cec_state { CEC_STATE_UNINIT, CEC_STATE_INIT, CEC_STATE_READY, CEC_STATE_TX_ACTIVE, CEC_STATE_RX_ACTIVE } cec_state_t;
+typedef struct st_cec_status { cec_state_t state; } cec_status_t;
+typedef enum e_cec_error
+{
+    CEC_ERROR_OERR   = 0x01,
+    CEC_ERROR_UERR   = 0x02,
+    CEC_ERROR_ACKERR = 0x04,
+    CEC_ERROR_TERR   = 0x08,
+    CEC_ERROR_TXERR  = 0x10,
+    CEC_ERROR_AERR   = 0x20,
+    CEC_ERROR_BLERR  = 0x40,
+} cec_error_t;
+typedef enum e_cec_event { CEC_EVENT_RX_DATA, CEC_EVENT_RX_COMPLETE, CEC_EVENT_TX_COMPLETE, CEC_EVENT_ERR, CEC_EVENT_READY } cec_event_t;
+typedef struct st_cec_callback_args
+{
+    cec_event_t  event;
+    uint8_t      data_byte;
+    cec_status_t status;
+    cec_error_t  errors;
+    void const * p_context;
+} cec_callback_args_t;
+#define CEC_DATA_BUFFER_LENGTH (16)
+typedef struct st_cec_message
+{
+    uint8_t destination : 4;
+    uint8_t source      : 4;
+    uint8_t opcode;
+    uint8_t data[CEC_DATA_BUFFER_LENGTH];
+} cec_message_t;
+typedef struct st_cec_instance_ctrl { uint32_t open; cec_addr_t local_address; } cec_instance_ctrl_t;
+typedef struct st_cec_cfg { uint32_t bit_width; } cec_cfg_t;
+extern cec_instance_ctrl_t g_cec0_ctrl;
+extern const cec_cfg_t     g_cec0_cfg;
+fsp_err_t R_CEC_Open(cec_instance_ctrl_t * p_ctrl, cec_cfg_t const * p_cfg);
+fsp_err_t R_CEC_MediaInit(cec_instance_ctrl_t * p_ctrl, cec_addr_t local_address);
+fsp_err_t R_CEC_Write(cec_instance_ctrl_t * p_ctrl, cec_message_t const * p_message, uint32_t message_size);
+fsp_err_t R_CEC_StatusGet(cec_instance_ctrl_t * p_ctrl, cec_status_t * p_status);
+fsp_err_t R_CEC_Close(cec_instance_ctrl_t * p_ctrl);
+void      cec_interrupt_callback(cec_callback_args_t * p_args);
+
+typedef struct st_cec_registers
+{
+    union
+    {
+        volatile uint8_t CECCTL1;
+        struct
+        {
+            volatile uint8_t SFT    : 2;
+            volatile uint8_t CESEL  : 2;
+            volatile uint8_t STERRD : 1;
+            volatile uint8_t BLERRD : 1;
+            volatile uint8_t CINTMK : 1;
+            volatile uint8_t CDFC   : 1;
+        } CECCTL1_b;
+    };
+    volatile uint16_t CADR;
+} R_CEC_Type;
+extern R_CEC_Type * R_CEC;
+
+/* r_dtc */
+typedef struct st_transfer_info { void const * volatile p_src; void * volatile p_dest; volatile uint16_t length; } transfer_info_t;
+typedef struct st_transfer_cfg { transfer_info_t * p_info; } transfer_cfg_t;
+typedef struct st_transfer_instance { void * p_ctrl; transfer_cfg_t const * p_cfg; void const * p_api; } transfer_instance_t;
+extern const transfer_instance_t g_ddc_transfer_rx;
+
+/* r_sci_i2c. The host has no DDC, so every transfer fails unless a test provides the sink. */
+typedef enum e_i2c_master_addr_mode { I2C_MASTER_ADDR_MODE_7BIT = 1 } i2c_master_addr_mode_t;
+typedef enum e_i2c_master_event
+{
+    I2C_MASTER_EVENT_ABORTED     = 1,
+    I2C_MASTER_EVENT_RX_COMPLETE = 2,
+    I2C_MASTER_EVENT_TX_COMPLETE = 3,
+} i2c_master_event_t;
+typedef struct st_i2c_master_callback_args { void const * p_context; i2c_master_event_t event; } i2c_master_callback_args_t;
+typedef struct st_i2c_master_cfg
+{
+    IRQn_Type                   rxi_irq;
+    IRQn_Type                   txi_irq;
+    IRQn_Type                   tei_irq;
+    IRQn_Type                   eri_irq;
+    transfer_instance_t const * p_transfer_tx;
+    transfer_instance_t const * p_transfer_rx;
+} i2c_master_cfg_t;
+typedef struct st_sci_i2c_instance_ctrl { uint32_t open; } sci_i2c_instance_ctrl_t;
+extern sci_i2c_instance_ctrl_t g_ddc_source_i2c_master_ctrl;
+extern const i2c_master_cfg_t  g_ddc_source_i2c_master_cfg;
+fsp_err_t R_SCI_I2C_Open(sci_i2c_instance_ctrl_t * p_ctrl, i2c_master_cfg_t const * p_cfg);
+fsp_err_t R_SCI_I2C_Close(sci_i2c_instance_ctrl_t * p_ctrl);
+fsp_err_t R_SCI_I2C_Read(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_dest, uint32_t bytes, bool restart);
+fsp_err_t R_SCI_I2C_Write(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_src, uint32_t bytes, bool restart);
+fsp_err_t R_SCI_I2C_Abort(sci_i2c_instance_ctrl_t * p_ctrl);
+fsp_err_t R_SCI_I2C_SlaveAddressSet(sci_i2c_instance_ctrl_t * p_ctrl, uint32_t slave, i2c_master_addr_mode_t addr_mode);
+
+/* r_icu */
+typedef struct st_external_irq_callback_args { void const * p_context; uint32_t channel; } external_irq_callback_args_t;
+typedef struct st_icu_instance_ctrl { uint32_t open; } icu_instance_ctrl_t;
+typedef struct st_external_irq_cfg { uint8_t channel; } external_irq_cfg_t;
+extern icu_instance_ctrl_t      g_external_irq_sw1_ctrl;
+extern icu_instance_ctrl_t      g_external_irq_sw2_ctrl;
+extern icu_instance_ctrl_t      g_external_irq_hpd_ctrl;
+extern const external_irq_cfg_t g_external_irq_sw1_cfg;
+extern const external_irq_cfg_t g_external_irq_sw2_cfg;
+extern const external_irq_cfg_t g_external_irq_hpd_cfg;
+fsp_err_t R_ICU_ExternalIrqOpen(icu_instance_ctrl_t * p_ctrl, external_irq_cfg_t const * p_cfg);
+fsp_err_t R_ICU_ExternalIrqEnable(icu_instance_ctrl_t * p_ctrl);
+fsp_err_t R_ICU_ExternalIrqDisable(icu_instance_ctrl_t * p_ctrl);
+
+/* r_gpt */
+typedef enum e_timer_state { TIMER_STATE_STOPPED, TIMER_STATE_COUNTING } timer_state_t;
+typedef struct st_timer_status { uint32_t counter; timer_state_t state; } timer_status_t;
+typedef enum e_timer_event { TIMER_EVENT_CYCLE_END, TIMER_EVENT_CAPTURE_A, TIMER_EVENT_CAPTURE_B } timer_event_t;
+typedef struct st_timer_callback_args { void const * p_context; timer_event_t event; uint32_t capture; } timer_callback_args_t;
+typedef struct st_timer_cfg { uint32_t period_counts; } timer_cfg_t;
+typedef struct st_timer_info { uint32_t clock_frequency; uint32_t period_counts; } timer_info_t;
+typedef struct st_gpt_instance_ctrl { uint32_t open; } gpt_instance_ctrl_t;
+typedef enum e_gpt_io_pin { GPT_IO_PIN_GTIOCA } gpt_io_pin_t;
+extern gpt_instance_ctrl_t g_led_pwm_gpt_timer_ctrl;
+extern const timer_cfg_t   g_led_pwm_gpt_timer_cfg;
+extern gpt_instance_ctrl_t g_cec_timing_gpt_timer_ctrl;
+extern const timer_cfg_t   g_cec_timing_gpt_timer_cfg;
+fsp_err_t R_GPT_Open(gpt_instance_ctrl_t * p_ctrl, timer_cfg_t const * p_cfg);
+fsp_err_t R_GPT_Close(gpt_instance_ctrl_t * p_ctrl);
+fsp_err_t R_GPT_Start(gpt_instance_ctrl_t * p_ctrl);
+fsp_err_t R_GPT_Stop(gpt_instance_ctrl_t * p_ctrl);
+fsp_err_t R_GPT_Enable(gpt_instance_ctrl_t * p_ctrl);
+fsp_err_t R_GPT_Disable(gpt_instance_ctrl_t * p_ctrl);
+fsp_err_t R_GPT_StatusGet(gpt_instance_ctrl_t * p_ctrl, timer_status_t * p_status);
+fsp_err_t R_GPT_InfoGet(gpt_instance_ctrl_t * p_ctrl, timer_info_t * p_info);
+fsp_err_t R_GPT_DutyCycleSet(gpt_instance_ctrl_t * p_ctrl, uint32_t duty_cycle_counts, uint32_t pin);
+
+/* r_flash_hp */
+typedef struct st_flash_hp_instance_ctrl { uint32_t open; } flash_hp_instance_ctrl_t;
+typedef struct st_flash_cfg { uint32_t data_flash_bgo; } flash_cfg_t;
+typedef enum e_flash_result { FLASH_RESULT_BLANK, FLASH_RESULT_NOT_BLANK, FLASH_RESULT_BGO_ACTIVE } flash_result_t;
+extern flash_hp_instance_ctrl_t g_flash0_ctrl;
+extern const flash_cfg_t        g_flash0_cfg;
+fsp_err_t R_FLASH_HP_Open(flash_hp_instance_ctrl_t * p_ctrl, flash_cfg_t const * p_cfg);
+fsp_err_t R_FLASH_HP_Write(flash_hp_instance_ctrl_t * p_ctrl, uint32_t src_address, uint32_t flash_address, uint32_t num_bytes);
+fsp_err_t R_FLASH_HP_Erase(flash_hp_instance_ctrl_t * p_ctrl, uint32_t address, uint32_t num_blocks);
+fsp_err_t R_FLASH_HP_BlankCheck(flash_hp_instance_ctrl_t * p_ctrl, uint32_t address, uint32_t num_bytes, flash_result_t * p_blank_check_result);
+#define BSP_FEATURE_FLASH_DATA_FLASH_START (0x08000000U)
+#define BSP_DATA_FLASH_SIZE_BYTES          (4096)
+#define FLASH_HP_DF_BLOCK_SIZE             (64U)
+
+#endif /* HAL_DATA_H_ */
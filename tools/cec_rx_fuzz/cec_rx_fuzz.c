@@ -0,0 +1,315 @@
+/***********************************************************************************************************************
+ * File Name    : cec_rx_fuzz.c
+ * Description  : Host fuzz harness of the CEC receive path in hal_entry.c, from the interrupt to the auto responses.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+
+/*
+ * hal_entry.c is built for the host on the fake drivers of tools/cec_host. An input is a stream of records, each of
+ * which drives cec_interrupt_callback() as r_cec does:
+ *   byte 0, bits 0-4 : number of bytes received in this record (0 - 31, over 16 is a frame longer than CEC allows)
+ *   byte 0, bits 5-6 : 0: CEC_EVENT_RX_COMPLETE after the bytes
+ *                      1: CEC_EVENT_ERR after the bytes, with the error bits in the next byte
+ *                      2: no end, the next record continues the frame
+ *                      3: the bytes are not received but set the outcomes of our next transmissions (0: ACK)
+ *   byte 0, bit 7    : the main loop runs for as many ms as the next byte says
+ * Between the records, the receive buffer, the queues and the state machines are checked for their bounds.
+ * The device state carries over from one input to the next, as on a running device.
+ *
+ * Standalone (GCC, no libFuzzer), from the repository root. Replays the corpus and runs random mutations of it:
+ *   gcc -g -O1 -fsanitize=address,undefined -fno-sanitize-recover=all -Itools/cec_host \
+ *       tools/cec_rx_fuzz/cec_rx_fuzz.c tools/cec_host/cec_host_fake.c src/application_utils.c src/hdmi_cec_utils.c \
+ *       src/hdmi_ddc_utils.c src/hdmi_scdc_utils.c src/hdmi_ddc_ci_utils.c src/cec_monitor_utils.c \
+ *       src/cec_timing_utils.c -o cec_rx_fuzz
+ *   ./cec_rx_fuzz [-n <mutations per seed>] tools/cec_rx_fuzz/corpus/<file>.bin ...
+ * LLVMFuzzerTestOneInput() is the libFuzzer entry point, and -DCEC_RX_FUZZ_LIBFUZZER leaves out main() for it.
+ * That build has only been compiled with GCC and replayed over the corpus, not run under libFuzzer.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "../../src/hal_entry.c"
+#include "cec_host_fake.h"
+
+#define CEC_RX_FUZZ_MUTATION_NUMBER  (20000) // Default mutations per seed of the standalone run
+#define CEC_RX_FUZZ_RECORD_LENGTH    (0x1F)
+#define CEC_RX_FUZZ_END_COMPLETE     (0)
+#define CEC_RX_FUZZ_END_ERROR        (1)
+#define CEC_RX_FUZZ_END_NONE         (2)
+#define CEC_RX_FUZZ_END_TX_OUTCOME   (3)
+#define CEC_RX_FUZZ_RUN              (0x80)
+#define CEC_RX_FUZZ_TX_OUTCOME_NUMBER (8)
+
+#define CEC_RX_FUZZ_ASSERT(condition) \
+    do { \
+        if(!(condition)) \
+        { \
+            fprintf(stderr, "%s:%d: invariant broken: %s\n", __FILE__, __LINE__, #condition); \
+            abort(); \
+        } \
+    } while(0)
+
+static cec_error_t cec_rx_fuzz_tx_outcome_list[CEC_RX_FUZZ_TX_OUTCOME_NUMBER];
+static uint32_t    cec_rx_fuzz_tx_outcome_read_point = 0;
+static uint32_t    cec_rx_fuzz_tx_outcome_count = 0;
+
+/* Outcomes of the input in order, acknowledged when there is none left. The oldest one is lost when it is full. */
+static cec_error_t cec_rx_fuzz_tx_outcome_get(cec_host_tx_frame_t const * p_frame)
+{
+    cec_error_t outcome = 0;
+
+    FSP_PARAMETER_NOT_USED(p_frame);
+    if(cec_rx_fuzz_tx_outcome_count > 0)
+    {
+        outcome = cec_rx_fuzz_tx_outcome_list[cec_rx_fuzz_tx_outcome_read_point];
+        cec_rx_fuzz_tx_outcome_read_point = (cec_rx_fuzz_tx_outcome_read_point + 1) % CEC_RX_FUZZ_TX_OUTCOME_NUMBER;
+        cec_rx_fuzz_tx_outcome_count--;
+    }
+
+    return outcome;
+}
+
+static void cec_rx_fuzz_tx_outcome_push(cec_error_t outcome)
+{
+    if(cec_rx_fuzz_tx_outcome_count >= CEC_RX_FUZZ_TX_OUTCOME_NUMBER)
+    {
+        cec_rx_fuzz_tx_outcome_read_point = (cec_rx_fuzz_tx_outcome_read_point + 1) % CEC_RX_FUZZ_TX_OUTCOME_NUMBER;
+        cec_rx_fuzz_tx_outcome_count--;
+    }
+    cec_rx_fuzz_tx_outcome_list[(cec_rx_fuzz_tx_outcome_read_point + cec_rx_fuzz_tx_outcome_count) % CEC_RX_FUZZ_TX_OUTCOME_NUMBER] = outcome;
+    cec_rx_fuzz_tx_outcome_count++;
+}
+
+/* Background part of the main loop of hal_entry(), 1 ms per turn */
+static void cec_rx_fuzz_main_loop(uint32_t ms)
+{
+    for(uint32_t i = 0; i < ms; i++)
+    {
+        cec_rx_data_check();
+        cec_action_request_detect_flag = false;
+
+        cec_key_hold_process();
+        cec_key_process();
+        cec_tx_process();
+        cec_reply_process();
+        cec_system_audio_process();
+        cec_arc_process();
+
+        cec_host_tick_advance(1);
+
+        /* The fake line keeps a record of every frame. Only the last one is used while it is on the line. */
+        if(!cec_host_tx_is_busy())
+        {
+            cec_host_tx_frame_count = 0;
+        }
+    }
+}
+
+static void cec_rx_fuzz_invariant_check(void)
+{
+    CEC_RX_FUZZ_ASSERT(cec_rx_data_buff_next_store_point < CEC_RX_DATA_BUFF_DATA_NUMBER);
+    CEC_RX_FUZZ_ASSERT(cec_tx_queue_count <= CEC_TX_QUEUE_NUMBER);
+    CEC_RX_FUZZ_ASSERT(cec_tx_queue_read_point < CEC_TX_QUEUE_NUMBER);
+    CEC_RX_FUZZ_ASSERT(cec_key_event_queue_count <= CEC_KEY_EVENT_QUEUE_NUMBER);
+    CEC_RX_FUZZ_ASSERT(my_logical_address <= CEC_ADDR_UNREGISTERED);
+    CEC_RX_FUZZ_ASSERT(cec_system_audio_state <= CEC_SYSTEM_AUDIO_STATE_TERMINATING);
+    CEC_RX_FUZZ_ASSERT(cec_arc_state <= CEC_ARC_STATE_TERMINATING);
+    CEC_RX_FUZZ_ASSERT(cec_tx_state <= CEC_TX_STATE_RETRY_WAIT);
+}
+
+static void cec_rx_fuzz_boot(void)
+{
+    static bool is_booted = false;
+
+    if(is_booted)
+    {
+        return;
+    }
+    is_booted = true;
+
+    /* Boot sequence of hal_entry() from R_CEC_Open(), with a free bus and connected to the TV directly (3.0.0.0) */
+    my_physical_address[2] = 0x0;
+    cec_host_tx_outcome_function_set(cec_rx_fuzz_tx_outcome_get);
+    R_CEC_Open(&g_cec0_ctrl, &g_cec0_cfg);
+    if(FSP_SUCCESS != cec_logical_address_allocate(CEC_ADDR_UNREGISTERED))
+    {
+        abort();
+    }
+    cec_my_device_status_update(0x1);
+    system_audio_mode_support_function = true;
+}
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size);
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size)
+{
+    size_t read_point = 0;
+
+    cec_rx_fuzz_boot();
+    cec_rx_fuzz_tx_outcome_count = 0;
+
+    while(read_point < size)
+    {
+        uint8_t  control = p_data[read_point++];
+        uint32_t length  = control & CEC_RX_FUZZ_RECORD_LENGTH;
+        uint32_t end     = (control >> 5) & 0x3;
+
+        if(length > (size - read_point))
+        {
+            length = (uint32_t)(size - read_point);
+        }
+
+        if(CEC_RX_FUZZ_END_TX_OUTCOME == end)
+        {
+            for(uint32_t i = 0; i < length; i++)
+            {
+                cec_rx_fuzz_tx_outcome_push((cec_error_t)p_data[read_point + i]);
+            }
+            read_point += length;
+        }
+        else
+        {
+            cec_callback_args_t args = {0};
+
+            for(uint32_t i = 0; i < length; i++)
+            {
+                args.event     = CEC_EVENT_RX_DATA;
+                args.data_byte = p_data[read_point++];
+                cec_interrupt_callback(&args);
+            }
+
+            if(CEC_RX_FUZZ_END_COMPLETE == end)
+            {
+                args.event = CEC_EVENT_RX_COMPLETE;
+                cec_interrupt_callback(&args);
+            }
+            else if((CEC_RX_FUZZ_END_ERROR == end) && (read_point < size))
+            {
+                args.event  = CEC_EVENT_ERR;
+                args.errors = p_data[read_point++];
+                cec_interrupt_callback(&args);
+            }
+            else
+            {
+                /* The frame goes on in the next record */
+            }
+        }
+
+        if((control & CEC_RX_FUZZ_RUN) && (read_point < size))
+        {
+            cec_rx_fuzz_main_loop(p_data[read_point++]);
+        }
+
+        cec_rx_fuzz_invariant_check();
+    }
+
+    /* Let the answers, a few frames long, and the state machines settle */
+    cec_rx_fuzz_main_loop(200);
+    cec_rx_fuzz_invariant_check();
+
+    return 0;
+}
+
+#if !defined(CEC_RX_FUZZ_LIBFUZZER)
+static uint32_t cec_rx_fuzz_random_state = 0x12345678;
+
+static uint32_t cec_rx_fuzz_random(void)
+{
+    /* xorshift32 */
+    cec_rx_fuzz_random_state ^= cec_rx_fuzz_random_state << 13;
+    cec_rx_fuzz_random_state ^= cec_rx_fuzz_random_state >> 17;
+    cec_rx_fuzz_random_state ^= cec_rx_fuzz_random_state << 5;
+    return cec_rx_fuzz_random_state;
+}
+
+static size_t cec_rx_fuzz_mutate(uint8_t const * p_seed, size_t seed_size, uint8_t * p_data, size_t data_size)
+{
+    size_t   size = seed_size;
+    uint32_t count = 1 + (cec_rx_fuzz_random() % 8);
+
+    memcpy(p_data, p_seed, seed_size);
+    for(uint32_t i = 0; (i < count) && (size != 0); i++)
+    {
+        switch(cec_rx_fuzz_random() % 4)
+        {
+            case 0: /* Any byte: header, opcode, operand or record control */
+                p_data[cec_rx_fuzz_random() % size] = (uint8_t)cec_rx_fuzz_random();
+                break;
+            case 1: /* Bit flip */
+                p_data[cec_rx_fuzz_random() % size] ^= (uint8_t)(1U << (cec_rx_fuzz_random() % 8));
+                break;
+            case 2: /* Repeat a part, as a retransmission or a burst of frames */
+            {
+                size_t offset = cec_rx_fuzz_random() % size;
+                size_t length = 1 + (cec_rx_fuzz_random() % (size - offset));
+                if((size + length) <= data_size)
+                {
+                    memmove(&p_data[offset + length], &p_data[offset], size - offset);
+                    size += length;
+                }
+                break;
+            }
+            default: /* Truncation */
+                size = cec_rx_fuzz_random() % (size + 1);
+                break;
+        }
+    }
+
+    return size;
+}
+
+int main(int argc, char * argv[])
+{
+    static uint8_t seed[1024];
+    static uint8_t data[4096];
+    uint32_t       mutation_number = CEC_RX_FUZZ_MUTATION_NUMBER;
+    int            first = 1;
+
+    if((argc > 2) && (0 == strcmp(argv[1], "-n")))
+    {
+        mutation_number = (uint32_t)strtoul(argv[2], NULL, 0);
+        first = 3;
+    }
+
+    for(int i = first; i < argc; i++)
+    {
+        FILE * p_file = fopen(argv[i], "rb");
+        size_t seed_size;
+
+        if(NULL == p_file)
+        {
+            fprintf(stderr, "%s: cannot open\n", argv[i]);
+            return 1;
+        }
+        seed_size = fread(&seed[0], 1, sizeof(seed), p_file);
+        fclose(p_file);
+
+        LLVMFuzzerTestOneInput(&seed[0], seed_size);
+        for(uint32_t j = 0; j < mutation_number; j++)
+        {
+            size_t size = cec_rx_fuzz_mutate(&seed[0], seed_size, &data[0], sizeof(data));
+            LLVMFuzzerTestOneInput(&data[0], size);
+        }
+
+        printf("%s: %d bytes, %d mutations passed (%d ms of device time)\n", argv[i], (int)seed_size, mutation_number,
+               system_tick_get());
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,406 @@
+/***********************************************************************************************************************
+ * File Name    : edid_fuzz.c
+ * Description  : Host fuzz harness and throughput measurement of the EDID parser in hdmi_ddc_utils.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+
+/*
+ * The streaming parser (edid_parser_feed) and the whole-block checks (edid_format_check, edid_cta_format_check,
+ * edid_cta_physical_address_find) are plain C, so they are built for the host together with this file.
+ * Every input is checked for:
+ *   - memory errors and undefined behaviour (build with AddressSanitizer and UndefinedBehaviorSanitizer)
+ *   - the same parser result whether the bytes come at once or in chunks, as DTC delivers them
+ *   - the same physical address from the streaming parser and the whole-block checks
+ * Each input is also tried with its block checksums corrected, so the mutations reach the CTA data blocks.
+ * The data blocks also go through edid_parser_event_handler() of the application (SADs, HF-VSDB).
+ *
+ * Corpus: the spec_*.bin seeds are built by hand from the EDID 1.4, CTA-861-G and HDMI 1.4b / 2.0 layouts to
+ * look like a TV (HDMI VSDB, HF-VSDB with SCDC_Present, HDR and colorimetry blocks), an AVR (8 SADs, 7.1 speakers)
+ * and a monitor (no audio, HF-VSDB without SCDC_Present). They are not captured from real devices. The other
+ * seeds are minimal EDIDs for the error paths. Add dumps of real sinks (DEBUG_EDID_RECEIVED_DATA_OUTPUT) when
+ * available.
+ *
+ * LLVMFuzzerTestOneInput() is the libFuzzer entry point, and -DEDID_FUZZ_LIBFUZZER leaves out main() for it.
+ * That build has only been compiled with GCC and replayed over the corpus, not run under libFuzzer:
+ *   clang -g -O1 -fsanitize=fuzzer,address,undefined -DEDID_FUZZ_LIBFUZZER -Itools/edid_fuzz \
+ *         tools/edid_fuzz/edid_fuzz.c -o edid_fuzz
+ *   ./edid_fuzz -max_len=512 tools/edid_fuzz/corpus
+ *
+ * Standalone (GCC, no libFuzzer): replays the corpus, runs random mutations of it, and measures EDIDs/s.
+ *   gcc -g -O1 -fsanitize=address,undefined -fno-sanitize-recover=all -Itools/edid_fuzz \
+ *       tools/edid_fuzz/edid_fuzz.c -o edid_fuzz
+ *   ./edid_fuzz [-n <mutations per seed>] tools/edid_fuzz/corpus/<file>.bin ...
+ * Build with -O2 and without sanitizers for the throughput figures.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "../../src/hdmi_ddc_utils.c"
+
+#define EDID_FUZZ_EDID_SIZE          (EDID_DATA_SIZE + EDID_CTA_DATA_SIZE)
+#define EDID_FUZZ_MUTATION_NUMBER    (100000) // Default mutations per seed of the standalone run
+#define EDID_FUZZ_BENCHMARK_LOOP     (200000)
+
+/* Replacement of the target environment. The host has no DDC, so every transfer fails. */
+static DWT_Type       edid_fuzz_dwt;
+static CoreDebug_Type edid_fuzz_core_debug;
+static SCB_Type       edid_fuzz_scb;
+DWT_Type       * DWT       = &edid_fuzz_dwt;
+CoreDebug_Type * CoreDebug = &edid_fuzz_core_debug;
+SCB_Type       * SCB       = &edid_fuzz_scb;
+uint32_t         SystemCoreClock = 100000000;
+
+static transfer_info_t  edid_fuzz_transfer_info;
+static transfer_cfg_t   edid_fuzz_transfer_cfg = {&edid_fuzz_transfer_info};
+const transfer_instance_t g_ddc_transfer_rx = {NULL, &edid_fuzz_transfer_cfg, NULL};
+
+sci_i2c_instance_ctrl_t g_ddc_source_i2c_master_ctrl;
+const i2c_master_cfg_t  g_ddc_source_i2c_master_cfg = {-1, -1, -1, NULL, NULL};
+
+fsp_err_t R_SCI_I2C_Open(sci_i2c_instance_ctrl_t * p_ctrl, i2c_master_cfg_t const * p_cfg) { (void)p_ctrl; (void)p_cfg; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Close(sci_i2c_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Read(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_dest, uint32_t bytes, bool restart) { (void)p_ctrl; (void)p_dest; (void)bytes; (void)restart; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Write(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_src, uint32_t bytes, bool restart) { (void)p_ctrl; (void)p_src; (void)bytes; (void)restart; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_Abort(sci_i2c_instance_ctrl_t * p_ctrl) { (void)p_ctrl; return FSP_ERR_UNSUPPORTED; }
+fsp_err_t R_SCI_I2C_SlaveAddressSet(sci_i2c_instance_ctrl_t * p_ctrl, uint32_t slave, i2c_master_addr_mode_t addr_mode) { (void)p_ctrl; (void)slave; (void)addr_mode; return FSP_ERR_UNSUPPORTED; }
+
+int SEGGER_RTT_printf(unsigned BufferIndex, const char * sFormat, ...)
+{
+    (void)BufferIndex;
+    (void)sFormat;
+    return 0;
+}
+
+/* Result of the streaming parser, compared between the ways of feeding */
+typedef struct edid_fuzz_result
+{
+    edid_parser_state_t state;
+    fsp_err_t           error;
+    uint8_t             cta_revision;
+    uint8_t             number_of_extensions;
+    bool                is_physical_address_found;
+    uint8_t             physical_address[4];
+    uint32_t            data_block_count;
+    uint32_t            data_block_sum;
+} edid_fuzz_result_t;
+
+static edid_fuzz_result_t * edid_fuzz_result_current;
+
+/* Reads every byte the parser hands over, so a wrong length is caught by AddressSanitizer */
+static void edid_fuzz_event_handler(edid_parser_callback_args_t * p_args)
+{
+    if(EDID_PARSER_EVENT_CTA_DATA_BLOCK == p_args->event)
+    {
+        edid_fuzz_result_current->data_block_count++;
+        for(uint32_t i=0; i<p_args->length; i++)
+        {
+            edid_fuzz_result_current->data_block_sum += p_args->p_data[i];
+        }
+    }
+    else if(EDID_PARSER_EVENT_PHYSICAL_ADDRESS == p_args->event)
+    {
+        if(4 != p_args->length)
+        {
+            abort();
+        }
+    }
+
+    /* Handler of physical_address_get() copies from the data blocks */
+    edid_parser_event_handler(p_args);
+}
+
+static void edid_fuzz_stream(uint8_t const * p_data, size_t size, uint32_t chunk_seed, edid_fuzz_result_t * p_result)
+{
+    static uint8_t const chunk_list[] = {1, 7, 13, 2, 31, 64, 3, 128};
+    edid_parser_t        parser;
+    size_t               fed = 0;
+
+    memset(p_result, 0, sizeof(edid_fuzz_result_t));
+    edid_fuzz_result_current = p_result;
+    edid_parser_init(&parser, edid_fuzz_event_handler);
+
+    /* chunk_seed 0 feeds everything at once. Others split the data as DTC may deliver it. */
+    for(uint32_t i = chunk_seed; fed < size; i++)
+    {
+        size_t chunk = (0 == chunk_seed) ? size : chunk_list[i % sizeof(chunk_list)];
+        if(chunk > (size - fed))
+        {
+            chunk = size - fed;
+        }
+        edid_parser_feed(&parser, p_data + fed, (uint32_t)chunk);
+        fed += chunk;
+    }
+
+    p_result->state                     = parser.state;
+    p_result->error                     = parser.error;
+    p_result->cta_revision              = parser.cta_revision;
+    p_result->number_of_extensions      = parser.number_of_extensions;
+    p_result->is_physical_address_found = parser.is_physical_address_found;
+    memcpy(&p_result->physical_address[0], &parser.physical_address[0], 4);
+}
+
+/* Physical address as physical_address_get() decides it from the streaming parser */
+static fsp_err_t edid_fuzz_stream_address(edid_fuzz_result_t const * p_result, uint8_t * p_address)
+{
+    if((EDID_PARSER_STATE_ERROR == p_result->state) || (EDID_PARSER_STATE_BASE == p_result->state))
+    {
+        return FSP_ERR_INVALID_DATA;
+    }
+    if(0 == p_result->number_of_extensions)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    if(EDID_PARSER_STATE_DONE != p_result->state)
+    {
+        return FSP_ERR_INVALID_DATA;
+    }
+    if(EDID_CTA_REVISION_3 != p_result->cta_revision)
+    {
+        return FSP_ERR_UNSUPPORTED;
+    }
+    if(!p_result->is_physical_address_found)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+
+    memcpy(p_address, &p_result->physical_address[0], 4);
+    return FSP_SUCCESS;
+}
+
+/* Same decision by the whole-block checks over a complete 256-byte read */
+static fsp_err_t edid_fuzz_block_address(uint8_t const * p_data, uint8_t * p_address)
+{
+    struct
+    {
+        edid_data_t               base;
+        edid_cta_extention_data_t cta;
+    } block;
+
+    memcpy(&block, p_data, sizeof(block));
+
+    if(FSP_SUCCESS != edid_format_check(&block.base))
+    {
+        return FSP_ERR_INVALID_DATA;
+    }
+    if(0 == block.base.number_of_extensions)
+    {
+        return FSP_ERR_NOT_FOUND;
+    }
+    if(FSP_SUCCESS != edid_cta_format_check(&block.cta))
+    {
+        return FSP_ERR_INVALID_DATA;
+    }
+
+    return edid_cta_physical_address_find(&block.cta, p_address);
+}
+
+static void edid_fuzz_check(uint8_t const * p_data, size_t size)
+{
+    edid_fuzz_result_t whole;
+    edid_fuzz_result_t split;
+    uint8_t            stream_address[4] = {0};
+    uint8_t            block_address[4]  = {0};
+    fsp_err_t          stream_err;
+    fsp_err_t          block_err;
+
+    edid_fuzz_stream(p_data, size, 0, &whole);
+    for(uint32_t seed = 1; seed <= 3; seed++)
+    {
+        edid_fuzz_stream(p_data, size, seed, &split);
+        if(0 != memcmp(&whole, &split, sizeof(edid_fuzz_result_t)))
+        {
+            fprintf(stderr, "Result depends on the chunks (seed %u)\n", seed);
+            abort();
+        }
+    }
+
+    /* A complete read is also checked by the whole-block path */
+    if(size >= EDID_FUZZ_EDID_SIZE)
+    {
+        stream_err = edid_fuzz_stream_address(&whole, &stream_address[0]);
+        block_err  = edid_fuzz_block_address(p_data, &block_address[0]);
+        if((stream_err != block_err) || (0 != memcmp(&stream_address[0], &block_address[0], 4)))
+        {
+            fprintf(stderr, "Streaming %d (%x.%x.%x.%x) and whole block %d (%x.%x.%x.%x) differ\n",
+                    stream_err, stream_address[3], stream_address[2], stream_address[1], stream_address[0],
+                    block_err, block_address[3], block_address[2], block_address[1], block_address[0]);
+            abort();
+        }
+    }
+}
+
+/* Correct the checksum of every complete block, so the data behind it is parsed */
+static void edid_fuzz_checksum_fix(uint8_t * p_data, size_t size)
+{
+    for(size_t block = 0; (block + EDID_DATA_SIZE) <= size; block += EDID_DATA_SIZE)
+    {
+        uint8_t sum = 0;
+        for(size_t i = 0; i < (EDID_DATA_SIZE - 1); i++)
+        {
+            sum = (uint8_t)(sum + p_data[block + i]);
+        }
+        p_data[block + EDID_DATA_SIZE - 1] = (uint8_t)(0x100 - sum);
+    }
+}
+
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size);
+int LLVMFuzzerTestOneInput(uint8_t const * p_data, size_t size)
+{
+    uint8_t * p_fixed;
+
+    edid_fuzz_check(p_data, size);
+
+    p_fixed = malloc((size != 0) ? size : 1);
+    if(NULL == p_fixed)
+    {
+        return 0;
+    }
+    memcpy(p_fixed, p_data, size);
+    edid_fuzz_checksum_fix(p_fixed, size);
+    edid_fuzz_check(p_fixed, size);
+    free(p_fixed);
+
+    return 0;
+}
+
+#if !defined(EDID_FUZZ_LIBFUZZER)
+static uint32_t edid_fuzz_random_state = 0x12345678;
+
+static uint32_t edid_fuzz_random(void)
+{
+    /* xorshift32 */
+    edid_fuzz_random_state ^= edid_fuzz_random_state << 13;
+    edid_fuzz_random_state ^= edid_fuzz_random_state >> 17;
+    edid_fuzz_random_state ^= edid_fuzz_random_state << 5;
+    return edid_fuzz_random_state;
+}
+
+static size_t edid_fuzz_mutate(uint8_t const * p_seed, size_t seed_size, uint8_t * p_data)
+{
+    size_t   size = seed_size;
+    uint32_t count = 1 + (edid_fuzz_random() % 8);
+
+    memcpy(p_data, p_seed, seed_size);
+    for(uint32_t i = 0; (i < count) && (size != 0); i++)
+    {
+        switch(edid_fuzz_random() % 4)
+        {
+            case 0: /* Any byte */
+                p_data[edid_fuzz_random() % size] = (uint8_t)edid_fuzz_random();
+                break;
+            case 1: /* Byte of the CTA data block collection, including its header and the DTD offset */
+                if(size > (EDID_DATA_SIZE + 2))
+                {
+                    size_t offset = EDID_DATA_SIZE + 2 + (edid_fuzz_random() % (size - EDID_DATA_SIZE - 2));
+                    p_data[offset] = (uint8_t)edid_fuzz_random();
+                }
+                break;
+            case 2: /* Bit flip */
+                p_data[edid_fuzz_random() % size] ^= (uint8_t)(1U << (edid_fuzz_random() % 8));
+                break;
+            default: /* Truncation, as a read which stopped */
+                size = edid_fuzz_random() % (size + 1);
+                break;
+        }
+    }
+
+    return size;
+}
+
+static double edid_fuzz_seconds(void)
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + ((double)now.tv_nsec / 1e9);
+}
+
+/* Host throughput of both paths over a complete EDID, as DEBUG_EDID_PARSER_BENCHMARK measures on the target */
+static void edid_fuzz_benchmark(char const * p_name, uint8_t const * p_data)
+{
+    static volatile uint32_t sink;
+    edid_parser_t parser;
+    uint8_t       address[4];
+    double        start;
+    double        stream_seconds;
+    double        block_seconds;
+
+    start = edid_fuzz_seconds();
+    for(uint32_t i = 0; i < EDID_FUZZ_BENCHMARK_LOOP; i++)
+    {
+        edid_parser_init(&parser, NULL);
+        edid_parser_feed(&parser, p_data, EDID_FUZZ_EDID_SIZE);
+        sink += parser.physical_address[3];
+    }
+    stream_seconds = edid_fuzz_seconds() - start;
+
+    start = edid_fuzz_seconds();
+    for(uint32_t i = 0; i < EDID_FUZZ_BENCHMARK_LOOP; i++)
+    {
+        sink += (uint32_t)edid_fuzz_block_address(p_data, &address[0]);
+    }
+    block_seconds = edid_fuzz_seconds() - start;
+
+    printf("%s: streaming %.0f EDIDs/s, whole block %.0f EDIDs/s\n", p_name,
+           EDID_FUZZ_BENCHMARK_LOOP / stream_seconds, EDID_FUZZ_BENCHMARK_LOOP / block_seconds);
+}
+
+int main(int argc, char * argv[])
+{
+    static uint8_t seed[4096];
+    static uint8_t data[4096];
+    uint32_t       mutation_number = EDID_FUZZ_MUTATION_NUMBER;
+    int            first = 1;
+
+    if((argc > 2) && (0 == strcmp(argv[1], "-n")))
+    {
+        mutation_number = (uint32_t)strtoul(argv[2], NULL, 0);
+        first = 3;
+    }
+
+    for(int arg = first; arg < argc; arg++)
+    {
+        FILE * p_file = fopen(argv[arg], "rb");
+        size_t seed_size;
+
+        if(NULL == p_file)
+        {
+            fprintf(stderr, "%s cannot be opened\n", argv[arg]);
+            return 1;
+        }
+        seed_size = fread(&seed[0], 1, sizeof(seed), p_file);
+        fclose(p_file);
+
+        LLVMFuzzerTestOneInput(&seed[0], seed_size);
+        for(uint32_t i = 0; i < mutation_number; i++)
+        {
+            size_t size = edid_fuzz_mutate(&seed[0], seed_size, &data[0]);
+            LLVMFuzzerTestOneInput(&data[0], size);
+        }
+        printf("%s: %u bytes, %u mutations passed\n", argv[arg], (unsigned)seed_size, mutation_number);
+
+        if(seed_size >= EDID_FUZZ_EDID_SIZE)
+        {
+            edid_fuzz_benchmark(argv[arg], &seed[0]);
+        }
+    }
+
+    return 0;
+}
+#endif
@@ -0,0 +1,88 @@
+/***********************************************************************************************************************
+ * File Name    : hal_data.h
+ * Description  : Host replacement of the FSP generated hal_data.h, so hdmi_ddc_utils.c builds for edid_fuzz.c.
+ **********************************************************************************************************************/
+/***********************************************************************************************************************
+ * DISCLAIMER
+ * This software is supplied by Renesas Electronics Corporation and is only intended for use with Renesas products. No
+ * other uses are authorized. This software is owned by Renesas Electronics Corporation and is protected under all
+ * applicable laws, including copyright laws.
+ * THIS SOFTWARE IS PROVIDED "AS IS" AND RENESAS MAKES NO WARRANTIES REGARDING
+ * THIS SOFTWARE, WHETHER EXPRESS, IMPLIED OR STATUTORY, INCLUDING BUT NOT LIMITED TO WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NON-INFRINGEMENT. ALL SUCH WARRANTIES ARE EXPRESSLY DISCLAIMED. TO THE MAXIMUM
+ * EXTENT PERMITTED NOT PROHIBITED BY LAW, NEITHER RENESAS ELECTRONICS CORPORATION NOR ANY OF ITS AFFILIATED COMPANIES
+ * SHALL BE LIABLE FOR ANY DIRECT, INDIRECT, SPECIAL, INCIDENTAL OR CONSEQUENTIAL DAMAGES FOR ANY REASON RELATED TO THIS
+ * SOFTWARE, EVEN IF RENESAS OR ITS AFFILIATES HAVE BEEN ADVISED OF THE POSSIBILITY OF SUCH DAMAGES.
+ * Renesas reserves the right, without notice, to make changes to this software and to discontinue the availability of
+ * this software. By using this software, you agree to the additional terms and conditions found by accessing the
+ * following link:
+ * http://www.renesas.com/disclaimer
+ *
+ * Copyright (C) 2024 Renesas Electronics Corporation. All rights reserved.
+ ***********************************************************************************************************************/
+#ifndef HAL_DATA_H_
+#define HAL_DATA_H_
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <string.h>
+
+/* Error codes used by hdmi_ddc_utils.c */
+typedef enum e_fsp_err
+{
+    FSP_SUCCESS               = 0,
+    FSP_ERR_INVALID_SIZE      = 3,
+    FSP_ERR_UNSUPPORTED       = 13,
+    FSP_ERR_ABORTED           = 15,
+    FSP_ERR_IN_USE            = 17,
+    FSP_ERR_ALREADY_OPEN      = 14,
+    FSP_ERR_NOT_FOUND         = 21,
+    FSP_ERR_INVALID_DATA      = 34,
+} fsp_err_t;
+
+/* Core registers. The cycle counter reads 0 on the host. */
+typedef struct { volatile uint32_t CTRL; volatile uint32_t CYCCNT; } DWT_Type;
+typedef struct { volatile uint32_t DEMCR; } CoreDebug_Type;
+typedef struct { volatile uint32_t VTOR; } SCB_Type;
+extern DWT_Type       * DWT;
+extern CoreDebug_Type * CoreDebug;
+extern SCB_Type       * SCB;
+extern uint32_t         SystemCoreClock;
+#define CoreDebug_DEMCR_TRCENA_Msk (1UL << 24)
+#define DWT_CTRL_CYCCNTENA_Msk     (1UL)
+typedef int IRQn_Type;
+
+/* r_dtc */
+typedef struct st_transfer_info { void const * volatile p_src; void * volatile p_dest; volatile uint16_t length; } transfer_info_t;
+typedef struct st_transfer_cfg { transfer_info_t * p_info; } transfer_cfg_t;
+typedef struct st_transfer_instance { void * p_ctrl; transfer_cfg_t const * p_cfg; void const * p_api; } transfer_instance_t;
+extern const transfer_instance_t g_ddc_transfer_rx;
+
+/* r_sci_i2c. The host has no DDC, so every transfer fails. */
+typedef enum e_i2c_master_addr_mode { I2C_MASTER_ADDR_MODE_7BIT = 1 } i2c_master_addr_mode_t;
+typedef enum e_i2c_master_event
+{
+    I2C_MASTER_EVENT_ABORTED     = 1,
+    I2C_MASTER_EVENT_RX_COMPLETE = 2,
+    I2C_MASTER_EVENT_TX_COMPLETE = 3,
+} i2c_master_event_t;
+typedef struct st_i2c_master_callback_args { void const * p_context; i2c_master_event_t event; } i2c_master_callback_args_t;
+typedef struct st_i2c_master_cfg
+{
+    IRQn_Type                   rxi_irq;
+    IRQn_Type                   txi_irq;
+    IRQn_Type                   tei_irq;
+    transfer_instance_t const * p_transfer_tx;
+    transfer_instance_t const * p_transfer_rx;
+} i2c_master_cfg_t;
+typedef struct st_sci_i2c_instance_ctrl { uint32_t open; } sci_i2c_instance_ctrl_t;
+extern sci_i2c_instance_ctrl_t g_ddc_source_i2c_master_ctrl;
+extern const i2c_master_cfg_t  g_ddc_source_i2c_master_cfg;
+fsp_err_t R_SCI_I2C_Open(sci_i2c_instance_ctrl_t * p_ctrl, i2c_master_cfg_t const * p_cfg);
+fsp_err_t R_SCI_I2C_Close(sci_i2c_instance_ctrl_t * p_ctrl);
+fsp_err_t R_SCI_I2C_Read(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_dest, uint32_t bytes, bool restart);
+fsp_err_t R_SCI_I2C_Write(sci_i2c_instance_ctrl_t * p_ctrl, uint8_t * p_src, uint32_t bytes, bool restart);
+fsp_err_t R_SCI_I2C_Abort(sci_i2c_instance_ctrl_t * p_ctrl);
+fsp_err_t R_SCI_I2C_SlaveAddressSet(sci_i2c_instance_ctrl_t * p_ctrl, uint32_t slave, i2c_master_addr_mode_t addr_mode);
+
+#endif /* HAL_DATA_H_ */